@@ -0,0 +1,841 @@
+#include "Benchmark.h"
+#include "ModelLoader.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "ThreadPool.h"
+#include "NumberParser.h"
+#include "Decompressor.h"
+#include "Camera.h"
+#include "RenderBackend.h"
+#include "DepthPrepass.h"
+#include "LevelOfDetail.h"
+#include "VertexQuantization.h"
+#include "MeshBuffers.h"
+#include "MeshOrientation.h"
+#include "VertexAnimation.h"
+#include "Instancing.h"
+#include "StreamBuffer.h"
+#include "Renderer.h"
+#include "GLExtensions.h"
+#include <freeglut.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <charconv>
+#include <functional>
+
+// Seconds elapsed since a steady clock time point
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Prompt user for a file path on the console
+static bool promptFilename(const char* prompt, char* filename, unsigned size) {
+    printf("%s", prompt);                                                                // Show prompt
+    return scanf_s("%255s", filename, size) == 1;                                        // Read path without spaces
+}
+
+// Check whether two containers hold bitwise identical elements
+template <typename T>
+static bool sameContents(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+// Compare legacy and memory-mapped OBJ parser throughput on the same file
+void benchmarkOBJParsers() {
+    char filename[256];                                                                  // Path of the OBJ file to benchmark
+    if (!promptFilename("Enter OBJ file path to benchmark: ", filename, (unsigned)_countof(filename))) {
+        return;                                                                          // No input
+    }
+
+    MappedFile file;                                                                     // Only used to query the file size
+    if (!file.open(filename)) {
+        printf("Error opening file: %s\n", filename);                                    // Print error message
+        return;
+    }
+    double megabytes = file.size() / (1024.0 * 1024.0);                                  // File size in MB for throughput
+    file.close();                                                                        // Parsers open the file themselves
+
+    // Legacy fgets/sscanf_s parser
+    auto start = std::chrono::steady_clock::now();                                       // Start timer
+    if (!loadOBJLegacy(filename)) return;                                                // Parse with legacy parser
+    double legacySeconds = secondsSince(start);                                          // Stop timer
+    std::vector<Vertex> legacyVertices = vertices;                                       // Keep results for comparison
+    std::vector<TextureCoord> legacyTextureCoords = textureCoords;
+    std::vector<Normal> legacyNormals = normals;
+    std::vector<Face> legacyFaces = faces;
+
+    // Memory-mapped in-place parser
+    start = std::chrono::steady_clock::now();                                            // Start timer
+    if (!loadOBJ(filename)) return;                                                      // Parse with mapped parser
+    double mappedSeconds = secondsSince(start);                                          // Stop timer
+
+    bool identical = sameContents(legacyVertices, vertices) && sameContents(legacyTextureCoords, textureCoords) &&
+        sameContents(legacyNormals, normals) && sameContents(legacyFaces, faces);        // Compare parser outputs
+
+    printf("\nOBJ parser benchmark: %s (%.1f MB)\n", filename, megabytes);
+    printf("  Legacy (fgets/sscanf_s): %8.3f s  %8.1f MB/s\n", legacySeconds, megabytes / legacySeconds);
+    printf("  Mapped (in place):       %8.3f s  %8.1f MB/s\n", mappedSeconds, megabytes / mappedSeconds);
+    printf("  Speedup: %.1fx, outputs %s\n\n", legacySeconds / mappedSeconds,
+        identical ? "identical" : "differ (legacy truncates long lines and polygons over 4 corners)");
+}
+
+// Parsed OBJ records of one benchmark run, starting with the dummy entries like the global containers
+struct OBJRunOutput {
+    std::vector<Vertex> vertices = { {0, 0, 0} };
+    std::vector<TextureCoord> textureCoords = { {0, 0} };
+    std::vector<Normal> normals = { {0, 0, 0} };
+    std::vector<Face> faces;
+    std::vector<ObjNamedRecord> records;
+
+    // Name of the first container that differs from other, or null when every element matches
+    const char* firstDifference(const OBJRunOutput& other) const {
+        if (!sameContents(vertices, other.vertices)) return "vertices";
+        if (!sameContents(textureCoords, other.textureCoords)) return "texture coordinates";
+        if (!sameContents(normals, other.normals)) return "normals";
+        if (faces.size() != other.faces.size()) return "faces";
+        for (size_t i = 0; i < faces.size(); i++) {
+            const Face& a = faces[i];
+            const Face& b = other.faces[i];
+            if (a.vertexCount != b.vertexCount) return "faces";
+            for (int k = 0; k < a.vertexCount; k++) {                                    // Unused corners are not compared
+                if (a.vertexIndices[k] != b.vertexIndices[k] || a.textureIndices[k] != b.textureIndices[k] ||
+                    a.normalIndices[k] != b.normalIndices[k]) return "face indices";
+            }
+        }
+        if (records.size() != other.records.size()) return "records";
+        for (size_t i = 0; i < records.size(); i++) {
+            if (records[i].faceIndex != other.records[i].faceIndex || records[i].kind != other.records[i].kind ||
+                records[i].name != other.records[i].name) return "records";
+        }
+        return nullptr;
+    }
+    bool operator==(const OBJRunOutput& other) const {
+        return firstDifference(other) == nullptr;
+    }
+};
+
+// Time chunked OBJ parsing with 1 to N threads and check every run matches the single-threaded output record by record
+void benchmarkOBJThreadScaling() {
+    char filename[256];                                                                  // Path of the OBJ file to benchmark
+    if (!promptFilename("Enter OBJ file path to benchmark: ", filename, (unsigned)_countof(filename))) {
+        return;                                                                          // No input
+    }
+
+    MappedFile file;                                                                     // Mapped once, shared by all runs
+    if (!file.open(filename)) {
+        printf("Error opening file: %s\n", filename);                                    // Print error message
+        return;
+    }
+    double megabytes = file.size() / (1024.0 * 1024.0);                                  // File size in MB for throughput
+
+    // Thread counts 1, 2, 4, ... plus the hardware thread count
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());             // Upper end of the scan
+    std::vector<unsigned> threadCounts;
+    for (unsigned n = 1; n < maxThreads; n *= 2) threadCounts.push_back(n);
+    threadCounts.push_back(maxThreads);
+
+    OBJRunOutput reference;                                                              // Single-threaded output
+    double referenceSeconds = 0.0;                                                       // Single-threaded time
+
+    printf("\nOBJ thread scaling benchmark: %s (%.1f MB)\n", filename, megabytes);
+    printf("  Threads      Time      MB/s  Speedup  Output\n");
+    for (unsigned threads : threadCounts) {
+        ThreadPool pool(threads);                                                        // Pool with exactly this many threads
+        OBJRunOutput run;
+
+        auto start = std::chrono::steady_clock::now();                                   // Start timer
+        parseOBJText(file.data(), file.data() + file.size(), pool, run.vertices, run.textureCoords, run.normals, run.faces, run.records);
+        double seconds = secondsSince(start);                                            // Stop timer
+
+        if (threads == 1) {                                                              // First run is the reference
+            referenceSeconds = seconds;
+            reference = std::move(run);
+            printf("  %7u  %8.3f  %8.1f  %6.2fx  reference\n", threads, seconds, megabytes / seconds, 1.0);
+        }
+        else {
+            const char* difference = reference.firstDifference(run);                     // Every element, not just the counts
+            printf("  %7u  %8.3f  %8.1f  %6.2fx  %s%s\n", threads, seconds, megabytes / seconds,
+                referenceSeconds / seconds, difference ? "MISMATCH in " : "identical", difference ? difference : "");
+        }
+    }
+    printf("\n");
+}
+
+// Compare decompress-then-parse, overlapped decompress and parse, and parsing the uncompressed file
+void benchmarkCompressedOBJ() {
+    char filename[256];                                                                  // Path of the .obj.gz / .obj.zst file
+    if (!promptFilename("Enter compressed OBJ file path (.obj.gz or .obj.zst): ", filename, (unsigned)_countof(filename))) {
+        return;                                                                          // No input
+    }
+    CompressionFormat format = compressionFormatOf(filename);
+    if (format == COMPRESSION_NONE || !isCompressionSupported(format)) {
+        printf("Error: %s is not a supported compressed file\n", filename);
+        return;
+    }
+
+    MappedFile file;                                                                     // Compressed bytes, shared by all runs
+    if (!file.open(filename)) {
+        printf("Error opening file: %s\n", filename);                                    // Print error message
+        return;
+    }
+    ThreadPool& pool = sharedThreadPool();
+
+    // Decompression alone (output discarded) is the lower bound for the overlapped load
+    size_t textSize = 0;                                                                 // Decompressed size
+    auto start = std::chrono::steady_clock::now();
+    bool ok = decompressBuffer(format, file.data(), file.size(), [&](const char*, size_t count) {
+        textSize += count;
+        return true;
+    });
+    double decompressSeconds = secondsSince(start);
+    if (!ok) {
+        printf("Error: compressed data is corrupt or truncated\n");
+        return;
+    }
+    double compressedMegabytes = file.size() / (1024.0 * 1024.0);
+    double megabytes = textSize / (1024.0 * 1024.0);                                     // Throughput is measured on the text
+
+    // Sequential: decompress the whole text into memory, then parse it
+    OBJRunOutput sequential;
+    start = std::chrono::steady_clock::now();
+    {
+        std::vector<char> text;
+        text.reserve(textSize);
+        decompressBuffer(format, file.data(), file.size(), [&](const char* bytes, size_t count) {
+            text.insert(text.end(), bytes, bytes + count);
+            return true;
+        });
+        parseOBJText(text.data(), text.data() + text.size(), pool, sequential.vertices, sequential.textureCoords,
+            sequential.normals, sequential.faces, sequential.records);
+    }
+    double sequentialSeconds = secondsSince(start);
+
+    // Overlapped: blocks are parsed while later blocks are still being decompressed
+    OBJRunOutput overlapped;
+    start = std::chrono::steady_clock::now();
+    parseCompressedOBJText(format, file.data(), file.size(), pool, overlapped.vertices, overlapped.textureCoords,
+        overlapped.normals, overlapped.faces, overlapped.records);
+    double overlappedSeconds = secondsSince(start);
+
+    printf("\nCompressed OBJ benchmark: %s (%.1f MB compressed, %.1f MB text, ratio %.2f)\n",
+        filename, compressedMegabytes, megabytes, megabytes / compressedMegabytes);
+    printf("  Decompress only:          %8.3f s  %8.1f MB/s\n", decompressSeconds, megabytes / decompressSeconds);
+    printf("  Decompress, then parse:   %8.3f s  %8.1f MB/s\n", sequentialSeconds, megabytes / sequentialSeconds);
+    printf("  Overlapped:               %8.3f s  %8.1f MB/s  %s\n", overlappedSeconds, megabytes / overlappedSeconds,
+        overlapped == sequential ? "identical" : "MISMATCH");
+
+    // Uncompressed file next to it, if present
+    std::string rawFilename = stripCompressionSuffix(filename);
+    MappedFile raw;
+    if (raw.open(rawFilename.c_str())) {
+        OBJRunOutput rawOutput;
+        start = std::chrono::steady_clock::now();
+        parseOBJText(raw.data(), raw.data() + raw.size(), pool, rawOutput.vertices, rawOutput.textureCoords,
+            rawOutput.normals, rawOutput.faces, rawOutput.records);
+        double rawSeconds = secondsSince(start);
+        printf("  Raw %-21s %8.3f s  %8.1f MB/s  %s\n", "(mapped):", rawSeconds, megabytes / rawSeconds,
+            rawOutput == sequential ? "identical" : "MISMATCH");
+        printf("  Overlapped load costs %.2fx the raw parse and reads %.1f%% of the bytes\n",
+            overlappedSeconds / rawSeconds, 100.0 * file.size() / raw.size());
+    }
+    else {
+        printf("  (no %s next to it for a raw comparison)\n", rawFilename.c_str());
+    }
+    printf("\n");
+}
+
+// Draw one frame of the current model (no grid or overlay) and wait for the GPU to finish it
+static void renderModelFrame() {
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glLoadIdentity();
+    setupCamera();
+    drawModel();
+    glFinish();                                                                          // Count the GPU work of this frame
+}
+
+// Draw frames of the current model with the current settings and return the average milliseconds per
+// frame. Frames go to the back buffer without a swap, so the display's refresh rate does not cap the result.
+// afterFrame, when given, runs after every timed frame (to read renderStats).
+static double timeModelFrames(int& frameCount, const std::function<void()>& afterFrame = nullptr) {
+    for (int i = 0; i < 3; i++) renderModelFrame();                                      // Warm up (uploads buffers, compiles lists)
+
+    frameCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (frameCount < 500 && (frameCount < 10 || secondsSince(start) < 2.0)) {         // At least 10 frames, about two seconds
+        renderModelFrame();
+        if (afterFrame) afterFrame();
+        frameCount++;
+    }
+    return secondsSince(start) * 1000.0 / frameCount;
+}
+
+// Draw frames of the current model with one backend and return the average milliseconds per frame
+static double timeRenderBackend(RenderBackendType type, int& frameCount) {
+    RenderBackendType savedBackend = currentRenderBackend();
+    setRenderBackend(type, false);
+    double milliseconds = timeModelFrames(frameCount);
+    setRenderBackend(savedBackend, false);
+    return milliseconds;
+}
+
+// Time every supported render backend on the loaded model and select the fastest one
+void benchmarkRenderBackends() {
+    if (meshIndices.empty()) {
+        printf("Load a model first (the render backend benchmark needs the welded mesh)\n");
+        return;
+    }
+    double milliseconds[RENDER_BACKEND_COUNT];                                           // Time per frame of each backend
+    int frames[RENDER_BACKEND_COUNT];
+    int fastest = -1;                                                                    // Backend with the lowest frame time
+    for (int i = 0; i < RENDER_BACKEND_COUNT; i++) {
+        if (!renderBackend((RenderBackendType)i).isSupported()) continue;
+        milliseconds[i] = timeRenderBackend((RenderBackendType)i, frames[i]);
+        if (fastest < 0 || milliseconds[i] < milliseconds[fastest]) fastest = i;
+    }
+
+    printf("\nRender backend benchmark: %u triangles, %zu vertices, %u batches\n", meshLods[0].indexCount / 3,
+        meshVertices.size(), meshLods[0].batchCount);
+    printf("  Driver: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    printf("  Backend                 Frames  ms/frame       FPS  Relative\n");
+    for (int i = 0; i < RENDER_BACKEND_COUNT; i++) {
+        RenderBackend& backend = renderBackend((RenderBackendType)i);
+        if (!backend.isSupported()) {
+            printf("  %-22s  not supported\n", backend.name());
+            continue;
+        }
+        printf("  %-22s  %6d  %8.2f  %8.1f  %7.2fx\n", backend.name(), frames[i], milliseconds[i],
+            1000.0 / milliseconds[i], milliseconds[i] / milliseconds[fastest]);
+    }
+    printf("  Fastest: %s (selected)\n\n", renderBackend((RenderBackendType)fastest).name());
+    setRenderBackend((RenderBackendType)fastest, false);
+}
+
+// Pixels of the viewport the last frame wrote depth to
+static size_t countCoveredPixels() {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    std::vector<float> depth((size_t)viewport[2] * viewport[3]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(viewport[0], viewport[1], viewport[2], viewport[3], GL_DEPTH_COMPONENT, GL_FLOAT, depth.data());
+    return (size_t)std::count_if(depth.begin(), depth.end(), [](float value) { return value < 1.0f; });
+}
+
+// Time the current model with and without the depth pre-pass and compare how many fragments each
+// shades. Overdraw is shaded fragments per covered pixel; with the pre-pass the lit pass should reach
+// 1.0 and the cost moves to the cheaper depth-only pass.
+void benchmarkDepthPrepass() {
+    if (meshIndices.empty()) {
+        printf("Load a model first (the depth pre-pass benchmark needs the welded mesh)\n");
+        return;
+    }
+    bool savedPrepass = depthPrepassEnabled;
+    double milliseconds[2];                                                              // Without, with the pre-pass
+    int frames[2];
+    FragmentCounts counts[2];
+    for (int mode = 0; mode < 2; mode++) {
+        depthPrepassEnabled = mode == 1;
+        milliseconds[mode] = timeModelFrames(frames[mode]);
+        fragmentCountingEnabled = true;                                                  // One extra frame with queries, outside the timing
+        renderModelFrame();
+        fragmentCountingEnabled = false;
+        counts[mode] = fragmentCounts;
+    }
+    size_t coveredPixels = countCoveredPixels();                                         // Same in both modes
+    depthPrepassEnabled = savedPrepass;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    printf("\nDepth pre-pass benchmark: %u triangles, %s backend, %dx%d, %zu covered pixels\n", meshLods[0].indexCount / 3,
+        renderBackend(currentRenderBackend()).name(), viewport[2], viewport[3], coveredPixels);
+    printf("  Driver: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    const char* modeNames[2] = { "Without pre-pass", "With pre-pass" };
+    if (!glHasOcclusionQueries) {
+        printf("  Occlusion queries are not supported, fragment counts are unavailable\n");
+        printf("  Mode              Frames  ms/frame       FPS\n");
+        for (int mode = 0; mode < 2; mode++) {
+            printf("  %-16s  %6d  %8.2f  %8.1f\n", modeNames[mode], frames[mode], milliseconds[mode], 1000.0 / milliseconds[mode]);
+        }
+    }
+    else {
+        printf("  Mode              Frames  ms/frame       FPS  Depth fragments  Shaded fragments  Overdraw\n");
+        for (int mode = 0; mode < 2; mode++) {
+            printf("  %-16s  %6d  %8.2f  %8.1f  %15llu  %16llu  %7.2fx\n", modeNames[mode], frames[mode], milliseconds[mode],
+                1000.0 / milliseconds[mode], (unsigned long long)counts[mode].depthFragments,
+                (unsigned long long)counts[mode].shadedFragments,
+                coveredPixels ? (double)counts[mode].shadedFragments / coveredPixels : 0.0);
+        }
+        if (counts[0].shadedFragments) {
+            printf("  Shaded fragments with the pre-pass: %.0f%% fewer\n",
+                100.0 * (1.0 - (double)counts[1].shadedFragments / counts[0].shadedFragments));
+        }
+    }
+    printf("  Frame time with the pre-pass: %.2fx\n\n", milliseconds[1] / milliseconds[0]);
+}
+
+// Move the camera straight back from the model in doubling steps and time frames with and without
+// level of detail selection at every distance. Throughput is triangles drawn per second, so it shows
+// whether the simplified levels keep the GPU busy or only make frames cheaper.
+void benchmarkLodZoom() {
+    if (meshIndices.empty()) {
+        printf("Load a model first (the LOD benchmark needs the welded mesh)\n");
+        return;
+    }
+    // Bounding sphere of the model in world space, through the same transform drawModel applies
+    float modelView[16];
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    glTranslatef(modelX, modelY, modelZ);
+    glRotatef(modelRotX, 1.0f, 0.0f, 0.0f);
+    glRotatef(modelRotY, 0.0f, 1.0f, 0.0f);
+    glRotatef(modelRotZ, 0.0f, 0.0f, 1.0f);
+    glScalef(modelScale, modelScale, modelScale);
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelView);
+    glPopMatrix();
+    float localCenter[3], center[3], radius = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        localCenter[k] = (modelBounds.min[k] + modelBounds.max[k]) * 0.5f;
+        radius += (modelBounds.max[k] - localCenter[k]) * (modelBounds.max[k] - localCenter[k]);
+    }
+    radius = sqrtf(radius) * modelScale;
+    for (int k = 0; k < 3; k++) {
+        center[k] = modelView[k] * localCenter[0] + modelView[4 + k] * localCenter[1] + modelView[8 + k] * localCenter[2] + modelView[12 + k];
+    }
+    if (radius <= 0.0f) radius = 1.0f;
+
+    const float savedCamera[5] = { cameraX, cameraY, cameraZ, cameraYaw, cameraPitch };
+    bool savedLodSelection = lodSelectionEnabled;
+    const float pixelsPerUnit = windowHeight * 0.5f / tanf(cameraFieldOfView * 0.5f * 3.14159265f / 180.0f);
+    printf("\nLOD zoom benchmark: %u triangles, %zu levels, %s backend\n", meshLods[0].indexCount / 3, meshLods.size(),
+        renderBackend(currentRenderBackend()).name());
+    printf("  Driver: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    printf("  Distance  Size px |  Full detail: triangles  ms/frame  Mtri/s |  With LOD: triangles  ms/frame  Mtri/s  Speedup\n");
+    for (float distance = radius * 1.5f; distance + radius < cameraFarPlane; distance *= 2.0f) {
+        cameraX = center[0];                                                             // Looking down -Z at the center
+        cameraY = center[1];
+        cameraZ = center[2] + distance;
+        cameraYaw = 180.0f;
+        cameraPitch = 0.0f;
+        double milliseconds[2];                                                          // Full detail, with LOD
+        size_t triangles[2];
+        for (int mode = 0; mode < 2; mode++) {
+            lodSelectionEnabled = mode == 1;
+            int frames;
+            milliseconds[mode] = timeModelFrames(frames);
+            triangles[mode] = renderStats.drawnTriangles;
+        }
+        printf("  %8.2f  %7.0f |  %20zu  %8.2f  %6.1f |  %17zu  %8.2f  %6.1f  %6.2fx\n", distance,
+            2.0f * radius * pixelsPerUnit / distance, triangles[0], milliseconds[0], triangles[0] / milliseconds[0] / 1000.0,
+            triangles[1], milliseconds[1], triangles[1] / milliseconds[1] / 1000.0, milliseconds[0] / milliseconds[1]);
+    }
+    printf("\n");
+    cameraX = savedCamera[0];
+    cameraY = savedCamera[1];
+    cameraZ = savedCamera[2];
+    cameraYaw = savedCamera[3];
+    cameraPitch = savedCamera[4];
+    lodSelectionEnabled = savedLodSelection;
+}
+
+// Time the current model through the shader backend with float and with quantized vertices. The
+// buffer sizes come from the uploads, so they are what the GPU actually holds.
+void benchmarkQuantizedVertices() {
+    if (meshIndices.empty()) {
+        printf("Load a model first (the quantized vertex benchmark needs the welded mesh)\n");
+        return;
+    }
+    if (!quantizedVerticesSupported()) {
+        printf("Quantized vertices need half-float vertex attributes and the VAO + shader backend\n");
+        return;
+    }
+    RenderBackendType savedBackend = currentRenderBackend();
+    bool savedQuantized = quantizedVerticesEnabled;
+    setRenderBackend(RENDER_BACKEND_SHADER, false);
+    double milliseconds[2];                                                              // Float, quantized
+    int frames[2];
+    size_t bufferBytes[2];
+    for (int mode = 0; mode < 2; mode++) {
+        quantizedVerticesEnabled = mode == 1;
+        milliseconds[mode] = timeModelFrames(frames[mode]);                              // Warm-up frames upload the format
+        bufferBytes[mode] = meshBufferBytes();
+    }
+    quantizedVerticesEnabled = savedQuantized;
+    setRenderBackend(savedBackend, false);
+
+    printf("\nQuantized vertex benchmark: %u triangles, %zu vertices, VAO + shader backend\n", meshLods[0].indexCount / 3,
+        meshVertices.size());
+    printf("  Driver: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    printf("  Format      Bytes/vertex  GPU buffers (MB)  Frames  ms/frame       FPS\n");
+    const char* formatNames[2] = { "Float", "Quantized" };
+    const size_t vertexSizes[2] = { sizeof(MeshVertex), sizeof(QuantizedVertex) };
+    for (int mode = 0; mode < 2; mode++) {
+        printf("  %-10s  %12zu  %16.2f  %6d  %8.2f  %8.1f\n", formatNames[mode], vertexSizes[mode],
+            bufferBytes[mode] / (1024.0 * 1024.0), frames[mode], milliseconds[mode], 1000.0 / milliseconds[mode]);
+    }
+    printf("  Quantized: %.2f MB less GPU memory, %+.1f%% fps\n\n", ((double)bufferBytes[0] - bufferBytes[1]) / (1024.0 * 1024.0),
+        100.0 * (milliseconds[0] / milliseconds[1] - 1.0));
+}
+
+// Time the current model with and without culling the back faces of closed batches. Shaded fragments are
+// counted with the same queries as the depth pre-pass benchmark; the back faces a culled frame skips would
+// mostly have failed the depth test, so the frame time shows the rasterization saved as well.
+void benchmarkBackfaceCulling() {
+    if (meshIndices.empty()) {
+        printf("Load a model first (the back-face culling benchmark needs the welded mesh)\n");
+        return;
+    }
+    uint32_t closedBatches = 0;
+    for (uint32_t i = 0; i < meshLods[0].batchCount; i++) closedBatches += meshBatches[i].closed;
+    bool savedCulling = backfaceCullingEnabled;
+    double milliseconds[2];                                                              // Without, with culling
+    int frames[2];
+    FragmentCounts counts[2];
+    for (int mode = 0; mode < 2; mode++) {
+        backfaceCullingEnabled = mode == 1;
+        milliseconds[mode] = timeModelFrames(frames[mode]);
+        fragmentCountingEnabled = true;                                                  // One extra frame with queries, outside the timing
+        renderModelFrame();
+        fragmentCountingEnabled = false;
+        counts[mode] = fragmentCounts;
+    }
+    backfaceCullingEnabled = savedCulling;
+
+    printf("\nBack-face culling benchmark: %u triangles, %u of %u batches closed, %s backend\n", meshLods[0].indexCount / 3,
+        closedBatches, meshLods[0].batchCount, renderBackend(currentRenderBackend()).name());
+    printf("  Driver: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    printf("  Mode               Frames  ms/frame       FPS  Shaded fragments\n");
+    const char* modeNames[2] = { "Two-sided", "Back faces culled" };
+    for (int mode = 0; mode < 2; mode++) {
+        printf("  %-17s  %6d  %8.2f  %8.1f  %16s\n", modeNames[mode], frames[mode], milliseconds[mode], 1000.0 / milliseconds[mode],
+            glHasOcclusionQueries ? std::to_string(counts[mode].shadedFragments).c_str() : "n/a");
+    }
+    printf("  Frame time with culling: %.2fx\n\n", milliseconds[1] / milliseconds[0]);
+}
+
+// Compare per-range draws with multi-draw indirect on the current model. Both backends light from the
+// uniform buffers, so only the submission differs: one glDrawElements per visible range against one
+// glMultiDrawElementsIndirect per run of ranges. Submission is the CPU time drawModel spends issuing the
+// draws; the frame time also waits for the GPU. The camera stands still, so after the warm-up frames the
+// indirect commands should never be rebuilt.
+void benchmarkMultiDrawIndirect() {
+    if (meshIndices.empty()) {
+        printf("Load a model first (the multi-draw indirect benchmark needs the welded mesh)\n");
+        return;
+    }
+    if (!renderBackend(RENDER_BACKEND_MULTI_DRAW_INDIRECT).isSupported()) {
+        printf("Multi-draw indirect needs OpenGL 4.3 (or ARB_multi_draw_indirect and ARB_base_instance) and uniform buffers\n");
+        return;
+    }
+    const RenderBackendType modes[2] = { RENDER_BACKEND_UNIFORM_BUFFERS, RENDER_BACKEND_MULTI_DRAW_INDIRECT };
+    RenderBackendType savedBackend = currentRenderBackend();
+    double milliseconds[2], submitMilliseconds[2];
+    int frames[2];
+    size_t drawCalls[2], rebuildFrames[2];
+    for (int mode = 0; mode < 2; mode++) {
+        setRenderBackend(modes[mode], false);
+        double submitTotal = 0.0;
+        size_t rebuilds = 0;
+        milliseconds[mode] = timeModelFrames(frames[mode], [&] {
+            submitTotal += renderStats.submitMilliseconds;
+            if (renderStats.rebuiltDrawCommands) rebuilds++;
+        });
+        submitMilliseconds[mode] = submitTotal / frames[mode];
+        drawCalls[mode] = renderStats.drawCalls;
+        rebuildFrames[mode] = rebuilds;
+    }
+    setRenderBackend(savedBackend, false);
+    if (drawCalls[0] == 0) {
+        printf("Nothing of the model is visible; point the camera at it and run the benchmark again\n");
+        return;
+    }
+
+    printf("\nMulti-draw indirect benchmark: %u triangles, %zu submeshes, %u batches, %zu visible ranges\n",
+        meshLods[0].indexCount / 3, submeshes.size(), meshLods[0].batchCount, drawCalls[0]);
+    printf("  Driver: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    printf("  Submission           Frames  Draw calls  Submit ms  ms/frame       FPS  Frames rebuilding commands\n");
+    const char* modeNames[2] = { "Per-range draws", "Multi-draw indirect" };
+    for (int mode = 0; mode < 2; mode++) {
+        printf("  %-19s  %6d  %10zu  %9.3f  %8.2f  %8.1f  %26s\n", modeNames[mode], frames[mode], drawCalls[mode],
+            submitMilliseconds[mode], milliseconds[mode], 1000.0 / milliseconds[mode],
+            mode == 1 ? std::to_string(rebuildFrames[mode]).c_str() : "-");
+    }
+    printf("  CPU submission: %.1fx faster, frame time %.2fx\n\n", submitMilliseconds[0] / submitMilliseconds[1],
+        milliseconds[1] / milliseconds[0]);
+}
+
+// Stream the animated mesh through both upload paths: a client copy handed to glBufferSubData, and the
+// persistently mapped ring the vertices are deformed into directly. Frames are not finished one by one
+// (a single glFinish ends each run), so the CPU runs ahead of the GPU as an interactive frame loop does:
+// glBufferSubData has to wait for or shadow the buffer the queued frames still read, and the ring has to
+// wait on a fence only when it laps the GPU. Stalls count those fence waits.
+void benchmarkVertexStreaming() {
+    if (meshIndices.empty()) {
+        printf("Load a model first (the vertex streaming benchmark needs the welded mesh)\n");
+        return;
+    }
+    if (!instances.empty()) {
+        printf("Turn instancing off first (instances draw the static mesh buffers)\n");
+        return;
+    }
+    if (!glHasBufferObjects) {
+        printf("Vertex streaming needs buffer objects\n");
+        return;
+    }
+    RenderBackendType savedBackend = currentRenderBackend();
+    bool savedAnimation = vertexAnimationEnabled, savedPersistent = persistentStreamingEnabled;
+    if (savedBackend < RENDER_BACKEND_BUFFERS) setRenderBackend(RENDER_BACKEND_BUFFERS, false);
+    vertexAnimationEnabled = true;
+    const int modeCount = glHasPersistentMapping ? 2 : 1;
+    double milliseconds[2], writeMilliseconds[2], stallMilliseconds[2];
+    int frames[2];
+    size_t stalls[2];
+    for (int mode = 0; mode < modeCount; mode++) {
+        persistentStreamingEnabled = mode == 1;
+        for (int i = 0; i < 3; i++) renderModelFrame();                                  // Warm up (creates the buffer)
+        size_t startStalls = streamStats.stalls;
+        double startStallMilliseconds = streamStats.stallMilliseconds, writeTotal = 0.0;
+        frames[mode] = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (frames[mode] < 500 && (frames[mode] < 10 || secondsSince(start) < 2.0)) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glLoadIdentity();
+            setupCamera();
+            drawModel();
+            writeTotal += streamStats.writeMilliseconds;
+            frames[mode]++;
+        }
+        glFinish();                                                                      // Wait for the queued frames once
+        milliseconds[mode] = secondsSince(start) * 1000.0 / frames[mode];
+        writeMilliseconds[mode] = writeTotal / frames[mode];
+        stalls[mode] = streamStats.stalls - startStalls;
+        stallMilliseconds[mode] = streamStats.stallMilliseconds - startStallMilliseconds;
+    }
+    const double frameMegabytes = meshVertices.size() * sizeof(MeshVertex) / (1024.0 * 1024.0);
+    vertexAnimationEnabled = savedAnimation;
+    persistentStreamingEnabled = savedPersistent;
+    if (!savedAnimation) releaseStreamBuffer();
+    setRenderBackend(savedBackend, false);
+
+    printf("\nVertex streaming benchmark: %zu vertices, %.2f MB per frame, %s backend\n", meshVertices.size(), frameMegabytes,
+        renderBackend(std::max(savedBackend, RENDER_BACKEND_BUFFERS)).name());
+    printf("  Driver: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    printf("  Upload path          Frames  ms/frame       FPS      MB/s  Write ms  Write GB/s  Stalls  Stall ms\n");
+    const char* modeNames[2] = { "glBufferSubData", "Persistent ring" };
+    for (int mode = 0; mode < modeCount; mode++) {
+        char stallColumns[32] = "       -         -";                                    // glBufferSubData leaves the waiting to the driver
+        if (mode == 1) snprintf(stallColumns, sizeof(stallColumns), "  %6zu  %8.2f", stalls[mode], stallMilliseconds[mode]);
+        printf("  %-19s  %6d  %8.2f  %8.1f  %8.0f  %8.3f  %10.2f%s\n", modeNames[mode], frames[mode], milliseconds[mode],
+            1000.0 / milliseconds[mode], frameMegabytes * 1000.0 / milliseconds[mode], writeMilliseconds[mode],
+            frameMegabytes / 1024.0 / (writeMilliseconds[mode] / 1000.0), stallColumns);
+    }
+    if (modeCount == 2) {
+        printf("  Persistent ring: frame time %.2fx, writes %.2fx\n\n", milliseconds[1] / milliseconds[0],
+            writeMilliseconds[1] / writeMilliseconds[0]);
+    }
+    else {
+        printf("  No persistent mapping (OpenGL 4.4 or ARB_buffer_storage) on this driver\n\n");
+    }
+}
+
+// Build a space separated list of float strings that exercises every path of parseFloat
+static std::string makeFloatTestText(std::vector<size_t>& offsets) {
+    std::mt19937 random(12345);                                                          // Fixed seed for reproducible runs
+    std::string text;                                                                    // All test strings
+    char buffer[128];                                                                    // One formatted number
+
+    auto add = [&](const char* number) {                                                 // Append one test string
+        offsets.push_back(text.size());
+        text += number;
+        text += ' ';
+    };
+
+    for (int i = 0; i < 200000; i++) {                                                   // Round-trip strings of random finite floats
+        uint32_t bits = random();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!isfinite(value)) continue;
+        snprintf(buffer, sizeof(buffer), "%.9g", value);
+        add(buffer);
+    }
+    std::uniform_real_distribution<float> coordinates(-1000.0f, 1000.0f);                // Typical OBJ coordinates
+    for (int i = 0; i < 200000; i++) {
+        snprintf(buffer, sizeof(buffer), "%.6f", coordinates(random));
+        add(buffer);
+    }
+    for (int i = 0; i < 200000; i++) {                                                   // Random digit strings with dots and exponents
+        int digits = 1 + (int)(random() % 20);
+        int dot = (int)(random() % (digits + 1));
+        std::string number = (random() & 1) ? "-" : "";
+        for (int d = 0; d < digits; d++) {
+            if (d == dot) number += '.';
+            number += (char)('0' + random() % 10);
+        }
+        if (random() & 1) {
+            snprintf(buffer, sizeof(buffer), "e%d", (int)(random() % 81) - 40);
+            number += buffer;
+        }
+        add(number.c_str());
+    }
+    for (int i = 0; i < 50000; i++) {                                                    // Exact midpoints between adjacent floats
+        float low = coordinates(random);
+        float high = nextafterf(low, FLT_MAX);
+        snprintf(buffer, sizeof(buffer), "%.40g", ((double)low + (double)high) * 0.5);
+        add(buffer);
+    }
+    const char* edgeCases[] = { "0", "-0", "+1", ".5", "5.", "1e", "1e+", "3.4028235e38", "1.17549435e-38",
+        "1e-45", "16777217", "9007199254740993", "0.000000000000000000000000001" };
+    for (const char* edgeCase : edgeCases) add(edgeCase);
+    text += std::string(64, ' ');                                                        // Keep the fast path active to the last string
+    return text;
+}
+
+// Check the number kernel against strtof and time it against strtof and std::from_chars
+void benchmarkNumberParser() {
+    std::vector<size_t> offsets;                                                         // Start of every test string
+    std::string text = makeFloatTestText(offsets);                                       // Exactness test input
+
+    // Exactness: same bits and same number of consumed characters as strtof
+    size_t mismatches = 0;                                                               // Strings that disagree with strtof
+    for (size_t i = 0; i < offsets.size(); i++) {
+        const char* start = text.c_str() + offsets[i];                                   // Test string (followed by a space)
+        char* strtofEnd;
+        float expected = strtof(start, &strtofEnd);                                      // Reference conversion
+        float actual = 0.0f;
+        const char* kernelEnd = parseFloat(start, text.c_str() + text.size(), actual);   // Kernel conversion
+        bool inRange = fabsf(expected) >= FLT_MIN && fabsf(expected) <= FLT_MAX;         // Kernel clamps out-of-range values to 0
+        if (inRange && (memcmp(&expected, &actual, sizeof(float)) != 0 || kernelEnd != strtofEnd)) {
+            if (mismatches < 5) {
+                printf("  Mismatch: \"%.*s\" strtof=%.9g kernel=%.9g\n",
+                    (int)(strchr(start, ' ') - start), start, expected, actual);
+            }
+            mismatches++;
+        }
+    }
+    printf("\nNumber parser exactness: %zu strings, %zu mismatches against strtof\n", offsets.size(), mismatches);
+
+    // Throughput on typical OBJ coordinates
+    std::mt19937 random(678);
+    std::uniform_real_distribution<float> coordinates(-1000.0f, 1000.0f);
+    std::string coordinateText;                                                          // One million "%.6f" values
+    char buffer[64];
+    for (int i = 0; i < 1000000; i++) {
+        snprintf(buffer, sizeof(buffer), "%.6f ", coordinates(random));
+        coordinateText += buffer;
+    }
+    const char* begin = coordinateText.c_str();
+    const char* end = begin + coordinateText.size();
+    double megabytes = coordinateText.size() / (1024.0 * 1024.0);
+
+    float sum = 0.0f;                                                                    // Keeps the loops from being optimized out
+    auto start = std::chrono::steady_clock::now();
+    for (const char* p = begin; p < end; p++) {                                          // Kernel
+        float value;
+        p = parseFloat(p, end, value);
+        sum += value;
+    }
+    double kernelSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (const char* p = begin; p < end; p++) {                                          // std::from_chars
+        float value;
+        p = std::from_chars(p, end, value).ptr;
+        sum += value;
+    }
+    double fromCharsSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (char* p = (char*)begin; p < end; p++) {                                         // strtof
+        sum += strtof(p, &p);
+    }
+    double strtofSeconds = secondsSince(start);
+
+    // Throughput on face corners
+    std::uniform_int_distribution<int> indices(1, 5000000);
+    std::string cornerText;                                                              // One million "v/vt/vn" corners
+    for (int i = 0; i < 1000000; i++) {
+        snprintf(buffer, sizeof(buffer), "%d/%d/%d ", indices(random), indices(random), indices(random));
+        cornerText += buffer;
+    }
+    int indexSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (const char* p = cornerText.c_str(); p < cornerText.c_str() + cornerText.size(); p++) {
+        int values[3];
+        p = parseIndexGroup(p, cornerText.c_str() + cornerText.size(), values);
+        indexSum += values[0] + values[1] + values[2];
+    }
+    double groupSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    for (const char* p = cornerText.c_str(); *p; p = strchr(p, ' ') + 1) {               // Legacy style: copy token, then sscanf_s
+        char token[40];                                                                  // sscanf_s measures its whole input string
+        size_t length = strchr(p, ' ') - p;
+        memcpy(token, p, length);
+        token[length] = '\0';
+        int values[3];
+        sscanf_s(token, "%d/%d/%d", &values[0], &values[1], &values[2]);
+        indexSum += values[0] + values[1] + values[2];
+    }
+    double sscanfSeconds = secondsSince(start);
+
+    // The same kernels inside the OBJ tokenizer, on unpadded text: short lines only reach the block loads
+    // when the tokenizer hands them more than the line to read from
+    std::string objText;                                                                 // 500k vertex, normal and face lines
+    std::vector<float> expected;                                                         // strtof of every v and vn component
+    for (int i = 0; i < 250000; i++) {
+        float components[6] = { coordinates(random), coordinates(random), coordinates(random),
+            coordinates(random) / 1000.0f, coordinates(random) / 1000.0f, coordinates(random) / 1000.0f };
+        snprintf(buffer, sizeof(buffer), "v %.6f %.6f %.6f\n", components[0], components[1], components[2]);
+        objText += buffer;
+        snprintf(buffer, sizeof(buffer), "vn %.4f %.4f %.4f\n", components[3], components[4], components[5]);
+        objText += buffer;
+    }
+    for (int i = 0; i < 250000; i++) {
+        int corner[3] = { 1 + i % 250000, 1 + (i + 1) % 250000, 1 + (i + 2) % 250000 };
+        snprintf(buffer, sizeof(buffer), "f %d//%d %d//%d %d//%d\n", corner[0], corner[0], corner[1], corner[1], corner[2], corner[2]);
+        objText += buffer;
+    }
+    for (const char* p = objText.c_str(); *p; p = strchr(p, '\n') + 1) {                 // Reference values of the v and vn lines
+        if (p[0] != 'v') continue;
+        char* field = (char*)p + (p[1] == 'n' ? 2 : 1);
+        for (int k = 0; k < 3; k++) expected.push_back(strtof(field, &field));
+    }
+    double tokenizerSeconds = DBL_MAX;
+    size_t tokenizerMismatches = 0;
+    for (int run = 0; run < 3; run++) {                                                  // Best of three, arena allocation included
+        ObjChunk chunk;
+        start = std::chrono::steady_clock::now();
+        parseOBJChunk(objText.c_str(), objText.c_str() + objText.size(), chunk);
+        tokenizerSeconds = std::min(tokenizerSeconds, secondsSince(start));
+        if (run > 0) continue;
+        std::vector<float> parsed[2];                                                    // Vertex and normal components
+        chunk.vertices.forEach([&](const Vertex& vertex) { parsed[0].insert(parsed[0].end(), { vertex.x, vertex.y, vertex.z }); });
+        chunk.normals.forEach([&](const Normal& normal) { parsed[1].insert(parsed[1].end(), { normal.x, normal.y, normal.z }); });
+        bool complete = parsed[0].size() * 2 == expected.size() && parsed[1].size() * 2 == expected.size() && chunk.faces.size() == 250000;
+        tokenizerMismatches = complete ? 0 : 1;
+        for (size_t i = 0; complete && i < expected.size(); i++) {                       // expected alternates v and vn lines
+            size_t line = i / 6, component = i % 6;
+            float actual = parsed[component / 3][line * 3 + component % 3];
+            if (memcmp(&actual, &expected[i], sizeof(float)) != 0) tokenizerMismatches++;
+        }
+    }
+    double objMegabytes = objText.size() / (1024.0 * 1024.0);
+
+    printf("Float parsing (1M values, %.1f MB):\n", megabytes);
+    printf("  Kernel:          %7.3f s  %8.1f MB/s\n", kernelSeconds, megabytes / kernelSeconds);
+    printf("  std::from_chars: %7.3f s  %8.1f MB/s\n", fromCharsSeconds, megabytes / fromCharsSeconds);
+    printf("  strtof:          %7.3f s  %8.1f MB/s\n", strtofSeconds, megabytes / strtofSeconds);
+    printf("Face corner parsing (1M v/vt/vn groups):\n");
+    printf("  Kernel:          %7.3f s\n", groupSeconds);
+    printf("  sscanf_s:        %7.3f s\n", sscanfSeconds);
+    printf("OBJ tokenizer (parseOBJChunk, 750k lines, %.1f MB):\n", objMegabytes);
+    printf("  Kernel:          %7.3f s  %8.1f MB/s  %zu mismatches against strtof\n", tokenizerSeconds,
+        objMegabytes / tokenizerSeconds, tokenizerMismatches);
+    printf("  (checksums %g %d)\n\n", sum, indexSum);
+}
\ No newline at end of file
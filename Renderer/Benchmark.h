@@ -0,0 +1,14 @@
+#pragma once
+
+// Benchmarks comparing loader code paths on a user-supplied model file
+void benchmarkOBJParsers();                                                              // Compare legacy and memory-mapped OBJ parser throughput
+void benchmarkOBJThreadScaling();                                                        // Time chunked OBJ parsing with 1 to N threads
+void benchmarkCompressedOBJ();                                                           // Time overlapped decompression and parsing against raw OBJ
+void benchmarkRenderBackends();                                                          // Time every render backend and select the fastest
+void benchmarkNumberParser();                                                            // Check number kernel against strtof and time it
+void benchmarkDepthPrepass();                                                            // Compare frame time and overdraw with and without a depth pre-pass
+void benchmarkLodZoom();                                                                 // Time triangle throughput with and without LOD as the camera zooms out
+void benchmarkQuantizedVertices();                                                       // Compare memory and frame time of float and quantized vertices
+void benchmarkBackfaceCulling();                                                         // Compare frame time and shaded fragments with and without back-face culling
+void benchmarkMultiDrawIndirect();                                                       // Compare CPU submission time of per-range draws and multi-draw indirect
+void benchmarkVertexStreaming();                                                         // Compare upload bandwidth and stalls of glBufferSubData and the mapped stream buffer
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "CachedLines.h"
+#include "GLExtensions.h"
+#include <stddef.h>
+
+// Upload the vertices, replacing any previous geometry
+void CachedLines::build(const std::vector<LineVertex>& vertices) {
+    release();
+    vertexCount = (int)vertices.size();
+    if (glHasBufferObjects) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, (ptrdiff_t)(vertices.size() * sizeof(LineVertex)), vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else {
+        list = glGenLists(1);
+        glNewList(list, GL_COMPILE);
+        glBegin(GL_LINES);
+        for (const LineVertex& vertex : vertices) {
+            glColor3fv(vertex.color);
+            glVertex3fv(vertex.position);
+        }
+        glEnd();
+        glEndList();
+    }
+    built = true;
+}
+
+// Draw the cached lines; the current color is undefined afterwards
+void CachedLines::draw() const {
+    if (list) {
+        glCallList(list);
+        return;
+    }
+    if (!buffer) return;
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(LineVertex), (const void*)offsetof(LineVertex, position));
+    glColorPointer(3, GL_FLOAT, sizeof(LineVertex), (const void*)offsetof(LineVertex, color));
+    glDrawArrays(GL_LINES, 0, vertexCount);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Free the buffer or list
+void CachedLines::release() {
+    if (buffer) glDeleteBuffers(1, &buffer);
+    if (list) glDeleteLists(list, 1);
+    buffer = list = 0;
+    vertexCount = 0;
+    built = false;
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+
+// Colored line vertex of a cached overlay layer
+struct LineVertex {
+    float position[3];                                                                   // Vertex position
+    float color[3];                                                                      // RGB color
+};
+
+// Static GL_LINES geometry built once and replayed every frame: a vertex buffer object when the
+// driver has buffer objects, otherwise a display list
+class CachedLines {
+public:
+    bool isBuilt() const { return built; }                                               // Geometry was uploaded
+    void build(const std::vector<LineVertex>& vertices);                                 // Upload (replaces the previous geometry)
+    void draw() const;                                                                   // Draw the lines with their vertex colors
+    void release();                                                                      // Free the buffer or list
+
+private:
+    unsigned buffer = 0;                                                                 // Vertex buffer object (0 when a list is used)
+    unsigned list = 0;                                                                   // Display list fallback
+    int vertexCount = 0;                                                                 // Number of vertices (two per line)
+    bool built = false;                                                                  // build was called since the last release
+};
\ No newline at end of file
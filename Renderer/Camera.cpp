@@ -11,6 +11,8 @@ float cameraX = 0.0f, cameraY = 0.0f, cameraZ = 5.0f;
 float cameraYaw = 0.0f, cameraPitch = 0.0f;                                              // Camera orientation angles
 float cameraSpeed = 0.1f;                                                                // Camera movement speed
 float mouseSensitivity = 0.2f;                                                           // Mouse sensitivity for camera control
+const float cameraFieldOfView = 45.0f;                                                   // Vertical field of view in degrees
+const float cameraNearPlane = 0.1f, cameraFarPlane = 100.0f;                             // Clipping plane distances
 
 // Reset camera to default position and orientation
 void resetCamera() {
@@ -7,6 +7,8 @@ extern float cameraX, cameraY, cameraZ;
 extern float cameraYaw, cameraPitch;                                                     // Camera orientation angles
 extern float cameraSpeed;                                                                // Camera movement speed
 extern float mouseSensitivity;                                                           // Mouse sensitivity for camera control
+extern const float cameraFieldOfView;                                                    // Vertical field of view in degrees
+extern const float cameraNearPlane, cameraFarPlane;                                      // Clipping plane distances
 
 // Function declarations
 void resetCamera();                                                                      // Reset camera to default position and orientation
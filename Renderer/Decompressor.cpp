@@ -0,0 +1,433 @@
+#include "Decompressor.h"
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#if RENDERER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// Format from the file name suffix
+CompressionFormat compressionFormatOf(const char* filename) {
+    const char* extension = strrchr(filename, '.');                                      // Last suffix
+    if (!extension) return COMPRESSION_NONE;
+    if (_stricmp(extension, ".gz") == 0) return COMPRESSION_GZIP;
+    if (_stricmp(extension, ".zst") == 0) return COMPRESSION_ZSTD;
+    return COMPRESSION_NONE;
+}
+
+// File name without the compression suffix
+std::string stripCompressionSuffix(const char* filename) {
+    if (compressionFormatOf(filename) == COMPRESSION_NONE) return filename;
+    return std::string(filename, strrchr(filename, '.'));
+}
+
+// False for formats this build cannot decode
+bool isCompressionSupported(CompressionFormat format) {
+#if RENDERER_HAVE_ZSTD
+    return true;
+#else
+    return format != COMPRESSION_ZSTD;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------
+// Inflate (RFC 1951) with table-driven Huffman decoding
+
+// LSB-first bit reader over the whole compressed buffer
+struct InflateBits {
+    const uint8_t* p;                                                                    // Next byte to load
+    const uint8_t* end;                                                                  // End of input
+    uint64_t bits;                                                                       // Loaded bits, next bit in bit 0
+    int count;                                                                           // Number of valid bits
+    bool overrun;                                                                        // Tried to read past the input
+
+    // Load whole bytes until at least 56 bits are valid (or the input ends)
+    inline void refill() {
+        if (end - p >= 8) {                                                              // Branch-free refill of 8 bytes
+            uint64_t word;
+            memcpy(&word, p, 8);
+            bits |= word << count;                                                       // Bits above count are rewritten identically later
+            p += (63 - count) >> 3;
+            count |= 56;
+            return;
+        }
+        while (count <= 56 && p < end) {
+            bits |= (uint64_t)*p++ << count;
+            count += 8;
+        }
+    }
+
+    // Read n bits (n <= 32)
+    inline uint32_t take(int n) {
+        if (count < n) {
+            refill();
+            if (count < n) {                                                             // Input ended inside the stream
+                overrun = true;
+                return 0;
+            }
+        }
+        uint32_t value = (uint32_t)(bits & ((1ull << n) - 1));
+        bits >>= n;
+        count -= n;
+        return value;
+    }
+
+    // Drop bits up to the next byte boundary and give whole buffered bytes back to the input
+    inline void alignToByte() {
+        int drop = count & 7;
+        bits >>= drop;
+        count -= drop;
+        p -= count >> 3;                                                                 // Buffered bytes were loaded from p
+        bits = 0;
+        count = 0;
+    }
+};
+
+static const int huffmanFastBits = 10;                                                   // Codes up to this length decode with one lookup
+
+// Canonical Huffman code with a direct lookup table for short codes
+struct InflateHuffman {
+    uint16_t fast[1 << huffmanFastBits];                                                 // symbol | length << 9 (0 = longer code)
+    uint16_t counts[16];                                                                 // Number of codes of each length
+    uint16_t symbols[288];                                                               // Symbols ordered by code
+};
+
+// Build a decoder from code lengths; incomplete codes are allowed, over-subscribed ones are not
+static bool buildHuffman(InflateHuffman& huffman, const uint8_t* lengths, int symbolCount) {
+    memset(huffman.counts, 0, sizeof(huffman.counts));
+    for (int i = 0; i < symbolCount; i++) huffman.counts[lengths[i]]++;
+    huffman.counts[0] = 0;
+
+    int left = 1;                                                                        // Codes still available
+    for (int length = 1; length < 16; length++) {
+        left = (left << 1) - huffman.counts[length];
+        if (left < 0) return false;                                                      // Over-subscribed
+    }
+
+    uint16_t offsets[16];                                                                // First slot of each length in symbols
+    offsets[1] = 0;
+    for (int length = 1; length < 15; length++) offsets[length + 1] = offsets[length] + huffman.counts[length];
+    for (int i = 0; i < symbolCount; i++) {
+        if (lengths[i]) huffman.symbols[offsets[lengths[i]]++] = (uint16_t)i;
+    }
+
+    // Fill the lookup table: codes are stored MSB-first but read LSB-first, so index by reversed code
+    memset(huffman.fast, 0, sizeof(huffman.fast));
+    int code = 0, index = 0;                                                             // Canonical code and symbol position
+    for (int length = 1; length <= huffmanFastBits; length++) {
+        for (int i = 0; i < huffman.counts[length]; i++, code++, index++) {
+            int reversed = 0;
+            for (int bit = 0; bit < length; bit++) reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+            for (int slot = reversed; slot < (1 << huffmanFastBits); slot += 1 << length) {
+                huffman.fast[slot] = (uint16_t)(huffman.symbols[index] | (length << 9));
+            }
+        }
+        code <<= 1;
+    }
+    return true;
+}
+
+// Decode one symbol; returns -1 for an invalid code
+static inline int decodeSymbol(InflateBits& in, const InflateHuffman& huffman) {
+    if (in.count < 15) in.refill();
+    uint16_t entry = huffman.fast[in.bits & ((1 << huffmanFastBits) - 1)];
+    if (entry) {                                                                         // Short code
+        int length = entry >> 9;
+        if (length > in.count) {
+            in.overrun = true;
+            return -1;
+        }
+        in.bits >>= length;
+        in.count -= length;
+        return entry & 0x1FF;
+    }
+
+    // Long code: walk the canonical code one bit at a time
+    int code = 0, first = 0, index = 0;
+    for (int length = 1; length < 16; length++) {
+        code |= (int)in.take(1);
+        int count = huffman.counts[length];
+        if (code - first < count) return huffman.symbols[index + (code - first)];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+        if (in.overrun) break;
+    }
+    return -1;                                                                           // Ran out of codes
+}
+
+// Length and distance base values and extra bits (RFC 1951 section 3.2.5)
+static const uint16_t lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// Output window: the last 32 KB are kept for back-references, everything older goes to the sink
+class InflateOutput {
+public:
+    InflateOutput(const std::function<bool(const char*, size_t)>& sink)
+        : buffer(bufferSize), position(0), flushed(0), total(0), sink(sink), stopped(false) {}
+
+    // Make room for one more match; returns false when the sink asked to stop
+    inline bool reserve() {
+        if (position + 258 <= bufferSize) return true;
+        if (!flush()) return false;
+        memmove(buffer.data(), buffer.data() + position - historySize, historySize);     // Keep the window
+        position = flushed = historySize;
+        return true;
+    }
+    inline void put(uint8_t byte) { buffer[position++] = (char)byte; }
+    inline bool copyMatch(size_t distance, size_t length) {
+        if (distance > position) return false;                                           // Before the start of the output
+        char* out = buffer.data() + position;
+        const char* from = out - distance;
+        if (distance >= length) memcpy(out, from, length);
+        else for (size_t i = 0; i < length; i++) out[i] = from[i];                       // Overlapping copy repeats the pattern
+        position += length;
+        return true;
+    }
+    inline bool copyStored(const uint8_t* data, size_t length) {
+        while (length) {
+            if (!reserve()) return false;
+            size_t piece = std::min(length, bufferSize - position);                      // Up to the end of the buffer
+            memcpy(buffer.data() + position, data, piece);
+            position += piece;
+            data += piece;
+            length -= piece;
+        }
+        return true;
+    }
+    bool flush() {
+        if (position > flushed) {
+            total += position - flushed;
+            if (!sink(buffer.data() + flushed, position - flushed)) stopped = true;      // Sink cancelled
+            flushed = position;
+        }
+        return !stopped;
+    }
+    size_t bytesWritten() const { return total + (position - flushed); }                 // Total output so far
+    const char* unflushedData() const { return buffer.data() + flushed; }                // Output not yet passed on
+    bool wasStopped() const { return stopped; }
+
+private:
+    static const size_t historySize = 32768;                                             // Deflate window
+    static const size_t bufferSize = (4 << 20) + historySize;                            // Window plus one flush worth of output
+    std::vector<char> buffer;                                                            // History followed by new output
+    size_t position;                                                                     // Next write position
+    size_t flushed;                                                                      // Output before this has been sunk
+    size_t total;                                                                        // Bytes handed to the sink
+    const std::function<bool(const char*, size_t)>& sink;                                // Consumer of the output
+    bool stopped;                                                                        // Sink asked to stop
+};
+
+// Decode a Huffman-coded block with the given literal/length and distance codes
+static bool inflateCodes(InflateBits& in, InflateOutput& out, const InflateHuffman& literals, const InflateHuffman& distances) {
+    for (;;) {
+        if (!out.reserve()) return false;
+        int symbol = decodeSymbol(in, literals);
+        if (symbol < 0) return false;                                                    // Invalid code
+        if (symbol < 256) {                                                              // Literal byte
+            out.put((uint8_t)symbol);
+            continue;
+        }
+        if (symbol == 256) return true;                                                  // End of block
+        symbol -= 257;
+        if (symbol >= 29) return false;                                                  // Invalid length code
+        size_t length = lengthBase[symbol] + in.take(lengthExtra[symbol]);
+        int distanceSymbol = decodeSymbol(in, distances);
+        if (distanceSymbol < 0 || distanceSymbol >= 30) return false;                    // Invalid distance code
+        size_t distance = distanceBase[distanceSymbol] + in.take(distanceExtra[distanceSymbol]);
+        if (in.overrun || !out.copyMatch(distance, length)) return false;
+    }
+}
+
+// Read the code lengths of a dynamic block and build its two decoders
+static bool readDynamicTables(InflateBits& in, InflateHuffman& literals, InflateHuffman& distances) {
+    static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    int literalCount = (int)in.take(5) + 257;
+    int distanceCount = (int)in.take(5) + 1;
+    int codeLengthCount = (int)in.take(4) + 4;
+    if (literalCount > 286 || distanceCount > 30) return false;
+
+    uint8_t lengths[286 + 30] = {};                                                      // Literal/length then distance lengths
+    for (int i = 0; i < codeLengthCount; i++) lengths[order[i]] = (uint8_t)in.take(3);
+    InflateHuffman codeLengths;                                                          // Code for the code lengths
+    if (!buildHuffman(codeLengths, lengths, 19)) return false;
+
+    memset(lengths, 0, sizeof(lengths));
+    for (int i = 0; i < literalCount + distanceCount;) {
+        int symbol = decodeSymbol(in, codeLengths);
+        if (symbol < 0) return false;
+        if (symbol < 16) {                                                               // Literal length
+            lengths[i++] = (uint8_t)symbol;
+            continue;
+        }
+        int repeat;                                                                      // Repeat count
+        uint8_t value = 0;                                                               // Repeated length
+        if (symbol == 16) {                                                              // Repeat previous length 3-6 times
+            if (i == 0) return false;
+            value = lengths[i - 1];
+            repeat = 3 + (int)in.take(2);
+        }
+        else if (symbol == 17) repeat = 3 + (int)in.take(3);                             // 3-10 zeros
+        else repeat = 11 + (int)in.take(7);                                              // 11-138 zeros
+        if (i + repeat > literalCount + distanceCount) return false;
+        while (repeat--) lengths[i++] = value;
+    }
+    if (lengths[256] == 0) return false;                                                 // No end-of-block code
+    return !in.overrun && buildHuffman(literals, lengths, literalCount) &&
+        buildHuffman(distances, lengths + literalCount, distanceCount);
+}
+
+// Inflate one raw deflate stream starting at in; in is left after the final block
+static bool inflateStream(InflateBits& in, InflateOutput& out) {
+    static InflateHuffman fixedLiterals, fixedDistances;                                 // Fixed codes of block type 1
+    static bool fixedReady = [] {
+        uint8_t lengths[288];
+        for (int i = 0; i < 144; i++) lengths[i] = 8;
+        for (int i = 144; i < 256; i++) lengths[i] = 9;
+        for (int i = 256; i < 280; i++) lengths[i] = 7;
+        for (int i = 280; i < 288; i++) lengths[i] = 8;
+        buildHuffman(fixedLiterals, lengths, 288);
+        for (int i = 0; i < 30; i++) lengths[i] = 5;
+        buildHuffman(fixedDistances, lengths, 30);
+        return true;
+    }();
+    (void)fixedReady;
+
+    bool final = false;
+    while (!final) {
+        final = in.take(1) != 0;
+        uint32_t type = in.take(2);
+        if (in.overrun) return false;
+        if (type == 0) {                                                                 // Stored block
+            in.alignToByte();
+            if (in.end - in.p < 4) return false;
+            uint16_t length = (uint16_t)(in.p[0] | (in.p[1] << 8));
+            uint16_t inverse = (uint16_t)(in.p[2] | (in.p[3] << 8));
+            if ((uint16_t)~length != inverse || in.end - in.p - 4 < length) return false;
+            if (!out.copyStored(in.p + 4, length)) return false;
+            in.p += 4 + length;
+        }
+        else if (type == 1) {                                                            // Fixed Huffman codes
+            if (!inflateCodes(in, out, fixedLiterals, fixedDistances)) return false;
+        }
+        else if (type == 2) {                                                            // Dynamic Huffman codes
+            InflateHuffman literals, distances;
+            if (!readDynamicTables(in, literals, distances)) return false;
+            if (!inflateCodes(in, out, literals, distances)) return false;
+        }
+        else {
+            return false;                                                                // Reserved block type
+        }
+    }
+    return !in.overrun;
+}
+
+// CRC-32 (IEEE) of the gzip trailer
+static uint32_t updateCrc32(uint32_t crc, const char* data, size_t size) {
+    static uint32_t table[256];
+    static bool tableReady = [] {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) value = (value >> 1) ^ (0xEDB88320u & (0u - (value & 1)));
+            table[i] = value;
+        }
+        return true;
+    }();
+    (void)tableReady;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ (uint8_t)data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Decode every gzip member in the buffer, checking each member's CRC and size
+static bool decompressGzip(const char* data, size_t size, const std::function<bool(const char*, size_t)>& sink) {
+    const uint8_t* p = (const uint8_t*)data;
+    const uint8_t* end = p + size;
+    uint32_t crc = 0;                                                                    // CRC of the current member
+    uint64_t memberSize = 0;                                                             // Output size of the current member
+    std::function<bool(const char*, size_t)> checkedSink = [&](const char* bytes, size_t count) {
+        crc = updateCrc32(crc, bytes, count);
+        memberSize += count;
+        return sink(bytes, count);
+    };
+
+    bool anyMember = false;
+    while (end - p >= 18 && p[0] == 0x1F && p[1] == 0x8B) {                              // Member header
+        if (p[2] != 8) return false;                                                     // Only deflate is defined
+        uint8_t flags = p[3];
+        p += 10;
+        if (flags & 4) {                                                                 // FEXTRA
+            if (end - p < 2) return false;
+            size_t extra = p[0] | (p[1] << 8);
+            if ((size_t)(end - p) < 2 + extra) return false;
+            p += 2 + extra;
+        }
+        for (int field = 8; field <= 16; field <<= 1) {                                  // FNAME, FCOMMENT: zero-terminated
+            if (!(flags & field)) continue;
+            while (p < end && *p) p++;
+            if (p++ >= end) return false;
+        }
+        if (flags & 2) p += 2;                                                           // FHCRC
+        if (p >= end) return false;
+
+        crc = 0;
+        memberSize = 0;
+        InflateBits in = { p, end, 0, 0, false };
+        InflateOutput out(checkedSink);
+        if (!inflateStream(in, out) || !out.flush()) return false;
+        in.alignToByte();
+        if (in.end - in.p < 8) return false;                                             // Missing trailer
+        uint32_t storedCrc = in.p[0] | (in.p[1] << 8) | (in.p[2] << 16) | ((uint32_t)in.p[3] << 24);
+        uint32_t storedSize = in.p[4] | (in.p[5] << 8) | (in.p[6] << 16) | ((uint32_t)in.p[7] << 24);
+        if (storedCrc != crc || storedSize != (uint32_t)memberSize) return false;        // Corrupt member
+        p = in.p + 8;
+        anyMember = true;
+    }
+    return anyMember;                                                                    // Trailing padding after the last member is ignored
+}
+
+#if RENDERER_HAVE_ZSTD
+// Decode all zstd frames in the buffer with the streaming API
+static bool decompressZstd(const char* data, size_t size, const std::function<bool(const char*, size_t)>& sink) {
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    if (!context) return false;
+    std::vector<char> output(ZSTD_DStreamOutSize());                                     // Recommended output block
+    ZSTD_inBuffer input = { data, size, 0 };
+    bool ok = true, outputFull = false;
+    size_t frameRemaining = 0;                                                           // Non-zero while a frame is unfinished
+    while (ok && (input.pos < input.size || outputFull)) {
+        ZSTD_outBuffer block = { output.data(), output.size(), 0 };
+        frameRemaining = ZSTD_decompressStream(context, &block, &input);
+        if (ZSTD_isError(frameRemaining)) ok = false;
+        else if (block.pos && !sink(output.data(), block.pos)) ok = false;               // Sink cancelled
+        outputFull = block.pos == block.size;                                            // More output may be buffered
+    }
+    ZSTD_freeDCtx(context);
+    return ok && frameRemaining == 0;                                                    // Last frame must be complete
+}
+#endif
+
+// Decompress a whole buffer and hand the output to sink in order
+bool decompressBuffer(CompressionFormat format, const char* data, size_t size,
+    const std::function<bool(const char*, size_t)>& sink) {
+    switch (format) {
+    case COMPRESSION_NONE:
+        return sink(data, size);
+    case COMPRESSION_GZIP:
+        return decompressGzip(data, size, sink);
+    case COMPRESSION_ZSTD:
+#if RENDERER_HAVE_ZSTD
+        return decompressZstd(data, size, sink);
+#else
+        return false;                                                                    // Built without zstd
+#endif
+    }
+    return false;
+}
\ No newline at end of file
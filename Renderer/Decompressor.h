@@ -0,0 +1,22 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+#include <functional>
+
+// Compressed model inputs. gzip is decoded by the built-in inflater; zstd needs the zstd library
+// and is compiled in when RENDERER_HAVE_ZSTD is defined. The project defines it, and links
+// libzstd_static.lib, only when zstd is present under Libs\zstd; without it .zst files are refused.
+enum CompressionFormat {
+    COMPRESSION_NONE,                                                                    // Plain file
+    COMPRESSION_GZIP,                                                                    // ".gz" (RFC 1952, one or more members)
+    COMPRESSION_ZSTD,                                                                    // ".zst" (Zstandard frames)
+};
+
+CompressionFormat compressionFormatOf(const char* filename);                             // Format from the file name suffix
+std::string stripCompressionSuffix(const char* filename);                                // "model.obj.gz" -> "model.obj"
+bool isCompressionSupported(CompressionFormat format);                                   // False for zstd without the library
+
+// Decompress a whole compressed buffer and hand the output to sink in order, in pieces of any size.
+// Returns false on corrupt or truncated input, or when sink returns false to stop early.
+bool decompressBuffer(CompressionFormat format, const char* data, size_t size,
+    const std::function<bool(const char*, size_t)>& sink);
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "DepthPrepass.h"
+#include "GLExtensions.h"
+#include <stdio.h>
+
+bool depthPrepassEnabled = false;                                                        // Lay down depth before shading
+bool fragmentCountingEnabled = false;                                                    // Wrap the passes in occlusion queries
+FragmentCounts fragmentCounts = {};                                                      // Counts of the last drawModel
+
+static GLuint fragmentQuery = 0;                                                         // GL_SAMPLES_PASSED query reused by every pass
+
+void toggleDepthPrepass() {
+    depthPrepassEnabled = !depthPrepassEnabled;
+    printf("Depth pre-pass: %s\n", depthPrepassEnabled ? "on" : "off");
+}
+
+// Run one pass, counting the samples that pass the depth test when requested
+static uint64_t drawCountedPass(const std::function<void()>& drawScene) {
+    if (!fragmentCountingEnabled || !glHasOcclusionQueries) {
+        drawScene();
+        return 0;
+    }
+    if (!fragmentQuery) glGenQueries(1, &fragmentQuery);
+    glBeginQuery(GL_SAMPLES_PASSED, fragmentQuery);
+    drawScene();
+    glEndQuery(GL_SAMPLES_PASSED);
+    GLuint samples = 0;
+    glGetQueryObjectuiv(fragmentQuery, GL_QUERY_RESULT, &samples);                       // Waits for the pass to finish
+    return samples;
+}
+
+void drawWithDepthPrepass(const std::function<void()>& drawScene) {
+    fragmentCounts = {};
+    if (!depthPrepassEnabled) {
+        fragmentCounts.shadedFragments = drawCountedPass(drawScene);
+        return;
+    }
+
+    glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_ENABLE_BIT);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);                                 // Depth only
+    glDisable(GL_LIGHTING);                                                              // Nothing is shaded in this pass
+    fragmentCounts.depthFragments = drawCountedPass(drawScene);
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glEnable(GL_LIGHTING);
+    glDepthMask(GL_FALSE);                                                               // Depth is final after the first pass
+    glDepthFunc(GL_EQUAL);                                                               // Only the nearest surface survives
+    fragmentCounts.shadedFragments = drawCountedPass(drawScene);
+    glPopAttrib();
+}
\ No newline at end of file
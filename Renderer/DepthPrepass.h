@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Samples that passed the depth test in each pass of one drawModel (filled while counting is on)
+struct FragmentCounts {
+    uint64_t depthFragments;                                                             // Depth-only pass (0 without the pre-pass)
+    uint64_t shadedFragments;                                                            // Lit pass, i.e. fragments shaded
+};
+
+extern bool depthPrepassEnabled;                                                         // Lay down depth before shading (toggled from the menu)
+extern bool fragmentCountingEnabled;                                                     // Wrap the passes in occlusion queries (stalls; benchmark only)
+extern FragmentCounts fragmentCounts;                                                    // Counts of the last drawModel
+
+void toggleDepthPrepass();                                                               // Toggle the depth pre-pass
+
+// Submit the model through drawScene once, or with the pre-pass twice: first into the depth buffer
+// only, then lit with GL_EQUAL so every covered pixel is shaded once. drawScene must produce the
+// same positions both times (same backend and culling result).
+void drawWithDepthPrepass(const std::function<void()>& drawScene);
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "FrustumCulling.h"
+#include "Meshlets.h"
+#include "OcclusionCulling.h"
+#include "LevelOfDetail.h"
+#include "MeshOrientation.h"
+#include <freeglut.h>
+#include <math.h>
+#include <stdio.h>
+
+// SSE is part of every x64 target; other targets use the scalar loop
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define FRUSTUM_SSE 1
+#else
+#define FRUSTUM_SSE 0
+#endif
+
+// Frustum culling of the model
+bool frustumCullingEnabled = true;                                                       // Skip submeshes and meshlets outside the view frustum
+bool meshletCullingEnabled = true;                                                       // Test meshlets, not just submeshes
+
+// Remove all boxes
+void CullBoxes::clear() {
+    centerX.clear(); centerY.clear(); centerZ.clear();
+    extentX.clear(); extentY.clear(); extentZ.clear();
+}
+
+// Append one box given by its corners
+void CullBoxes::add(const Bounds& bounds) {
+    centerX.push_back((bounds.min[0] + bounds.max[0]) * 0.5f);
+    centerY.push_back((bounds.min[1] + bounds.max[1]) * 0.5f);
+    centerZ.push_back((bounds.min[2] + bounds.max[2]) * 0.5f);
+    extentX.push_back((bounds.max[0] - bounds.min[0]) * 0.5f);
+    extentY.push_back((bounds.max[1] - bounds.min[1]) * 0.5f);
+    extentZ.push_back((bounds.max[2] - bounds.min[2]) * 0.5f);
+}
+
+// Planes of the clip matrix projection * modelView (Gribb/Hartmann): row 3 plus or minus rows 0-2
+void extractFrustum(const float projection[16], const float modelView[16], Frustum& frustum) {
+    float clip[16];                                                                      // Column-major product
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            clip[column * 4 + row] = projection[0 * 4 + row] * modelView[column * 4 + 0] +
+                projection[1 * 4 + row] * modelView[column * 4 + 1] +
+                projection[2 * 4 + row] * modelView[column * 4 + 2] +
+                projection[3 * 4 + row] * modelView[column * 4 + 3];
+        }
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        for (int k = 0; k < 4; k++) {
+            frustum.planes[axis * 2 + 0][k] = clip[k * 4 + 3] + clip[k * 4 + axis];      // Left, bottom, near
+            frustum.planes[axis * 2 + 1][k] = clip[k * 4 + 3] - clip[k * 4 + axis];      // Right, top, far
+        }
+    }
+    for (float* plane : frustum.planes) {                                                // Unit normals, so sphere radii compare directly
+        float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f) for (int k = 0; k < 4; k++) plane[k] /= length;
+    }
+}
+
+// Planes of the current GL projection and modelview matrices, and the eye position in the same space
+// (the affine modelview inverted: eye = -R^-1 * t)
+void currentFrustum(Frustum& frustum, float eye[3]) {
+    float projection[16], modelView[16];
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelView);
+    extractFrustum(projection, modelView, frustum);
+
+    const float* m = modelView;                                                          // Column-major, m[column * 4 + row]
+    float inverse[9] = {                                                                 // Adjugate of the upper 3x3, row-major
+        m[5] * m[10] - m[9] * m[6], m[8] * m[6] - m[4] * m[10], m[4] * m[9] - m[8] * m[5],
+        m[9] * m[2] - m[1] * m[10], m[0] * m[10] - m[8] * m[2], m[8] * m[1] - m[0] * m[9],
+        m[1] * m[6] - m[5] * m[2], m[4] * m[2] - m[0] * m[6], m[0] * m[5] - m[4] * m[1],
+    };
+    float determinant = m[0] * inverse[0] + m[4] * inverse[3] + m[8] * inverse[6];
+    float scale = determinant != 0.0f ? -1.0f / determinant : 0.0f;
+    for (int row = 0; row < 3; row++) {
+        eye[row] = scale * (inverse[row * 3 + 0] * m[12] + inverse[row * 3 + 1] * m[13] + inverse[row * 3 + 2] * m[14]);
+    }
+}
+
+// A box is outside when its center is farther behind one plane than its projected radius
+static inline bool boxVisible(const Frustum& frustum, const CullBoxes& boxes, size_t i) {
+    for (const float* plane : frustum.planes) {
+        float distance = plane[0] * boxes.centerX[i] + plane[1] * boxes.centerY[i] + plane[2] * boxes.centerZ[i] + plane[3];
+        float radius = fabsf(plane[0]) * boxes.extentX[i] + fabsf(plane[1]) * boxes.extentY[i] + fabsf(plane[2]) * boxes.extentZ[i];
+        if (distance + radius < 0.0f) return false;
+    }
+    return true;
+}
+
+// Test all boxes, four per SSE step, with a scalar loop for the remainder
+size_t cullBoxes(const Frustum& frustum, const CullBoxes& boxes, uint8_t* visible) {
+    size_t count = boxes.size();
+    size_t visibleCount = 0;
+    size_t i = 0;
+#if FRUSTUM_SSE
+    __m128 normals[6][3], absNormals[6][3], offsets[6];                                  // Planes broadcast once per call
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    for (int p = 0; p < 6; p++) {
+        for (int k = 0; k < 3; k++) {
+            normals[p][k] = _mm_set1_ps(frustum.planes[p][k]);
+            absNormals[p][k] = _mm_andnot_ps(signMask, normals[p][k]);
+        }
+        offsets[p] = _mm_set1_ps(frustum.planes[p][3]);
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128 centerX = _mm_loadu_ps(&boxes.centerX[i]), centerY = _mm_loadu_ps(&boxes.centerY[i]);
+        __m128 centerZ = _mm_loadu_ps(&boxes.centerZ[i]);
+        __m128 extentX = _mm_loadu_ps(&boxes.extentX[i]), extentY = _mm_loadu_ps(&boxes.extentY[i]);
+        __m128 extentZ = _mm_loadu_ps(&boxes.extentZ[i]);
+        __m128 inside = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());                // All four boxes start visible
+        for (int p = 0; p < 6; p++) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normals[p][0], centerX), _mm_mul_ps(normals[p][1], centerY)),
+                _mm_add_ps(_mm_mul_ps(normals[p][2], centerZ), offsets[p]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absNormals[p][0], extentX), _mm_mul_ps(absNormals[p][1], extentY)),
+                _mm_mul_ps(absNormals[p][2], extentZ));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+        int mask = _mm_movemask_ps(inside);                                              // Bit k set when box i + k is visible
+        for (int k = 0; k < 4; k++) visible[i + k] = (uint8_t)((mask >> k) & 1);
+        visibleCount += (size_t)((mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1));
+    }
+#endif
+    for (; i < count; i++) {
+        visible[i] = boxVisible(frustum, boxes, i) ? 1 : 0;
+        visibleCount += visible[i];
+    }
+    return visibleCount;
+}
+
+// Submesh boxes of the current model, rebuilt when the model changes
+static CullBoxes submeshBoxes;                                                           // Model-space submesh bounds
+static uint32_t submeshBoxesVersion = 0;                                                 // modelVersion the boxes were built from
+static std::vector<uint8_t> submeshVisible;                                              // Result of the last test
+static std::vector<uint8_t> submeshLods;                                                 // Level drawn for every submesh (kept for hysteresis)
+
+// Sphere test against the normalized planes
+static inline bool sphereVisible(const Frustum& frustum, const float center[3], float radius) {
+    for (const float* plane : frustum.planes) {
+        if (plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3] < -radius) return false;
+    }
+    return true;
+}
+
+// Append the visible meshlets of one batch as ranges, merging neighbours into one draw
+static void cullBatchMeshlets(uint32_t batchIndex, const Frustum& frustum, const float eye[3], std::vector<DrawRange>& visibleRanges) {
+    const MeshBatch& batch = meshBatches[batchIndex];
+    bool coneCulling = batch.closed && backfaceCullingEnabled;                           // Open batches are drawn two-sided
+    bool extending = false;                                                              // Last range ends at this meshlet
+    for (uint32_t m = batch.firstMeshlet; m < batch.firstMeshlet + batch.meshletCount; m++) {
+        const Meshlet& meshlet = meshlets[m];
+        bool visible = false;
+        if (frustumCullingEnabled && !sphereVisible(frustum, meshlet.center, meshlet.radius)) renderStats.frustumCulledMeshlets++;
+        else if (coneCulling && meshletFacesAway(meshlet, eye)) renderStats.backfaceCulledMeshlets++;
+        else visible = true;
+        if (!visible) {
+            renderStats.culledTriangles += meshlet.indexCount / 3;
+            extending = false;
+            continue;
+        }
+        renderStats.drawnMeshlets++;
+        renderStats.drawnTriangles += meshlet.indexCount / 3;
+        if (extending) visibleRanges.back().indexCount += meshlet.indexCount;
+        else visibleRanges.push_back({ batchIndex, meshlet.firstIndex, meshlet.indexCount });
+        extending = true;
+    }
+}
+
+// Cull the submeshes against the current frustum and, when enabled, the occlusion buffer, then the
+// meshlets of the visible ones against the frustum and (for back-face culled batches) their normal cones, and list the ranges to draw.
+// Submeshes far enough away are drawn whole from their simplified level instead. The frustum is extracted from
+// projection * modelview with the model transform applied, so its planes and the eye are in model
+// space and the stored bounds are tested without transforming them.
+void cullModelRanges(std::vector<DrawRange>& visibleRanges) {
+    if (submeshBoxes.size() != submeshes.size() || submeshBoxesVersion != modelVersion) {
+        submeshBoxes.clear();
+        for (const Submesh& submesh : submeshes) submeshBoxes.add(submesh.bounds);
+        submeshBoxesVersion = modelVersion;
+    }
+    Frustum frustum;
+    float eye[3];
+    currentFrustum(frustum, eye);
+    submeshVisible.assign(submeshes.size(), 1);
+    if (frustumCullingEnabled) cullBoxes(frustum, submeshBoxes, submeshVisible.data());
+
+    renderStats = {};
+    if (occlusionCullingEnabled) cullOccludedSubmeshes(submeshVisible.data());
+    selectSubmeshLods(eye, submeshLods);
+    visibleRanges.clear();
+    for (uint32_t i = 0; i < meshLods[0].batchCount; i++) {                              // Full-detail batches
+        const MeshBatch& batch = meshBatches[i];
+        if (!submeshVisible[batch.submesh]) {
+            renderStats.culledTriangles += batch.indexCount / 3;
+            renderStats.frustumCulledMeshlets += batch.meshletCount;
+        }
+        else if (submeshLods[batch.submesh] > 0) {                                       // Same batch in the simplified level
+            uint32_t lodBatch = meshLods[submeshLods[batch.submesh]].firstBatch + i;
+            const MeshBatch& simplified = meshBatches[lodBatch];
+            if (simplified.indexCount) visibleRanges.push_back({ lodBatch, simplified.firstIndex, simplified.indexCount });
+            renderStats.drawnTriangles += simplified.indexCount / 3;
+            renderStats.simplifiedTriangles += (batch.indexCount - simplified.indexCount) / 3;
+        }
+        else if (meshletCullingEnabled && batch.meshletCount) {
+            cullBatchMeshlets(i, frustum, eye, visibleRanges);
+        }
+        else {
+            visibleRanges.push_back({ i, batch.firstIndex, batch.indexCount });
+            renderStats.drawnTriangles += batch.indexCount / 3;
+            renderStats.drawnMeshlets += batch.meshletCount;
+        }
+    }
+    for (size_t i = 0; i < submeshes.size(); i++) {
+        if (!submeshes[i].indexCount) continue;                                          // Unused default submesh
+        if (submeshVisible[i]) renderStats.drawnSubmeshes++;
+        else renderStats.culledSubmeshes++;
+        if (submeshVisible[i] && submeshLods[i] > 0) renderStats.simplifiedSubmeshes++;
+    }
+}
+
+// Toggle frustum culling
+void toggleFrustumCulling() {
+    frustumCullingEnabled = !frustumCullingEnabled;
+    printf("Frustum culling: %s\n", frustumCullingEnabled ? "on" : "off");
+}
+
+// Toggle meshlet culling
+void toggleMeshletCulling() {
+    meshletCullingEnabled = !meshletCullingEnabled;
+    printf("Meshlet culling: %s\n", meshletCullingEnabled ? "on" : "off");
+}
\ No newline at end of file
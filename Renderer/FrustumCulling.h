@@ -0,0 +1,40 @@
+#pragma once
+#include "ModelLoader.h"
+#include "RenderBackend.h"
+#include <vector>
+
+// View frustum as six planes (a, b, c, d); a point is inside a plane when a*x + b*y + c*z + d >= 0.
+// The planes are in the space of the modelview matrix they were extracted with and normalized, so
+// a*x + b*y + c*z + d is a distance in that space.
+struct Frustum {
+    float planes[6][4];                                                                  // Left, right, bottom, top, near, far
+};
+
+// Axis-aligned boxes stored as centers and half extents in structure-of-arrays layout, so the
+// batch test can load one component of four boxes with a single SIMD load
+struct CullBoxes {
+    std::vector<float> centerX, centerY, centerZ;                                        // Box centers
+    std::vector<float> extentX, extentY, extentZ;                                        // Half sizes (non-negative)
+
+    void clear();                                                                        // Remove all boxes
+    void add(const Bounds& bounds);                                                      // Append one box
+    size_t size() const { return centerX.size(); }                                       // Number of boxes
+};
+
+void extractFrustum(const float projection[16], const float modelView[16], Frustum& frustum); // Planes of projection * modelView (column-major)
+void currentFrustum(Frustum& frustum, float eye[3]);                                     // Planes and eye position of the current GL matrices
+
+// Test every box against the frustum, writing 1 (intersects or inside) or 0 (fully outside one
+// plane) to visible[i]. Four boxes are tested per SSE step. Returns the number of visible boxes.
+size_t cullBoxes(const Frustum& frustum, const CullBoxes& boxes, uint8_t* visible);
+
+// Culling of the model (toggled from the menu)
+extern bool frustumCullingEnabled;                                                       // Skip submeshes and meshlets outside the view frustum
+extern bool meshletCullingEnabled;                                                       // Test meshlets, not just submeshes
+
+// Test the submesh bounds against the frustum of the current GL matrices (model transform applied) and
+// the occlusion buffer, then the meshlets of visible submeshes against the frustum, and list the index
+// ranges to draw; updates renderStats
+void cullModelRanges(std::vector<DrawRange>& visibleRanges);
+void toggleFrustumCulling();                                                             // Toggle frustum culling
+void toggleMeshletCulling();                                                             // Toggle meshlet (frustum and normal cone) culling
\ No newline at end of file
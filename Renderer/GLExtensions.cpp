@@ -0,0 +1,148 @@
+#include "GLExtensions.h"
+#include <stdio.h>
+#include <string.h>
+
+// Loaded entry points (null until loadGLExtensions finds them)
+GLGenBuffersFunction glExtGenBuffers = nullptr;
+GLDeleteBuffersFunction glExtDeleteBuffers = nullptr;
+GLBindBufferFunction glExtBindBuffer = nullptr;
+GLBufferDataFunction glExtBufferData = nullptr;
+GLBufferSubDataFunction glExtBufferSubData = nullptr;
+GLCreateShaderFunction glExtCreateShader = nullptr;
+GLShaderSourceFunction glExtShaderSource = nullptr;
+GLCompileShaderFunction glExtCompileShader = nullptr;
+GLGetShaderivFunction glExtGetShaderiv = nullptr;
+GLGetShaderInfoLogFunction glExtGetShaderInfoLog = nullptr;
+GLDeleteShaderFunction glExtDeleteShader = nullptr;
+GLCreateProgramFunction glExtCreateProgram = nullptr;
+GLAttachShaderFunction glExtAttachShader = nullptr;
+GLBindAttribLocationFunction glExtBindAttribLocation = nullptr;
+GLLinkProgramFunction glExtLinkProgram = nullptr;
+GLGetProgramivFunction glExtGetProgramiv = nullptr;
+GLGetProgramInfoLogFunction glExtGetProgramInfoLog = nullptr;
+GLUseProgramFunction glExtUseProgram = nullptr;
+GLDeleteProgramFunction glExtDeleteProgram = nullptr;
+GLVertexAttribPointerFunction glExtVertexAttribPointer = nullptr;
+GLEnableVertexAttribArrayFunction glExtEnableVertexAttribArray = nullptr;
+GLDisableVertexAttribArrayFunction glExtDisableVertexAttribArray = nullptr;
+GLGetUniformLocationFunction glExtGetUniformLocation = nullptr;
+GLUniform1iFunction glExtUniform1i = nullptr;
+GLUniform3fvFunction glExtUniform3fv = nullptr;
+GLGenVertexArraysFunction glExtGenVertexArrays = nullptr;
+GLDeleteVertexArraysFunction glExtDeleteVertexArrays = nullptr;
+GLBindVertexArrayFunction glExtBindVertexArray = nullptr;
+GLDrawElementsInstancedFunction glExtDrawElementsInstanced = nullptr;
+GLVertexAttribDivisorFunction glExtVertexAttribDivisor = nullptr;
+GLGenQueriesFunction glExtGenQueries = nullptr;
+GLDeleteQueriesFunction glExtDeleteQueries = nullptr;
+GLBeginQueryFunction glExtBeginQuery = nullptr;
+GLEndQueryFunction glExtEndQuery = nullptr;
+GLGetQueryObjectuivFunction glExtGetQueryObjectuiv = nullptr;
+GLGetUniformBlockIndexFunction glExtGetUniformBlockIndex = nullptr;
+GLUniformBlockBindingFunction glExtUniformBlockBinding = nullptr;
+GLBindBufferBaseFunction glExtBindBufferBase = nullptr;
+GLBindBufferRangeFunction glExtBindBufferRange = nullptr;
+GLMultiDrawElementsIndirectFunction glExtMultiDrawElementsIndirect = nullptr;
+GLBufferStorageFunction glExtBufferStorage = nullptr;
+GLMapBufferRangeFunction glExtMapBufferRange = nullptr;
+GLUnmapBufferFunction glExtUnmapBuffer = nullptr;
+GLFenceSyncFunction glExtFenceSync = nullptr;
+GLClientWaitSyncFunction glExtClientWaitSync = nullptr;
+GLDeleteSyncFunction glExtDeleteSync = nullptr;
+
+// Feature flags
+bool glHasBufferObjects = false;                                                         // glGenBuffers and friends are available
+bool glHasShaders = false;                                                               // GLSL programs and generic vertex attributes
+bool glHasVertexArrayObjects = false;                                                    // glGenVertexArrays and friends are available
+bool glHasInstancing = false;                                                            // Instanced draws with per-instance attributes
+bool glHasOcclusionQueries = false;                                                      // Samples-passed queries
+bool glHasHalfFloatVertices = false;                                                     // GL_HALF_FLOAT vertex attributes
+bool glHasUniformBuffers = false;                                                        // Uniform blocks backed by buffer objects
+bool glHasMultiDrawIndirect = false;                                                     // glMultiDrawElementsIndirect honouring baseInstance
+bool glHasPersistentMapping = false;                                                     // Immutable buffers mapped for their lifetime, and fences
+
+// Look up one entry point, falling back to its ARB extension name
+template <typename Function>
+static bool loadFunction(Function& function, const char* name, const char* extensionName) {
+    function = (Function)glutGetProcAddress(name);
+    if (!function && extensionName) function = (Function)glutGetProcAddress(extensionName);
+    return function != nullptr;
+}
+
+// Core in the given version or later, or advertised as an extension
+static bool hasVersionOrExtension(const char* version, const char* extensions, int major, int minor, const char* extension) {
+    int versionMajor = 0, versionMinor = 0;
+    if (version && sscanf(version, "%d.%d", &versionMajor, &versionMinor) == 2 &&
+        (versionMajor > major || (versionMajor == major && versionMinor >= minor))) return true;
+    return extensions && strstr(extensions, extension);
+}
+
+// Load all entry points once the window's context is current
+void loadGLExtensions() {
+    glHasBufferObjects =
+        loadFunction(glExtGenBuffers, "glGenBuffers", "glGenBuffersARB") &&
+        loadFunction(glExtDeleteBuffers, "glDeleteBuffers", "glDeleteBuffersARB") &&
+        loadFunction(glExtBindBuffer, "glBindBuffer", "glBindBufferARB") &&
+        loadFunction(glExtBufferData, "glBufferData", "glBufferDataARB") &&
+        loadFunction(glExtBufferSubData, "glBufferSubData", "glBufferSubDataARB");
+    glHasShaders =                                                                       // Core 2.0 names only (the ARB names use handles)
+        loadFunction(glExtCreateShader, "glCreateShader", nullptr) &&
+        loadFunction(glExtShaderSource, "glShaderSource", nullptr) &&
+        loadFunction(glExtCompileShader, "glCompileShader", nullptr) &&
+        loadFunction(glExtGetShaderiv, "glGetShaderiv", nullptr) &&
+        loadFunction(glExtGetShaderInfoLog, "glGetShaderInfoLog", nullptr) &&
+        loadFunction(glExtDeleteShader, "glDeleteShader", nullptr) &&
+        loadFunction(glExtCreateProgram, "glCreateProgram", nullptr) &&
+        loadFunction(glExtAttachShader, "glAttachShader", nullptr) &&
+        loadFunction(glExtBindAttribLocation, "glBindAttribLocation", nullptr) &&
+        loadFunction(glExtLinkProgram, "glLinkProgram", nullptr) &&
+        loadFunction(glExtGetProgramiv, "glGetProgramiv", nullptr) &&
+        loadFunction(glExtGetProgramInfoLog, "glGetProgramInfoLog", nullptr) &&
+        loadFunction(glExtUseProgram, "glUseProgram", nullptr) &&
+        loadFunction(glExtDeleteProgram, "glDeleteProgram", nullptr) &&
+        loadFunction(glExtVertexAttribPointer, "glVertexAttribPointer", nullptr) &&
+        loadFunction(glExtEnableVertexAttribArray, "glEnableVertexAttribArray", nullptr) &&
+        loadFunction(glExtDisableVertexAttribArray, "glDisableVertexAttribArray", nullptr) &&
+        loadFunction(glExtGetUniformLocation, "glGetUniformLocation", nullptr) &&
+        loadFunction(glExtUniform1i, "glUniform1i", nullptr) &&
+        loadFunction(glExtUniform3fv, "glUniform3fv", nullptr);
+    glHasVertexArrayObjects =
+        loadFunction(glExtGenVertexArrays, "glGenVertexArrays", nullptr) &&
+        loadFunction(glExtDeleteVertexArrays, "glDeleteVertexArrays", nullptr) &&
+        loadFunction(glExtBindVertexArray, "glBindVertexArray", nullptr);
+    glHasInstancing = glHasShaders &&                                                    // Instance data arrives as vertex attributes
+        loadFunction(glExtDrawElementsInstanced, "glDrawElementsInstanced", "glDrawElementsInstancedARB") &&
+        loadFunction(glExtVertexAttribDivisor, "glVertexAttribDivisor", "glVertexAttribDivisorARB");
+    glHasOcclusionQueries =
+        loadFunction(glExtGenQueries, "glGenQueries", "glGenQueriesARB") &&
+        loadFunction(glExtDeleteQueries, "glDeleteQueries", "glDeleteQueriesARB") &&
+        loadFunction(glExtBeginQuery, "glBeginQuery", "glBeginQueryARB") &&
+        loadFunction(glExtEndQuery, "glEndQuery", "glEndQueryARB") &&
+        loadFunction(glExtGetQueryObjectuiv, "glGetQueryObjectuiv", "glGetQueryObjectuivARB");
+    glHasUniformBuffers = glHasShaders && glHasBufferObjects &&                          // Core names only, the extension shares them
+        loadFunction(glExtGetUniformBlockIndex, "glGetUniformBlockIndex", nullptr) &&
+        loadFunction(glExtUniformBlockBinding, "glUniformBlockBinding", nullptr) &&
+        loadFunction(glExtBindBufferBase, "glBindBufferBase", nullptr) &&
+        loadFunction(glExtBindBufferRange, "glBindBufferRange", nullptr);
+    const char* version = (const char*)glGetString(GL_VERSION);
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    glHasHalfFloatVertices = hasVersionOrExtension(version, extensions, 3, 0, "GL_ARB_half_float_vertex");
+    glHasMultiDrawIndirect = glHasInstancing &&                                          // baseInstance reaches divisor attributes
+        hasVersionOrExtension(version, extensions, 4, 2, "GL_ARB_base_instance") &&
+        hasVersionOrExtension(version, extensions, 4, 3, "GL_ARB_multi_draw_indirect") &&
+        loadFunction(glExtMultiDrawElementsIndirect, "glMultiDrawElementsIndirect", nullptr);
+    glHasPersistentMapping = glHasBufferObjects &&
+        hasVersionOrExtension(version, extensions, 4, 4, "GL_ARB_buffer_storage") &&
+        hasVersionOrExtension(version, extensions, 3, 2, "GL_ARB_sync") &&
+        loadFunction(glExtBufferStorage, "glBufferStorage", nullptr) &&
+        loadFunction(glExtMapBufferRange, "glMapBufferRange", nullptr) &&
+        loadFunction(glExtUnmapBuffer, "glUnmapBuffer", "glUnmapBufferARB") &&
+        loadFunction(glExtFenceSync, "glFenceSync", nullptr) &&
+        loadFunction(glExtClientWaitSync, "glClientWaitSync", nullptr) &&
+        loadFunction(glExtDeleteSync, "glDeleteSync", nullptr);
+
+    printf("OpenGL %s (%s)\n", version, (const char*)glGetString(GL_RENDERER));
+    if (!glHasBufferObjects) {
+        printf("Warning: buffer objects are not supported, the model is drawn from client memory\n");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+#pragma once
+#include <freeglut.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// OpenGL entry points beyond the 1.1 API exported by opengl32.lib. They are loaded at run time
+// with glutGetProcAddress once a context exists; the gl* names below map onto the loaded pointers
+// so call sites read like plain OpenGL.
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// Buffer objects (OpenGL 1.5)
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW 0x88E4
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+
+typedef void (APIENTRY* GLGenBuffersFunction)(GLsizei count, GLuint* buffers);
+typedef void (APIENTRY* GLDeleteBuffersFunction)(GLsizei count, const GLuint* buffers);
+typedef void (APIENTRY* GLBindBufferFunction)(GLenum target, GLuint buffer);
+typedef void (APIENTRY* GLBufferDataFunction)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+typedef void (APIENTRY* GLBufferSubDataFunction)(GLenum target, ptrdiff_t offset, ptrdiff_t size, const void* data);
+
+extern GLGenBuffersFunction glExtGenBuffers;
+extern GLDeleteBuffersFunction glExtDeleteBuffers;
+extern GLBindBufferFunction glExtBindBuffer;
+extern GLBufferDataFunction glExtBufferData;
+extern GLBufferSubDataFunction glExtBufferSubData;
+
+#define glGenBuffers glExtGenBuffers
+#define glDeleteBuffers glExtDeleteBuffers
+#define glBindBuffer glExtBindBuffer
+#define glBufferData glExtBufferData
+#define glBufferSubData glExtBufferSubData
+
+// Shaders and generic vertex attributes (OpenGL 2.0)
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_INFO_LOG_LENGTH 0x8B84
+#endif
+
+typedef GLuint(APIENTRY* GLCreateShaderFunction)(GLenum type);
+typedef void (APIENTRY* GLShaderSourceFunction)(GLuint shader, GLsizei count, const char* const* strings, const GLint* lengths);
+typedef void (APIENTRY* GLCompileShaderFunction)(GLuint shader);
+typedef void (APIENTRY* GLGetShaderivFunction)(GLuint shader, GLenum name, GLint* value);
+typedef void (APIENTRY* GLGetShaderInfoLogFunction)(GLuint shader, GLsizei size, GLsizei* length, char* log);
+typedef void (APIENTRY* GLDeleteShaderFunction)(GLuint shader);
+typedef GLuint(APIENTRY* GLCreateProgramFunction)();
+typedef void (APIENTRY* GLAttachShaderFunction)(GLuint program, GLuint shader);
+typedef void (APIENTRY* GLBindAttribLocationFunction)(GLuint program, GLuint index, const char* name);
+typedef void (APIENTRY* GLLinkProgramFunction)(GLuint program);
+typedef void (APIENTRY* GLGetProgramivFunction)(GLuint program, GLenum name, GLint* value);
+typedef void (APIENTRY* GLGetProgramInfoLogFunction)(GLuint program, GLsizei size, GLsizei* length, char* log);
+typedef void (APIENTRY* GLUseProgramFunction)(GLuint program);
+typedef void (APIENTRY* GLDeleteProgramFunction)(GLuint program);
+typedef void (APIENTRY* GLVertexAttribPointerFunction)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+typedef void (APIENTRY* GLEnableVertexAttribArrayFunction)(GLuint index);
+typedef void (APIENTRY* GLDisableVertexAttribArrayFunction)(GLuint index);
+typedef GLint(APIENTRY* GLGetUniformLocationFunction)(GLuint program, const char* name);
+typedef void (APIENTRY* GLUniform1iFunction)(GLint location, GLint value);
+typedef void (APIENTRY* GLUniform3fvFunction)(GLint location, GLsizei count, const GLfloat* values);
+
+extern GLCreateShaderFunction glExtCreateShader;
+extern GLShaderSourceFunction glExtShaderSource;
+extern GLCompileShaderFunction glExtCompileShader;
+extern GLGetShaderivFunction glExtGetShaderiv;
+extern GLGetShaderInfoLogFunction glExtGetShaderInfoLog;
+extern GLDeleteShaderFunction glExtDeleteShader;
+extern GLCreateProgramFunction glExtCreateProgram;
+extern GLAttachShaderFunction glExtAttachShader;
+extern GLBindAttribLocationFunction glExtBindAttribLocation;
+extern GLLinkProgramFunction glExtLinkProgram;
+extern GLGetProgramivFunction glExtGetProgramiv;
+extern GLGetProgramInfoLogFunction glExtGetProgramInfoLog;
+extern GLUseProgramFunction glExtUseProgram;
+extern GLDeleteProgramFunction glExtDeleteProgram;
+extern GLVertexAttribPointerFunction glExtVertexAttribPointer;
+extern GLEnableVertexAttribArrayFunction glExtEnableVertexAttribArray;
+extern GLDisableVertexAttribArrayFunction glExtDisableVertexAttribArray;
+extern GLGetUniformLocationFunction glExtGetUniformLocation;
+extern GLUniform1iFunction glExtUniform1i;
+extern GLUniform3fvFunction glExtUniform3fv;
+
+#define glCreateShader glExtCreateShader
+#define glShaderSource glExtShaderSource
+#define glCompileShader glExtCompileShader
+#define glGetShaderiv glExtGetShaderiv
+#define glGetShaderInfoLog glExtGetShaderInfoLog
+#define glDeleteShader glExtDeleteShader
+#define glCreateProgram glExtCreateProgram
+#define glAttachShader glExtAttachShader
+#define glBindAttribLocation glExtBindAttribLocation
+#define glLinkProgram glExtLinkProgram
+#define glGetProgramiv glExtGetProgramiv
+#define glGetProgramInfoLog glExtGetProgramInfoLog
+#define glUseProgram glExtUseProgram
+#define glDeleteProgram glExtDeleteProgram
+#define glVertexAttribPointer glExtVertexAttribPointer
+#define glEnableVertexAttribArray glExtEnableVertexAttribArray
+#define glDisableVertexAttribArray glExtDisableVertexAttribArray
+#define glGetUniformLocation glExtGetUniformLocation
+#define glUniform1i glExtUniform1i
+#define glUniform3fv glExtUniform3fv
+
+// Vertex array objects (OpenGL 3.0 / ARB_vertex_array_object)
+typedef void (APIENTRY* GLGenVertexArraysFunction)(GLsizei count, GLuint* arrays);
+typedef void (APIENTRY* GLDeleteVertexArraysFunction)(GLsizei count, const GLuint* arrays);
+typedef void (APIENTRY* GLBindVertexArrayFunction)(GLuint array);
+
+extern GLGenVertexArraysFunction glExtGenVertexArrays;
+extern GLDeleteVertexArraysFunction glExtDeleteVertexArrays;
+extern GLBindVertexArrayFunction glExtBindVertexArray;
+
+#define glGenVertexArrays glExtGenVertexArrays
+#define glDeleteVertexArrays glExtDeleteVertexArrays
+#define glBindVertexArray glExtBindVertexArray
+
+// Instanced drawing (OpenGL 3.3 / ARB_draw_instanced + ARB_instanced_arrays)
+typedef void (APIENTRY* GLDrawElementsInstancedFunction)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount);
+typedef void (APIENTRY* GLVertexAttribDivisorFunction)(GLuint index, GLuint divisor);
+
+extern GLDrawElementsInstancedFunction glExtDrawElementsInstanced;
+extern GLVertexAttribDivisorFunction glExtVertexAttribDivisor;
+
+#define glDrawElementsInstanced glExtDrawElementsInstanced
+#define glVertexAttribDivisor glExtVertexAttribDivisor
+
+// Occlusion queries (OpenGL 1.5 / ARB_occlusion_query)
+#ifndef GL_SAMPLES_PASSED
+#define GL_SAMPLES_PASSED 0x8914
+#define GL_QUERY_RESULT 0x8866
+#endif
+
+typedef void (APIENTRY* GLGenQueriesFunction)(GLsizei count, GLuint* queries);
+typedef void (APIENTRY* GLDeleteQueriesFunction)(GLsizei count, const GLuint* queries);
+typedef void (APIENTRY* GLBeginQueryFunction)(GLenum target, GLuint query);
+typedef void (APIENTRY* GLEndQueryFunction)(GLenum target);
+typedef void (APIENTRY* GLGetQueryObjectuivFunction)(GLuint query, GLenum name, GLuint* value);
+
+extern GLGenQueriesFunction glExtGenQueries;
+extern GLDeleteQueriesFunction glExtDeleteQueries;
+extern GLBeginQueryFunction glExtBeginQuery;
+extern GLEndQueryFunction glExtEndQuery;
+extern GLGetQueryObjectuivFunction glExtGetQueryObjectuiv;
+
+#define glGenQueries glExtGenQueries
+#define glDeleteQueries glExtDeleteQueries
+#define glBeginQuery glExtBeginQuery
+#define glEndQuery glExtEndQuery
+#define glGetQueryObjectuiv glExtGetQueryObjectuiv
+
+// Half-float vertex attributes (OpenGL 3.0 / ARB_half_float_vertex; no entry points)
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+
+// Uniform buffer objects (OpenGL 3.1 / ARB_uniform_buffer_object)
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER 0x8A11
+#define GL_MAX_UNIFORM_BLOCK_SIZE 0x8A30
+#define GL_INVALID_INDEX 0xFFFFFFFFu
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+
+typedef GLuint(APIENTRY* GLGetUniformBlockIndexFunction)(GLuint program, const char* name);
+typedef void (APIENTRY* GLUniformBlockBindingFunction)(GLuint program, GLuint blockIndex, GLuint binding);
+typedef void (APIENTRY* GLBindBufferBaseFunction)(GLenum target, GLuint binding, GLuint buffer);
+typedef void (APIENTRY* GLBindBufferRangeFunction)(GLenum target, GLuint binding, GLuint buffer, ptrdiff_t offset, ptrdiff_t size);
+
+extern GLGetUniformBlockIndexFunction glExtGetUniformBlockIndex;
+extern GLUniformBlockBindingFunction glExtUniformBlockBinding;
+extern GLBindBufferBaseFunction glExtBindBufferBase;
+extern GLBindBufferRangeFunction glExtBindBufferRange;
+
+#define glGetUniformBlockIndex glExtGetUniformBlockIndex
+#define glUniformBlockBinding glExtUniformBlockBinding
+#define glBindBufferBase glExtBindBufferBase
+#define glBindBufferRange glExtBindBufferRange
+
+// Multi-draw indirect with per-draw base instances (OpenGL 4.3 / ARB_multi_draw_indirect + ARB_base_instance)
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+typedef void (APIENTRY* GLMultiDrawElementsIndirectFunction)(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride);
+
+extern GLMultiDrawElementsIndirectFunction glExtMultiDrawElementsIndirect;
+
+#define glMultiDrawElementsIndirect glExtMultiDrawElementsIndirect
+
+// Persistently mapped buffers and fences (OpenGL 4.4 / ARB_buffer_storage, OpenGL 3.2 / ARB_sync)
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+typedef struct __GLsync* GLsync;
+#endif
+
+typedef void (APIENTRY* GLBufferStorageFunction)(GLenum target, ptrdiff_t size, const void* data, GLbitfield flags);
+typedef void* (APIENTRY* GLMapBufferRangeFunction)(GLenum target, ptrdiff_t offset, ptrdiff_t length, GLbitfield access);
+typedef GLboolean(APIENTRY* GLUnmapBufferFunction)(GLenum target);
+typedef GLsync(APIENTRY* GLFenceSyncFunction)(GLenum condition, GLbitfield flags);
+typedef GLenum(APIENTRY* GLClientWaitSyncFunction)(GLsync sync, GLbitfield flags, uint64_t timeout);
+typedef void (APIENTRY* GLDeleteSyncFunction)(GLsync sync);
+
+extern GLBufferStorageFunction glExtBufferStorage;
+extern GLMapBufferRangeFunction glExtMapBufferRange;
+extern GLUnmapBufferFunction glExtUnmapBuffer;
+extern GLFenceSyncFunction glExtFenceSync;
+extern GLClientWaitSyncFunction glExtClientWaitSync;
+extern GLDeleteSyncFunction glExtDeleteSync;
+
+#define glBufferStorage glExtBufferStorage
+#define glMapBufferRange glExtMapBufferRange
+#define glUnmapBuffer glExtUnmapBuffer
+#define glFenceSync glExtFenceSync
+#define glClientWaitSync glExtClientWaitSync
+#define glDeleteSync glExtDeleteSync
+
+// Feature flags, valid after loadGLExtensions
+extern bool glHasBufferObjects;                                                          // glGenBuffers and friends are available
+extern bool glHasShaders;                                                                // GLSL programs and generic vertex attributes
+extern bool glHasVertexArrayObjects;                                                     // glGenVertexArrays and friends are available
+extern bool glHasInstancing;                                                             // Instanced draws with per-instance attributes
+extern bool glHasOcclusionQueries;                                                       // Samples-passed queries
+extern bool glHasHalfFloatVertices;                                                      // GL_HALF_FLOAT vertex attributes
+extern bool glHasUniformBuffers;                                                         // Uniform blocks backed by buffer objects
+extern bool glHasMultiDrawIndirect;                                                      // glMultiDrawElementsIndirect honouring baseInstance
+extern bool glHasPersistentMapping;                                                      // Immutable buffers mapped for their lifetime, and fences
+
+void loadGLExtensions();                                                                 // Load entry points (needs a current context)
\ No newline at end of file
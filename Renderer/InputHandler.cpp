@@ -2,7 +2,19 @@
 #include "Camera.h"
 #include "ModelLoader.h"
 #include "Renderer.h"
+#include "Benchmark.h"
+#include "StreamingLoader.h"
+#include "RenderBackend.h"
+#include "FrustumCulling.h"
+#include "Instancing.h"
+#include "DepthPrepass.h"
+#include "OcclusionCulling.h"
+#include "LevelOfDetail.h"
+#include "VertexQuantization.h"
+#include "MeshOrientation.h"
+#include "VertexAnimation.h"
 #include <algorithm>
+#include <string>
 
 // Define PI constant if not already defined by the compiler
 #ifndef M_PI
@@ -13,8 +25,27 @@
 bool mousePressed = false;                                                               // Flag indicating if mouse button is pressed
 int mouseX = 0, mouseY = 0;                                                              // Current mouse position
 
-// Menu ID
+// Menu IDs
 int mainMenu;                                                                            // ID for the main context menu
+int backendMenu;                                                                         // ID for the render backend submenu
+int instanceMenu;                                                                        // ID for the instancing submenu
+
+// Layouts offered by the instancing submenu; the menu option is the index into this table
+struct InstanceMenuEntry {
+    const char* label;                                                                   // Menu text
+    InstanceLayout layout;                                                               // Generated arrangement
+    size_t count;                                                                        // Number of instances (0 = off)
+};
+
+static const InstanceMenuEntry instanceMenuEntries[] = {
+    { "Off (single model)", INSTANCE_LAYOUT_GRID, 0 },
+    { "Grid 10k", INSTANCE_LAYOUT_GRID, 10000 },
+    { "Grid 100k", INSTANCE_LAYOUT_GRID, 100000 },
+    { "Grid 1M", INSTANCE_LAYOUT_GRID, 1000000 },
+    { "Random 10k", INSTANCE_LAYOUT_RANDOM, 10000 },
+    { "Random 100k", INSTANCE_LAYOUT_RANDOM, 100000 },
+    { "Random 1M", INSTANCE_LAYOUT_RANDOM, 1000000 },
+};
 
 // Keyboard callback function - processes key presses for navigation and model manipulation
 void keyboard(unsigned char key, int x, int y) {
@@ -122,10 +153,11 @@ void keyboard(unsigned char key, int x, int y) {
         break;
 
     case 27:                                                                             // ESC key (ASCII 27)
+        cancelStreamingLoad();                                                           // Stop the background parser first
         exit(0);                                                                         // Exit the application
         break;
     }
-    glutPostRedisplay();                                                                 // Request a redraw to update the display
+    redisplayIfChanged();                                                                // Redraw only if the key moved the camera or model
 }
 
 // Mouse button callback function - handles mouse button press and release events
@@ -155,7 +187,7 @@ void mouseMotion(int x, int y) {
         mouseX = x;                                                                      // Store new X position
         mouseY = y;                                                                      // Store new Y position
 
-        glutPostRedisplay();                                                             // Request a redraw to update the display
+        redisplayIfChanged();                                                            // Redraw only if the view actually turned
     }
 }
 
@@ -175,19 +207,155 @@ void menuCallback(int option) {
         toggleGrid();                                                                    // Toggle grid visibility flag
         glutPostRedisplay();                                                             // Request a redraw to update display
         break;
+    case MENU_TOGGLE_STREAMING:                                                          // User selected "Toggle Streaming Load"
+        toggleStreamingLoad();                                                           // Switch between streaming and blocking loads
+        break;
+    case MENU_TOGGLE_FRUSTUM_CULLING:                                                    // User selected "Toggle Frustum Culling"
+        toggleFrustumCulling();                                                          // Skip or draw submeshes outside the view
+        glutPostRedisplay();                                                             // Redraw with the new setting
+        break;
+    case MENU_TOGGLE_MESHLET_CULLING:                                                    // User selected "Toggle Meshlet Culling"
+        toggleMeshletCulling();                                                          // Test meshlets or only whole submeshes
+        glutPostRedisplay();                                                             // Redraw with the new setting
+        break;
+    case MENU_TOGGLE_OCCLUSION_CULLING:                                                  // User selected "Toggle Occlusion Culling"
+        toggleOcclusionCulling();                                                        // Test submeshes against the largest occluders
+        glutPostRedisplay();                                                             // Redraw with the new setting
+        break;
+    case MENU_TOGGLE_OCCLUSION_VIEW:                                                     // User selected "Toggle Occlusion Buffer View"
+        toggleOcclusionBufferView();                                                     // Show or hide the CPU depth buffer
+        glutPostRedisplay();                                                             // Redraw with the new setting
+        break;
+    case MENU_TOGGLE_LOD:                                                                // User selected "Toggle Level of Detail"
+        toggleLodSelection();                                                            // Draw distant submeshes simplified or at full detail
+        glutPostRedisplay();                                                             // Redraw with the new setting
+        break;
+    case MENU_TOGGLE_QUANTIZED:                                                          // User selected "Toggle Quantized Vertices"
+        toggleQuantizedVertices();                                                       // Float or 16-byte vertices in the shader paths
+        glutPostRedisplay();                                                             // Redraw with the new setting
+        break;
+    case MENU_TOGGLE_BACKFACE_CULLING:                                                   // User selected "Toggle Back-face Culling"
+        toggleBackfaceCulling();                                                         // Cull or draw the back faces of closed batches
+        glutPostRedisplay();                                                             // Redraw with the new setting
+        break;
+    case MENU_TOGGLE_VERTEX_ANIMATION:                                                   // User selected "Toggle Vertex Animation"
+        toggleVertexAnimation();                                                         // Stream a deformed mesh every frame
+        glutPostRedisplay();                                                             // Start or stop the animation
+        break;
+    case MENU_TOGGLE_DEPTH_PREPASS:                                                      // User selected "Toggle Depth Pre-pass"
+        toggleDepthPrepass();                                                            // Depth-only pass before the lit pass
+        glutPostRedisplay();                                                             // Redraw with the new setting
+        break;
+    case MENU_BENCHMARK_OBJ:                                                             // User selected "Benchmark OBJ Parsers"
+        cancelStreamingLoad();                                                           // Benchmark replaces the model containers
+        benchmarkOBJParsers();                                                           // Time legacy and mapped parsers on one file
+        glutPostRedisplay();                                                             // Show the model loaded by the benchmark
+        break;
+    case MENU_BENCHMARK_OBJ_THREADS:                                                     // User selected "Benchmark OBJ Thread Scaling"
+        benchmarkOBJThreadScaling();                                                     // Time chunked parsing with 1 to N threads
+        break;
+    case MENU_BENCHMARK_COMPRESSED:                                                      // User selected "Benchmark Compressed OBJ"
+        benchmarkCompressedOBJ();                                                        // Decompress-then-parse vs overlapped vs raw
+        break;
+    case MENU_BENCHMARK_BACKENDS:                                                        // User selected "Benchmark Render Backends"
+        benchmarkRenderBackends();                                                       // Frame rates of all backends, selects the fastest
+        glutPostRedisplay();
+        break;
+    case MENU_BENCHMARK_NUMBERS:                                                         // User selected "Benchmark Number Parser"
+        benchmarkNumberParser();                                                         // Exactness check and microbenchmarks
+        break;
+    case MENU_BENCHMARK_DEPTH_PREPASS:                                                   // User selected "Benchmark Depth Pre-pass"
+        benchmarkDepthPrepass();                                                         // Frame time and overdraw with and without
+        glutPostRedisplay();
+        break;
+    case MENU_BENCHMARK_LOD:                                                             // User selected "Benchmark LOD Zoom"
+        benchmarkLodZoom();                                                              // Frame time and triangles with and without LOD
+        glutPostRedisplay();
+        break;
+    case MENU_BENCHMARK_QUANTIZED:                                                       // User selected "Benchmark Quantized Vertices"
+        benchmarkQuantizedVertices();                                                    // GPU memory and frame time of both formats
+        glutPostRedisplay();
+        break;
+    case MENU_BENCHMARK_BACKFACE_CULLING:                                                // User selected "Benchmark Back-face Culling"
+        benchmarkBackfaceCulling();                                                      // Frame time and shaded fragments with and without
+        glutPostRedisplay();
+        break;
+    case MENU_GENERATE_CUBE_SCENE:                                                       // User selected "Generate Cube Scene"
+        generateCubeScene(10000, 300);                                                   // Submission-bound scene for the multi-draw benchmark
+        glutPostRedisplay();                                                             // Show the generated scene
+        break;
+    case MENU_BENCHMARK_MULTI_DRAW:                                                      // User selected "Benchmark Multi-draw Indirect"
+        benchmarkMultiDrawIndirect();                                                    // Submission time of per-range and indirect draws
+        glutPostRedisplay();
+        break;
+    case MENU_BENCHMARK_STREAMING:                                                       // User selected "Benchmark Vertex Streaming"
+        benchmarkVertexStreaming();                                                      // Upload bandwidth and stalls of both upload paths
+        glutPostRedisplay();
+        break;
     case MENU_EXIT:                                                                      // User selected "Exit"
+        cancelStreamingLoad();                                                           // Stop the background parser first
         exit(0);                                                                         // Exit the application
         break;
     }
 }
 
+// Render backend submenu callback - the option is the RenderBackendType
+void backendMenuCallback(int option) {
+    setRenderBackend((RenderBackendType)option, true);                                   // Prints a message if unsupported
+    glutPostRedisplay();                                                                 // Redraw with the new backend
+}
+
+// Instancing submenu callback - the option indexes instanceMenuEntries
+void instanceMenuCallback(int option) {
+    const InstanceMenuEntry& entry = instanceMenuEntries[option];
+    generateInstances(entry.layout, entry.count);                                        // Layout is sized from the loaded model
+    glutPostRedisplay();                                                                 // Redraw with the new instances
+}
+
 // Create right-click context menu
 void createMenu() {
+    backendMenu = glutCreateMenu(backendMenuCallback);                                   // Submenu listing every render backend
+    for (int i = 0; i < RENDER_BACKEND_COUNT; i++) {
+        RenderBackend& backend = renderBackend((RenderBackendType)i);
+        std::string label = backend.name();
+        if (!backend.isSupported()) label += " (not supported)";
+        glutAddMenuEntry(label.c_str(), i);
+    }
+
+    instanceMenu = glutCreateMenu(instanceMenuCallback);                                 // Submenu of generated instance layouts
+    for (int i = 0; i < (int)(sizeof(instanceMenuEntries) / sizeof(instanceMenuEntries[0])); i++) {
+        glutAddMenuEntry(instanceMenuEntries[i].label, i);
+    }
+
     mainMenu = glutCreateMenu(menuCallback);                                             // Create menu with callback function
     glutAddMenuEntry("Load New Model", MENU_LOAD_MODEL);                                 // Add menu option to load a new model
     glutAddMenuEntry("Reset Camera", MENU_RESET_CAMERA);                                 // Add menu option to reset camera position
     glutAddMenuEntry("Reset Model Position", MENU_RESET_MODEL);                          // Add menu option to reset model transform
     glutAddMenuEntry("Toggle Grid", MENU_TOGGLE_GRID);                                   // Add menu option to toggle grid visibility
+    glutAddMenuEntry("Toggle Streaming Load", MENU_TOGGLE_STREAMING);                    // Add menu option to toggle progressive loading
+    glutAddMenuEntry("Toggle Frustum Culling", MENU_TOGGLE_FRUSTUM_CULLING);             // Add menu option to toggle frustum culling
+    glutAddMenuEntry("Toggle Meshlet Culling", MENU_TOGGLE_MESHLET_CULLING);             // Add menu option to toggle meshlet culling
+    glutAddMenuEntry("Toggle Occlusion Culling", MENU_TOGGLE_OCCLUSION_CULLING);         // Add menu option to toggle occlusion culling
+    glutAddMenuEntry("Toggle Occlusion Buffer View", MENU_TOGGLE_OCCLUSION_VIEW);        // Add menu option to show the occlusion buffer
+    glutAddMenuEntry("Toggle Depth Pre-pass", MENU_TOGGLE_DEPTH_PREPASS);                // Add menu option to toggle the depth pre-pass
+    glutAddMenuEntry("Toggle Level of Detail", MENU_TOGGLE_LOD);                         // Add menu option to toggle level of detail selection
+    glutAddMenuEntry("Toggle Quantized Vertices", MENU_TOGGLE_QUANTIZED);                // Add menu option to toggle the 16-byte vertex format
+    glutAddMenuEntry("Toggle Back-face Culling", MENU_TOGGLE_BACKFACE_CULLING);          // Add menu option to toggle culling of closed meshes
+    glutAddMenuEntry("Toggle Vertex Animation", MENU_TOGGLE_VERTEX_ANIMATION);           // Add menu option to animate the mesh through the stream buffer
+    glutAddSubMenu("Render Backend", backendMenu);                                       // Add submenu to select the render backend
+    glutAddSubMenu("Instances", instanceMenu);                                           // Add submenu to draw many copies of the model
+    glutAddMenuEntry("Benchmark OBJ Parsers", MENU_BENCHMARK_OBJ);                       // Add menu option to benchmark OBJ parsers
+    glutAddMenuEntry("Benchmark OBJ Thread Scaling", MENU_BENCHMARK_OBJ_THREADS);        // Add menu option to benchmark OBJ thread scaling
+    glutAddMenuEntry("Benchmark Compressed OBJ", MENU_BENCHMARK_COMPRESSED);             // Add menu option to benchmark compressed OBJ loading
+    glutAddMenuEntry("Benchmark Render Backends", MENU_BENCHMARK_BACKENDS);              // Add menu option to compare render backend frame rates
+    glutAddMenuEntry("Benchmark Number Parser", MENU_BENCHMARK_NUMBERS);                 // Add menu option to benchmark the number parser
+    glutAddMenuEntry("Benchmark Depth Pre-pass", MENU_BENCHMARK_DEPTH_PREPASS);          // Add menu option to compare overdraw with and without a depth pre-pass
+    glutAddMenuEntry("Benchmark LOD Zoom", MENU_BENCHMARK_LOD);                          // Add menu option to time triangle throughput while zooming out
+    glutAddMenuEntry("Benchmark Quantized Vertices", MENU_BENCHMARK_QUANTIZED);          // Add menu option to compare float and quantized vertices
+    glutAddMenuEntry("Benchmark Back-face Culling", MENU_BENCHMARK_BACKFACE_CULLING);    // Add menu option to compare frames with and without back-face culling
+    glutAddMenuEntry("Generate Cube Scene", MENU_GENERATE_CUBE_SCENE);                   // Add menu option to build the multi-draw benchmark scene
+    glutAddMenuEntry("Benchmark Multi-draw Indirect", MENU_BENCHMARK_MULTI_DRAW);        // Add menu option to compare draw submission paths
+    glutAddMenuEntry("Benchmark Vertex Streaming", MENU_BENCHMARK_STREAMING);            // Add menu option to compare the vertex upload paths
     glutAddMenuEntry("Exit", MENU_EXIT);                                                 // Add menu option to exit application
 
     glutAttachMenu(GLUT_RIGHT_BUTTON);                                                   // Attach menu to right mouse button
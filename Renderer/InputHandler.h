@@ -13,6 +13,28 @@ enum MenuOptions {
     MENU_RESET_CAMERA,                                 // Option to reset camera position
     MENU_RESET_MODEL,                                  // Option to reset model transformations
     MENU_TOGGLE_GRID,                                  // Option to toggle grid visibility
+    MENU_TOGGLE_STREAMING,                             // Option to toggle progressive model loading
+    MENU_TOGGLE_FRUSTUM_CULLING,                       // Option to toggle view frustum culling
+    MENU_TOGGLE_MESHLET_CULLING,                       // Option to toggle meshlet culling
+    MENU_TOGGLE_OCCLUSION_CULLING,                     // Option to toggle software occlusion culling
+    MENU_TOGGLE_OCCLUSION_VIEW,                        // Option to toggle the occlusion buffer view
+    MENU_TOGGLE_DEPTH_PREPASS,                         // Option to toggle the depth pre-pass
+    MENU_TOGGLE_LOD,                                   // Option to toggle level of detail selection
+    MENU_TOGGLE_QUANTIZED,                             // Option to toggle quantized vertices
+    MENU_TOGGLE_BACKFACE_CULLING,                      // Option to toggle back-face culling of closed meshes
+    MENU_TOGGLE_VERTEX_ANIMATION,                      // Option to toggle the streamed vertex animation
+    MENU_BENCHMARK_OBJ,                                // Option to benchmark OBJ parsers
+    MENU_BENCHMARK_OBJ_THREADS,                        // Option to benchmark OBJ loading thread scaling
+    MENU_BENCHMARK_COMPRESSED,                         // Option to benchmark compressed OBJ loading
+    MENU_BENCHMARK_BACKENDS,                           // Option to compare render backend frame rates
+    MENU_BENCHMARK_NUMBERS,                            // Option to check and benchmark the number parser
+    MENU_BENCHMARK_DEPTH_PREPASS,                      // Option to compare frames with and without the depth pre-pass
+    MENU_BENCHMARK_LOD,                                // Option to time triangle throughput while zooming out
+    MENU_BENCHMARK_QUANTIZED,                          // Option to compare float and quantized vertices
+    MENU_BENCHMARK_BACKFACE_CULLING,                   // Option to compare frames with and without back-face culling
+    MENU_GENERATE_CUBE_SCENE,                          // Option to replace the model with the 10,000-submesh cube scene
+    MENU_BENCHMARK_MULTI_DRAW,                         // Option to compare per-range draws and multi-draw indirect
+    MENU_BENCHMARK_STREAMING,                          // Option to compare glBufferSubData and the mapped stream buffer
     MENU_EXIT                                          // Option to exit the application
 };
 
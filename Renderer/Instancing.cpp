@@ -0,0 +1,253 @@
+#include "Instancing.h"
+#include "ModelLoader.h"
+#include "GLExtensions.h"
+#include "MeshBuffers.h"
+#include "ShaderProgram.h"
+#include "RenderBackend.h"
+#include "FrustumCulling.h"
+#include "VertexQuantization.h"
+#include "MeshOrientation.h"
+#include <math.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <random>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+// Instances of the model
+std::vector<InstanceTransform> instances;                                                // Copies drawn instead of the single model
+uint32_t instancesVersion = 0;                                                           // Incremented whenever instances change
+
+// Per-instance culling boxes, rebuilt when the instances or the model bounds change
+static CullBoxes instanceBoxes;                                                          // Boxes around every placed copy
+static uint32_t instanceBoxesVersion = 0;                                                // instancesVersion of the boxes
+static uint32_t instanceBoxesModelVersion = 0;                                           // modelVersion of the boxes
+static std::vector<uint8_t> instanceVisible;                                             // Result of the last test
+static std::vector<InstanceTransform> visibleInstances;                                  // Compacted visible transforms
+static const std::vector<InstanceTransform>* drawnInstances = &instances;                // Result of the last cullModelInstances
+
+// GPU state of the instanced path
+static GLuint instanceBuffer = 0;                                                        // Instance transforms of the last draw
+static uint32_t instanceBufferVersion = 0;                                               // instancesVersion of a full upload (0 after a culled one)
+static bool visibleInstancesUploaded = false;                                            // Buffer holds visibleInstances of the last cull
+static GLuint instanceProgram = 0;                                                       // Lighting program with instance attributes
+static bool instanceProgramBuilt = false;                                                // Build was attempted
+static MeshDecodeUniforms instanceDecodeUniforms = {};                                   // Decode uniform locations of instanceProgram
+
+// Fixed-function lighting of the shader backend, with the instance placement applied first. Follows
+// meshVertexShaderHeader like the backend's shader.
+static const char* instanceVertexShader = R"(
+attribute vec3 position;
+attribute vec3 normal;
+attribute vec2 texCoord;
+attribute vec4 instancePlacement;
+attribute vec4 instanceRotation;
+varying vec3 viewPosition;
+varying vec3 viewNormal;
+vec3 rotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+void main() {
+    vec3 placed = instancePlacement.xyz + instancePlacement.w * rotate(instanceRotation, decodePosition(position));
+    vec4 eyePosition = gl_ModelViewMatrix * vec4(placed, 1.0);
+    viewPosition = eyePosition.xyz;
+    viewNormal = gl_NormalMatrix * rotate(instanceRotation, decodeNormal(normal));
+    gl_TexCoord[0] = vec4(texCoord, 0.0, 1.0);
+    gl_Position = gl_ProjectionMatrix * eyePosition;
+}
+)";
+
+// Replace the instances with a generated layout. Copies are spaced by 1.5 model sizes; the random
+// layout covers the same square as the grid so both have the same density.
+void generateInstances(InstanceLayout layout, size_t count) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<InstanceTransform>().swap(instances);                                    // Release the old layout
+    instancesVersion++;
+    if (count == 0) {
+        printf("Instancing: off\n");
+        return;
+    }
+
+    float size = 0.0f;                                                                   // Largest model extent
+    for (int axis = 0; axis < 3; axis++) size = std::max(size, modelBounds.max[axis] - modelBounds.min[axis]);
+    float spacing = size > 0.0f ? size * 1.5f : 1.0f;
+    size_t side = (size_t)ceil(sqrt((double)count));                                     // Instances per grid row
+    float origin = -0.5f * spacing * (float)(side - 1);                                  // Grid centered on the model origin
+
+    instances.resize(count);
+    if (layout == INSTANCE_LAYOUT_GRID) {
+        for (size_t i = 0; i < count; i++) {
+            instances[i] = { { origin + spacing * (float)(i % side), 0.0f, origin + spacing * (float)(i / side) }, 1.0f, { 0, 0, 0, 1 } };
+        }
+    }
+    else {
+        std::mt19937 random(12345);                                                      // Fixed seed, so runs are comparable
+        std::uniform_real_distribution<float> coordinate(origin, -origin), yaw(0.0f, 6.2831853f), scale(0.5f, 1.5f);
+        for (InstanceTransform& instance : instances) {
+            float angle = yaw(random) * 0.5f;                                            // Quaternion half angle about +Y
+            instance = { { coordinate(random), 0.0f, coordinate(random) }, scale(random), { 0.0f, sinf(angle), 0.0f, cosf(angle) } };
+        }
+    }
+    printf("Instancing: %zu instances (%s) in %.1f ms, %.2f MB of transforms\n", count,
+        layout == INSTANCE_LAYOUT_GRID ? "grid" : "random",
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+        count * sizeof(InstanceTransform) / (1024.0 * 1024.0));
+}
+
+// Rotate v by the unit quaternion q
+static inline void rotateVector(const float q[4], const float v[3], float out[3]) {
+    float t[3] = {                                                                       // 2 * cross(q.xyz, v)
+        2.0f * (q[1] * v[2] - q[2] * v[1]),
+        2.0f * (q[2] * v[0] - q[0] * v[2]),
+        2.0f * (q[0] * v[1] - q[1] * v[0]) };
+    out[0] = v[0] + q[3] * t[0] + (q[1] * t[2] - q[2] * t[1]);
+    out[1] = v[1] + q[3] * t[1] + (q[2] * t[0] - q[0] * t[2]);
+    out[2] = v[2] + q[3] * t[2] + (q[0] * t[1] - q[1] * t[0]);
+}
+
+// Box around the model bounds placed by every instance: the center is transformed and the half
+// extents grow by the absolute rotation matrix
+static void updateInstanceBoxes() {
+    if (instanceBoxesVersion == instancesVersion && instanceBoxesModelVersion == modelVersion &&
+        instanceBoxes.size() == instances.size()) return;
+    instanceBoxes.clear();
+    float center[3], extent[3];
+    for (int axis = 0; axis < 3; axis++) {
+        center[axis] = (modelBounds.min[axis] + modelBounds.max[axis]) * 0.5f;
+        extent[axis] = (modelBounds.max[axis] - modelBounds.min[axis]) * 0.5f;
+    }
+    static const float unitAxes[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    for (const InstanceTransform& instance : instances) {
+        float rotated[3][3];                                                             // Column k is the rotated unit axis k
+        for (int k = 0; k < 3; k++) rotateVector(instance.rotation, unitAxes[k], rotated[k]);
+        Bounds bounds;
+        for (int axis = 0; axis < 3; axis++) {
+            float placed = instance.position[axis] + instance.scale *
+                (rotated[0][axis] * center[0] + rotated[1][axis] * center[1] + rotated[2][axis] * center[2]);
+            float halfSize = instance.scale *
+                (fabsf(rotated[0][axis]) * extent[0] + fabsf(rotated[1][axis]) * extent[1] + fabsf(rotated[2][axis]) * extent[2]);
+            bounds.min[axis] = placed - halfSize;
+            bounds.max[axis] = placed + halfSize;
+        }
+        instanceBoxes.add(bounds);
+    }
+    instanceBoxesVersion = instancesVersion;
+    instanceBoxesModelVersion = modelVersion;
+}
+
+// Build the instanced program once; false when the driver cannot draw instanced
+static bool instancedDrawingSupported() {
+    if (!glHasBufferObjects || !glHasInstancing) return false;
+    if (!instanceProgramBuilt) {
+        static const char* const attributes[] = { "position", "normal", "texCoord", "instancePlacement", "instanceRotation" };
+        std::string vertexSource = std::string(meshVertexShaderHeader) + instanceVertexShader;
+        instanceProgram = buildShaderProgram("instanced mesh", vertexSource.c_str(), meshFragmentShader, attributes, 5);
+        if (instanceProgram) instanceDecodeUniforms = findMeshDecodeUniforms(instanceProgram);
+        instanceProgramBuilt = true;
+    }
+    return instanceProgram != 0;
+}
+
+// Upload the transforms to draw; the full set is only uploaded again after it changed, a culled set
+// once per cull (the shading pass after a depth pre-pass reuses it)
+static void uploadInstances(const std::vector<InstanceTransform>& transforms, bool allInstances) {
+    if (!instanceBuffer) glGenBuffers(1, &instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    if (allInstances && instanceBufferVersion == instancesVersion) return;               // Buffer already holds every instance
+    if (!allInstances && visibleInstancesUploaded) return;                               // Buffer already holds this visible set
+    glBufferData(GL_ARRAY_BUFFER, (ptrdiff_t)(transforms.size() * sizeof(InstanceTransform)), transforms.data(),
+        allInstances ? GL_STATIC_DRAW : GL_STREAM_DRAW);                                 // Orphans the previous contents
+    instanceBufferVersion = allInstances ? instancesVersion : 0;
+    visibleInstancesUploaded = !allInstances;
+}
+
+// One glDrawElementsInstanced per batch over the uploaded transforms
+static void drawInstanced(const std::vector<InstanceTransform>& transforms, bool allInstances) {
+    updateMeshBuffers(quantizedVerticesEnabled && glHasHalfFloatVertices);
+    glUseProgram(instanceProgram);
+    setMeshDecodeUniforms(instanceDecodeUniforms);
+    bindMeshBuffers();
+    setMeshAttributePointers();
+    uploadInstances(transforms, allInstances);                                           // Leaves the instance buffer bound
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceTransform), (const void*)offsetof(InstanceTransform, position));
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceTransform), (const void*)offsetof(InstanceTransform, rotation));
+    for (GLuint attribute = 0; attribute < 5; attribute++) glEnableVertexAttribArray(attribute);
+    glVertexAttribDivisor(3, 1);                                                         // Advance once per instance
+    glVertexAttribDivisor(4, 1);
+
+    int32_t currentMaterial = -1;
+    int cullState = -1;
+    for (uint32_t i = 0; i < meshLods[0].batchCount; i++) {                              // Full-detail batches
+        const MeshBatch& batch = meshBatches[i];
+        if (batch.material != currentMaterial) {
+            applyMaterial(materials[batch.material]);
+            currentMaterial = batch.material;
+        }
+        applyBatchCulling(batch, cullState);
+        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)batch.indexCount, GL_UNSIGNED_INT,
+            (const void*)(batch.firstIndex * sizeof(uint32_t)), (GLsizei)transforms.size());
+        renderStats.drawCalls++;
+    }
+
+    endBatchCulling(cullState);
+    glVertexAttribDivisor(3, 0);
+    glVertexAttribDivisor(4, 0);
+    for (GLuint attribute = 0; attribute < 5; attribute++) glDisableVertexAttribArray(attribute);
+    unbindMeshBuffers();
+    glUseProgram(0);
+}
+
+// Fallback without instancing: every instance is a matrix change and a backend draw of all batches
+static void drawInstancesOneByOne(const std::vector<InstanceTransform>& transforms) {
+    static std::vector<DrawRange> allBatches;
+    allBatches.clear();
+    for (uint32_t i = 0; i < meshLods[0].batchCount; i++) allBatches.push_back({ i, meshBatches[i].firstIndex, meshBatches[i].indexCount });
+    RenderBackend& backend = renderBackend(currentRenderBackend());
+    for (const InstanceTransform& instance : transforms) {
+        float angle = 2.0f * acosf(std::min(1.0f, std::max(-1.0f, instance.rotation[3])));
+        float axisLength = sqrtf(instance.rotation[0] * instance.rotation[0] + instance.rotation[1] * instance.rotation[1] +
+            instance.rotation[2] * instance.rotation[2]);
+        glPushMatrix();
+        glTranslatef(instance.position[0], instance.position[1], instance.position[2]);
+        if (axisLength > 0.0f) glRotatef(angle * 57.29578f, instance.rotation[0], instance.rotation[1], instance.rotation[2]);
+        glScalef(instance.scale, instance.scale, instance.scale);
+        backend.drawRanges(allBatches.data(), allBatches.size());
+        glPopMatrix();
+    }
+}
+
+// Cull the instances with the shared SIMD box test and keep the visible ones for drawModelInstances
+void cullModelInstances() {
+    updateInstanceBoxes();
+    drawnInstances = &instances;                                                         // All instances unless culled
+    size_t visibleCount = instances.size();
+    if (frustumCullingEnabled) {
+        Frustum frustum;
+        float eye[3];
+        currentFrustum(frustum, eye);
+        instanceVisible.resize(instances.size());
+        visibleCount = cullBoxes(frustum, instanceBoxes, instanceVisible.data());
+        visibleInstances.resize(visibleCount);
+        size_t next = 0;
+        for (size_t i = 0; i < instances.size(); i++) {
+            if (instanceVisible[i]) visibleInstances[next++] = instances[i];
+        }
+        drawnInstances = &visibleInstances;
+        visibleInstancesUploaded = false;
+    }
+
+    size_t modelTriangles = meshLods[0].indexCount / 3;
+    renderStats = {};
+    renderStats.drawnInstances = visibleCount;
+    renderStats.culledInstances = instances.size() - visibleCount;
+    renderStats.drawnTriangles = modelTriangles * visibleCount;
+    renderStats.culledTriangles = modelTriangles * renderStats.culledInstances;
+}
+
+// Draw the instances kept by the last cullModelInstances
+void drawModelInstances() {
+    if (drawnInstances->empty()) return;
+    if (instancedDrawingSupported()) drawInstanced(*drawnInstances, drawnInstances == &instances);
+    else drawInstancesOneByOne(*drawnInstances);
+}
\ No newline at end of file
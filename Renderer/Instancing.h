@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Placement of one copy of the model inside the model transform (32 bytes, uploaded as two vec4 attributes)
+struct InstanceTransform {
+    float position[3];                                                                   // Translation
+    float scale;                                                                         // Uniform scale
+    float rotation[4];                                                                   // Unit quaternion (x, y, z, w)
+};
+
+// Generated arrangements of instances
+enum InstanceLayout {
+    INSTANCE_LAYOUT_GRID,                                                                // Square grid on the XZ plane, unrotated
+    INSTANCE_LAYOUT_RANDOM                                                               // Scattered over the same area with random yaw and scale
+};
+
+extern std::vector<InstanceTransform> instances;                                         // Copies drawn instead of the single model (empty = off)
+extern uint32_t instancesVersion;                                                        // Incremented whenever instances change
+
+void generateInstances(InstanceLayout layout, size_t count);                             // Replace the instances with a generated layout (0 = off)
+
+// Test every instance of the welded mesh against the frustum and keep the visible ones. Called by
+// drawModel with the model transform applied; updates renderStats.
+void cullModelInstances();
+
+// Draw the instances kept by cullModelInstances: one instanced draw per batch when the driver supports
+// it, otherwise one backend draw per instance. May be called more than once per cull.
+void drawModelInstances();
\ No newline at end of file
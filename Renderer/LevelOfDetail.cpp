@@ -0,0 +1,423 @@
+#include "LevelOfDetail.h"
+#include "ThreadPool.h"
+#include "Camera.h"
+#include "Renderer.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+bool lodSelectionEnabled = true;                                                         // Draw simplified levels when small
+
+static const float minLevelReduction = 0.8f;                                             // A level must keep at most this share of the previous one
+static const float maxCollapseNormalDot = 0.25f;                                         // Collapses may not turn a face further than ~75 degrees
+static const size_t minClusterTriangles = 32768;                                         // Batches are only split into clusters at least this large
+
+// Sum of squared distances to a set of weighted planes: Q(p) = p^T A p + 2 b^T p + c
+struct Quadric {
+    double a00, a01, a02, a11, a12, a22;                                                 // Symmetric A = sum(w n n^T)
+    double b0, b1, b2;                                                                   // b = sum(w d n)
+    double c;                                                                            // c = sum(w d^2)
+    double weight;                                                                       // Sum of the plane weights
+};
+
+// Add the plane n . p + d = 0 with weight w
+static void addPlane(Quadric& q, const double n[3], double d, double w) {
+    q.a00 += w * n[0] * n[0]; q.a01 += w * n[0] * n[1]; q.a02 += w * n[0] * n[2];
+    q.a11 += w * n[1] * n[1]; q.a12 += w * n[1] * n[2]; q.a22 += w * n[2] * n[2];
+    q.b0 += w * d * n[0]; q.b1 += w * d * n[1]; q.b2 += w * d * n[2];
+    q.c += w * d * d;
+    q.weight += w;
+}
+
+static void addQuadric(Quadric& q, const Quadric& other) {
+    q.a00 += other.a00; q.a01 += other.a01; q.a02 += other.a02;
+    q.a11 += other.a11; q.a12 += other.a12; q.a22 += other.a22;
+    q.b0 += other.b0; q.b1 += other.b1; q.b2 += other.b2;
+    q.c += other.c;
+    q.weight += other.weight;
+}
+
+// Q(p), clamped at 0 against rounding
+static double quadricError(const Quadric& q, const float p[3]) {
+    double x = p[0], y = p[1], z = p[2];
+    double error = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z + 2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z) +
+        2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+    return std::max(0.0, error);
+}
+
+// Unnormalized normal of the triangle (a, b, c)
+static inline void faceNormal(const float* a, const float* b, const float* c, double normal[3]) {
+    double ab[3] = { (double)b[0] - a[0], (double)b[1] - a[1], (double)b[2] - a[2] };
+    double ac[3] = { (double)c[0] - a[0], (double)c[1] - a[1], (double)c[2] - a[2] };
+    normal[0] = ab[1] * ac[2] - ab[2] * ac[1];
+    normal[1] = ab[2] * ac[0] - ab[0] * ac[2];
+    normal[2] = ab[0] * ac[1] - ab[1] * ac[0];
+}
+
+// Candidate half-edge collapse: vertex from moves onto vertex to
+struct Collapse {
+    float cost;                                                                          // Quadric error at the target
+    uint32_t from, to;                                                                   // Local vertex ids
+};
+
+// Simplification state of one batch; vertices are numbered locally and keep their quadrics across levels
+class BatchSimplifier {
+public:
+    BatchSimplifier(const std::vector<MeshVertex>& meshVertices, const std::vector<uint8_t>& seamVertex, const uint32_t* indices, size_t indexCount)
+        : meshVertices(meshVertices) {
+        meshIds.assign(indices, indices + indexCount);
+        std::sort(meshIds.begin(), meshIds.end());
+        meshIds.erase(std::unique(meshIds.begin(), meshIds.end()), meshIds.end());
+        triangles.resize(indexCount);
+        for (size_t i = 0; i < indexCount; i++) {
+            triangles[i] = (uint32_t)(std::lower_bound(meshIds.begin(), meshIds.end(), indices[i]) - meshIds.begin());
+        }
+
+        // Seams and open or non-manifold edges are locked: moving them would tear the surface
+        locked.assign(meshIds.size(), 0);
+        for (size_t v = 0; v < meshIds.size(); v++) locked[v] = seamVertex[meshIds[v]];
+        std::vector<uint64_t> edges;                                                     // Undirected edges, smaller id in the high half
+        edges.reserve(indexCount);
+        for (size_t t = 0; t < indexCount / 3; t++) {
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t a = triangles[t * 3 + corner], b = triangles[t * 3 + (corner + 1) % 3];
+                edges.push_back(((uint64_t)std::min(a, b) << 32) | std::max(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size();) {
+            size_t end = i;
+            while (end < edges.size() && edges[end] == edges[i]) end++;
+            if (end - i != 2) {                                                          // Border or shared by more than two faces
+                locked[(uint32_t)(edges[i] >> 32)] = 1;
+                locked[(uint32_t)edges[i]] = 1;
+            }
+            i = end;
+        }
+
+        // Area-weighted planes of the full-detail faces
+        quadrics.assign(meshIds.size(), Quadric{});
+        for (size_t t = 0; t < indexCount / 3; t++) {
+            double normal[3];
+            faceNormal(position(triangles[t * 3]), position(triangles[t * 3 + 1]), position(triangles[t * 3 + 2]), normal);
+            double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if (length <= 0.0) continue;
+            for (double& component : normal) component /= length;
+            const float* p = position(triangles[t * 3]);
+            double d = -(normal[0] * p[0] + normal[1] * p[1] + normal[2] * p[2]);
+            for (int corner = 0; corner < 3; corner++) addPlane(quadrics[triangles[t * 3 + corner]], normal, d, length * 0.5);
+        }
+    }
+
+    // Collapse edges until at most targetTriangles remain or no collapse is allowed
+    void simplify(size_t targetTriangles) {
+        while (triangles.size() / 3 > targetTriangles) {
+            if (!collapsePass(triangles.size() / 3 - targetTriangles)) break;
+        }
+    }
+
+    // Current triangles as meshVertices indices
+    void appendIndices(std::vector<uint32_t>& out) const {
+        for (uint32_t local : triangles) out.push_back(meshIds[local]);
+    }
+    size_t triangleCount() const { return triangles.size() / 3; }
+    float error() const { return largestError; }
+
+private:
+    const float* position(uint32_t local) const { return meshVertices[meshIds[local]].position; }
+
+    // One pass: sort all candidate collapses by cost and apply the cheapest ones that do not touch a
+    // vertex already changed in this pass (so every check sees current triangles). Returns false when
+    // nothing could be collapsed.
+    bool collapsePass(size_t excessTriangles) {
+        const size_t vertexCount = meshIds.size();
+        const size_t triangleTotal = triangles.size() / 3;
+        firstTriangle.assign(vertexCount + 1, 0);                                        // Triangles around every vertex (compressed rows)
+        for (uint32_t v : triangles) firstTriangle[v + 1]++;
+        for (size_t v = 0; v < vertexCount; v++) firstTriangle[v + 1] += firstTriangle[v];
+        vertexTriangles.resize(triangles.size());
+        std::vector<uint32_t> writePosition(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (size_t i = 0; i < triangles.size(); i++) vertexTriangles[writePosition[triangles[i]]++] = (uint32_t)(i / 3);
+
+        candidates.clear();
+        for (size_t t = 0; t < triangleTotal; t++) {
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t a = triangles[t * 3 + corner], b = triangles[t * 3 + (corner + 1) % 3];
+                if (!locked[a]) candidates.push_back({ collapseCost(a, b), a, b });
+                if (!locked[b]) candidates.push_back({ collapseCost(b, a), b, a });
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        touched.assign(vertexCount, 0);
+        linkMark.assign(vertexCount, 0);
+        linkStamp = 0;
+        size_t removed = 0;                                                              // Faces removed so far (two per interior collapse)
+        bool collapsed = false;
+        for (const Collapse& collapse : candidates) {
+            if (removed >= excessTriangles) break;
+            if (touched[collapse.from] || touched[collapse.to]) continue;
+            if (!collapseKeepsManifold(collapse.from, collapse.to) || !collapseKeepsFaces(collapse.from, collapse.to)) continue;
+            for (uint32_t i = firstTriangle[collapse.from]; i < firstTriangle[collapse.from + 1]; i++) {
+                uint32_t* corners = &triangles[vertexTriangles[i] * 3];
+                bool shared = corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to;
+                removed += shared;
+                for (int corner = 0; corner < 3; corner++) {
+                    touched[corners[corner]] = 1;                                        // Their faces changed
+                    if (corners[corner] == collapse.from) corners[corner] = collapse.to;
+                }
+            }
+            Quadric& target = quadrics[collapse.to];
+            const Quadric& source = quadrics[collapse.from];
+            double weight = target.weight + source.weight;
+            if (weight > 0.0) largestError = std::max(largestError, (float)sqrt(collapse.cost / weight));
+            addQuadric(target, source);
+            collapsed = true;
+        }
+
+        size_t kept = 0;                                                                 // Drop faces that lost a corner
+        for (size_t t = 0; t < triangleTotal; t++) {
+            const uint32_t* corners = &triangles[t * 3];
+            if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0]) continue;
+            memmove(&triangles[kept * 3], corners, 3 * sizeof(uint32_t));
+            kept++;
+        }
+        triangles.resize(kept * 3);
+        return collapsed;
+    }
+
+    // Error of the merged quadrics at the target position
+    float collapseCost(uint32_t from, uint32_t to) const {
+        Quadric merged = quadrics[from];
+        addQuadric(merged, quadrics[to]);
+        return (float)quadricError(merged, position(to));
+    }
+
+    // Link condition: an edge whose endpoints share more than the two vertices opposite it would fold two
+    // faces onto each other and leave a non-manifold fin
+    bool collapseKeepsManifold(uint32_t from, uint32_t to) {
+        linkStamp += 2;                                                                  // linkStamp marks a neighbour of from, + 1 one already counted
+        for (uint32_t i = firstTriangle[from]; i < firstTriangle[from + 1]; i++) {
+            const uint32_t* corners = &triangles[vertexTriangles[i] * 3];
+            for (int corner = 0; corner < 3; corner++) linkMark[corners[corner]] = linkStamp;
+        }
+        size_t sharedCount = 0;                                                          // Neighbours of both endpoints
+        for (uint32_t i = firstTriangle[to]; i < firstTriangle[to + 1]; i++) {
+            const uint32_t* corners = &triangles[vertexTriangles[i] * 3];
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t v = corners[corner];
+                if (v == from || v == to || linkMark[v] != linkStamp) continue;
+                linkMark[v] = linkStamp + 1;
+                if (++sharedCount > 2) return false;
+            }
+        }
+        return true;
+    }
+
+    // False when moving from onto to would flip or collapse one of the faces that survive
+    bool collapseKeepsFaces(uint32_t from, uint32_t to) const {
+        for (uint32_t i = firstTriangle[from]; i < firstTriangle[from + 1]; i++) {
+            const uint32_t* corners = &triangles[vertexTriangles[i] * 3];
+            if (corners[0] == to || corners[1] == to || corners[2] == to) continue;      // Removed by the collapse
+            const float* before[3];
+            const float* after[3];
+            for (int corner = 0; corner < 3; corner++) {
+                before[corner] = position(corners[corner]);
+                after[corner] = position(corners[corner] == from ? to : corners[corner]);
+            }
+            double oldNormal[3], newNormal[3];
+            faceNormal(before[0], before[1], before[2], oldNormal);
+            faceNormal(after[0], after[1], after[2], newNormal);
+            double dot = oldNormal[0] * newNormal[0] + oldNormal[1] * newNormal[1] + oldNormal[2] * newNormal[2];
+            double lengths = sqrt((oldNormal[0] * oldNormal[0] + oldNormal[1] * oldNormal[1] + oldNormal[2] * oldNormal[2]) *
+                (newNormal[0] * newNormal[0] + newNormal[1] * newNormal[1] + newNormal[2] * newNormal[2]));
+            if (lengths <= 0.0 || dot < maxCollapseNormalDot * lengths) return false;
+        }
+        return true;
+    }
+
+    const std::vector<MeshVertex>& meshVertices;
+    std::vector<uint32_t> meshIds;                                                       // meshVertices index of every local vertex
+    std::vector<uint32_t> triangles;                                                     // Current faces as local ids
+    std::vector<uint8_t> locked;                                                         // Vertex may not move
+    std::vector<Quadric> quadrics;                                                       // Planes gathered by every vertex
+    std::vector<uint32_t> firstTriangle, vertexTriangles;                                // Faces around every vertex (per pass)
+    std::vector<Collapse> candidates;                                                    // Collapses of the current pass
+    std::vector<uint8_t> touched;                                                        // Vertex changed in the current pass
+    std::vector<uint32_t> linkMark;                                                      // Link condition marks (per pass)
+    uint32_t linkStamp = 0;                                                              // Current link condition mark
+    float largestError = 0.0f;                                                           // Largest collapse error so far
+};
+
+// Mark the vertices that share their position with another vertex (normal or texture coordinate seams)
+static std::vector<uint8_t> findSeamVertices(const std::vector<MeshVertex>& meshVertices) {
+    std::vector<uint32_t> order(meshVertices.size());
+    for (uint32_t i = 0; i < (uint32_t)order.size(); i++) order[i] = i;
+    auto less = [&](uint32_t a, uint32_t b) {
+        const float* p = meshVertices[a].position;
+        const float* q = meshVertices[b].position;
+        return p[0] != q[0] ? p[0] < q[0] : p[1] != q[1] ? p[1] < q[1] : p[2] < q[2];
+    };
+    std::sort(order.begin(), order.end(), less);
+    std::vector<uint8_t> seam(meshVertices.size(), 0);
+    for (size_t i = 1; i < order.size(); i++) {
+        if (!less(order[i - 1], order[i])) seam[order[i - 1]] = seam[order[i]] = 1;      // Same position
+    }
+    return seam;
+}
+
+// Split meshlet ids into pieces of about equal count by halving along the longest axis of their centers
+static void splitMeshlets(const std::vector<Meshlet>& meshlets, uint32_t* ids, size_t count, size_t pieces,
+    std::vector<size_t>& outPieceEnds, size_t base) {
+    if (pieces <= 1 || count <= 1) {
+        outPieceEnds.push_back(base + count);
+        return;
+    }
+    float low[3] = { INFINITY, INFINITY, INFINITY }, high[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (size_t i = 0; i < count; i++) {
+        for (int k = 0; k < 3; k++) {
+            low[k] = std::min(low[k], meshlets[ids[i]].center[k]);
+            high[k] = std::max(high[k], meshlets[ids[i]].center[k]);
+        }
+    }
+    int axis = 0;                                                                        // Longest extent of the centers
+    for (int k = 1; k < 3; k++) if (high[k] - low[k] > high[axis] - low[axis]) axis = k;
+    size_t leftPieces = pieces / 2;
+    size_t middle = count * leftPieces / pieces;                                         // Meshlets shared out in proportion
+    std::nth_element(ids, ids + middle, ids + count, [&](uint32_t a, uint32_t b) { return meshlets[a].center[axis] < meshlets[b].center[axis]; });
+    splitMeshlets(meshlets, ids, middle, leftPieces, outPieceEnds, base);
+    splitMeshlets(meshlets, ids + middle, count - middle, pieces - leftPieces, outPieceEnds, base + middle);
+}
+
+// Part of a batch simplified on its own; its borders with the rest of the batch stay locked
+struct LodCluster {
+    const uint32_t* indices;                                                             // Triangles of the cluster
+    size_t indexCount;                                                                   // Number of indices
+};
+
+void buildMeshLods(const std::vector<MeshVertex>& meshVertices, std::vector<uint32_t>& indices,
+    std::vector<MeshBatch>& batches, const std::vector<Meshlet>& meshlets, ThreadPool& pool, std::vector<MeshLod>& outLods) {
+    const uint32_t batchCount = (uint32_t)batches.size();
+    outLods.assign(1, MeshLod{ 0, batchCount, 0, (uint32_t)indices.size(), 0.0f });
+    if (indices.empty()) return;
+
+    // Split large batches into spatially compact groups of meshlets, so a model with few batches still
+    // keeps every thread busy. Each batch gets a share of the threads in proportion to its triangles.
+    std::vector<std::vector<uint32_t>> clusterIndices(batchCount);                       // Batch triangles regrouped by cluster (split batches only)
+    std::vector<LodCluster> clusters;
+    std::vector<uint32_t> firstCluster(batchCount + 1, 0);                               // Clusters of batch b: [firstCluster[b], firstCluster[b + 1])
+    for (uint32_t b = 0; b < batchCount; b++) {
+        const MeshBatch& batch = batches[b];
+        firstCluster[b] = (uint32_t)clusters.size();
+        size_t triangleCount = batch.indexCount / 3;
+        size_t pieces = std::min((size_t)((double)batch.indexCount * pool.threadCount() / indices.size() + 0.5), triangleCount / minClusterTriangles);
+        if (pieces < 2 || batch.meshletCount < 2) {
+            clusters.push_back({ indices.data() + batch.firstIndex, batch.indexCount });
+            continue;
+        }
+        std::vector<uint32_t> ids(batch.meshletCount);
+        for (uint32_t i = 0; i < batch.meshletCount; i++) ids[i] = batch.firstMeshlet + i;
+        std::vector<size_t> pieceEnds;                                                   // End of every piece in ids
+        splitMeshlets(meshlets, ids.data(), ids.size(), pieces, pieceEnds, 0);
+        std::vector<uint32_t>& regrouped = clusterIndices[b];
+        regrouped.reserve(batch.indexCount);
+        std::vector<size_t> clusterStarts;
+        size_t start = 0;
+        for (size_t end : pieceEnds) {
+            clusterStarts.push_back(regrouped.size());
+            for (size_t i = start; i < end; i++) {
+                const Meshlet& meshlet = meshlets[ids[i]];
+                regrouped.insert(regrouped.end(), indices.begin() + meshlet.firstIndex, indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+            }
+            start = end;
+        }
+        clusterStarts.push_back(regrouped.size());
+        for (size_t i = 0; i + 1 < clusterStarts.size(); i++) {
+            clusters.push_back({ regrouped.data() + clusterStarts[i], clusterStarts[i + 1] - clusterStarts[i] });
+        }
+    }
+    firstCluster[batchCount] = (uint32_t)clusters.size();
+
+    // Simplify every cluster through all levels; level k keeps about half the faces of level k - 1
+    std::vector<uint8_t> seamVertex = findSeamVertices(meshVertices);
+    std::vector<std::vector<uint32_t>> levelIndices(clusters.size() * meshLodMaxLevels); // [cluster * levels + level - 1]
+    std::vector<float> levelErrors(clusters.size() * meshLodMaxLevels, 0.0f);
+    pool.parallelFor(clusters.size(), [&](size_t c) {
+        BatchSimplifier simplifier(meshVertices, seamVertex, clusters[c].indices, clusters[c].indexCount);
+        size_t target = clusters[c].indexCount / 3;
+        for (int level = 0; level < meshLodMaxLevels; level++) {
+            target /= 2;
+            simplifier.simplify(target);
+            simplifier.appendIndices(levelIndices[c * meshLodMaxLevels + level]);
+            levelErrors[c * meshLodMaxLevels + level] = simplifier.error();
+        }
+    });
+
+    // Append the levels that still remove enough faces, each as one batch per full-detail batch
+    size_t previousIndexCount = indices.size();
+    for (int level = 0; level < meshLodMaxLevels; level++) {
+        size_t levelIndexCount = 0;
+        for (size_t c = 0; c < clusters.size(); c++) levelIndexCount += levelIndices[c * meshLodMaxLevels + level].size();
+        if (levelIndexCount > previousIndexCount * minLevelReduction) break;             // Simplification has stalled
+        MeshLod lod = { (uint32_t)batches.size(), batchCount, (uint32_t)indices.size(), (uint32_t)levelIndexCount, outLods.back().error };
+        for (uint32_t b = 0; b < batchCount; b++) {
+            MeshBatch batch = batches[b];
+            batch.firstIndex = (uint32_t)indices.size();
+            for (uint32_t c = firstCluster[b]; c < firstCluster[b + 1]; c++) {
+                const std::vector<uint32_t>& source = levelIndices[c * meshLodMaxLevels + level];
+                indices.insert(indices.end(), source.begin(), source.end());
+                lod.error = std::max(lod.error, levelErrors[c * meshLodMaxLevels + level]);
+            }
+            batch.indexCount = (uint32_t)indices.size() - batch.firstIndex;
+            batch.firstMeshlet = batch.meshletCount = 0;                                 // Drawn whole
+            batches.push_back(batch);
+        }
+        outLods.push_back(lod);
+        previousIndexCount = levelIndexCount;
+    }
+}
+
+// Distance from a point to the nearest point of a box (0 inside)
+static float distanceToBounds(const Bounds& bounds, const float point[3]) {
+    float squared = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        float outside = std::max(bounds.min[k] - point[k], std::max(0.0f, point[k] - bounds.max[k]));
+        squared += outside * outside;
+    }
+    return sqrtf(squared);
+}
+
+void selectSubmeshLods(const float eye[3], std::vector<uint8_t>& levels) {
+    static uint32_t levelsVersion = 0;                                                   // modelVersion the levels were chosen for
+    if (levels.size() != submeshes.size() || levelsVersion != modelVersion) {
+        levels.assign(submeshes.size(), 0);
+        levelsVersion = modelVersion;
+    }
+    if (!lodSelectionEnabled || meshLods.size() < 2) {
+        std::fill(levels.begin(), levels.end(), 0);
+        return;
+    }
+
+    // Pixels per model unit at distance 1 (the eye and bounds are in model space, so the scale cancels)
+    const float pixelsPerUnit = windowHeight * 0.5f / tanf(cameraFieldOfView * 0.5f * 3.14159265f / 180.0f);
+    const uint8_t coarsest = (uint8_t)(meshLods.size() - 1);
+    for (size_t s = 0; s < submeshes.size(); s++) {
+        float distance = distanceToBounds(submeshes[s].bounds, eye);
+        if (distance <= 0.0f) {                                                          // Eye inside the bounds
+            levels[s] = 0;
+            continue;
+        }
+        float pixelsPerError = pixelsPerUnit / distance;                                 // Projected size of one unit of error
+        uint8_t level = std::min(levels[s], coarsest);
+        while (level > 0 && meshLods[level].error * pixelsPerError > lodMaxPixelError) level--;
+        while (level < coarsest && meshLods[level + 1].error * pixelsPerError <= lodMaxPixelError * lodHysteresis) level++;
+        levels[s] = level;
+    }
+}
+
+// Toggle level of detail selection
+void toggleLodSelection() {
+    lodSelectionEnabled = !lodSelectionEnabled;
+    printf("Level of detail selection: %s\n", lodSelectionEnabled ? "on" : "off");
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include "ModelLoader.h"
+
+class ThreadPool;
+
+// Append up to meshLodMaxLevels simplified levels to the mesh. Each batch (large ones split into clusters
+// of neighbouring meshlets) is simplified on its own, in parallel, by quadric-error half-edge collapses,
+// halving its triangles per level; vertices only move onto existing vertices, so every level indexes the
+// same meshVertices. Vertices on batch and cluster borders and attribute seams stay put, so the pieces still
+// meet. A level that removes too little ends the chain. outLods[0] always describes the full mesh.
+void buildMeshLods(const std::vector<MeshVertex>& meshVertices, std::vector<uint32_t>& indices,
+    std::vector<MeshBatch>& batches, const std::vector<Meshlet>& meshlets, ThreadPool& pool, std::vector<MeshLod>& outLods);
+
+// Choose the level of every submesh for an eye at the given model-space position: the coarsest level
+// whose error projects to at most lodMaxPixelError pixels at the nearest point of the submesh bounds,
+// using the camera's field of view and the window height. A submesh only moves to a coarser level once
+// that level's error is below lodHysteresis of the limit, so it does not flip between levels at the
+// boundary. levels keeps the choice between frames.
+void selectSubmeshLods(const float eye[3], std::vector<uint8_t>& levels);
+
+extern bool lodSelectionEnabled;                                                         // Draw simplified levels when small (toggled from the menu)
+void toggleLodSelection();                                                               // Toggle level of detail selection
+
+const int meshLodMaxLevels = 4;                                                          // Simplified levels beyond the full mesh at most
+const float lodMaxPixelError = 1.0f;                                                     // Largest projected error of a selected level
+const float lodHysteresis = 0.75f;                                                       // Fraction of the limit a coarser level must reach
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "LoaderArena.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <algorithm>
+#include <new>
+
+// Loader memory totals (arenas are used from several threads at once)
+static std::atomic<size_t> arenaBytes{ 0 };                                              // Bytes held by all arenas
+static std::atomic<size_t> containerBytes{ 0 };                                          // Model container bytes at the last checkpoint
+static std::atomic<size_t> peakBytes{ 0 };                                               // Largest total since tracking began
+
+// Raise the peak to the current total
+static void updatePeak() {
+    size_t total = arenaBytes + containerBytes;
+    size_t peak = peakBytes;
+    while (total > peak && !peakBytes.compare_exchange_weak(peak, total)) {}             // Another thread may raise it too
+}
+
+LoaderArena::LoaderArena(size_t blockSize)
+    : currentBlock(0), blockOffset(0), blockSize(blockSize), totalBytes(0) {
+}
+
+LoaderArena::~LoaderArena() {
+    release();
+}
+
+// Offset of the first aligned address at or after data + offset
+static inline size_t alignedOffset(const char* data, size_t offset, size_t alignment) {
+    uintptr_t address = ((uintptr_t)(data + offset) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    return (size_t)(address - (uintptr_t)data);
+}
+
+// Bump-allocate from the current block, moving to the next (or a new) block when it is full. Throws
+// std::bad_alloc like the containers it replaces, so callers never see a null pointer.
+void* LoaderArena::allocate(size_t bytes, size_t alignment) {
+    while (currentBlock < blocks.size()) {                                               // Reuse blocks kept by reset()
+        Block& block = blocks[currentBlock];
+        size_t offset = alignedOffset(block.data, blockOffset, alignment);               // Align within the block
+        if (offset + bytes <= block.size) {
+            blockOffset = offset + bytes;
+            return block.data + offset;
+        }
+        currentBlock++;                                                                  // Block is full, try the next one
+        blockOffset = 0;
+    }
+
+    size_t size = std::max(blockSize, bytes + alignment);                                // Large requests get their own block
+    char* data = (char*)malloc(size);
+    if (!data) throw std::bad_alloc();                                                   // Out of memory
+    blocks.push_back({ data, size });
+    totalBytes += size;
+    arenaBytes += size;
+    updatePeak();
+
+    currentBlock = blocks.size() - 1;
+    size_t offset = alignedOffset(data, 0, alignment);
+    blockOffset = offset + bytes;
+    return data + offset;
+}
+
+// Forget all allocations but keep the blocks
+void LoaderArena::reset() {
+    currentBlock = 0;
+    blockOffset = 0;
+}
+
+// Free all blocks
+void LoaderArena::release() {
+    for (Block& block : blocks) {
+        free(block.data);
+    }
+    arenaBytes -= totalBytes;
+    blocks.clear();
+    totalBytes = 0;
+    reset();
+}
+
+// Start a new measurement: containers are recounted at the next checkpoint
+void beginLoaderMemoryTracking() {
+    containerBytes = 0;
+    peakBytes = arenaBytes.load();
+}
+
+// Record the current size of the model containers and update the peak
+void checkpointLoaderMemory(size_t bytes) {
+    containerBytes = bytes;
+    updatePeak();
+}
+
+// Largest arena + container total since tracking began
+size_t loaderPeakBytes() {
+    return peakBytes;
+}
\ No newline at end of file
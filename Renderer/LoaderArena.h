@@ -0,0 +1,98 @@
+#pragma once
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+// Bump allocator for loader temporaries. Memory comes from large blocks that are freed together,
+// so temporaries never reallocate or copy; reset() keeps the blocks for the next load stage.
+// Only trivially copyable element types may be placed in an arena. Not thread-safe.
+class LoaderArena {
+public:
+    explicit LoaderArena(size_t blockSize = 1 << 20);                                    // Bytes per regular block
+    ~LoaderArena();
+
+    void* allocate(size_t bytes, size_t alignment = 16);                                 // Uninitialized, aligned memory (throws std::bad_alloc)
+    template <typename T>
+    T* allocateArray(size_t count) { return (T*)allocate(count * sizeof(T), alignof(T) > 16 ? alignof(T) : 16); }
+    void reset();                                                                        // Forget all allocations, keep the blocks
+    void release();                                                                      // Free all blocks
+
+    size_t reservedBytes() const { return totalBytes; }                                  // Bytes held in blocks
+
+private:
+    LoaderArena(const LoaderArena&) = delete;                                            // Arenas own their blocks
+    LoaderArena& operator=(const LoaderArena&) = delete;
+
+    struct Block {
+        char* data;                                                                      // Block memory
+        size_t size;                                                                     // Block size in bytes
+    };
+    std::vector<Block> blocks;                                                           // Blocks in allocation order
+    size_t currentBlock;                                                                 // Block that serves the next allocation
+    size_t blockOffset;                                                                  // Used bytes in the current block
+    size_t blockSize;                                                                    // Size of regular blocks
+    size_t totalBytes;                                                                   // Sum of all block sizes
+};
+
+// Append-only array stored as a list of arena segments that double in size. Growing never moves
+// existing elements, and the whole array is copied out once into its final container.
+template <typename T>
+class ArenaArray {
+public:
+    ArenaArray() : arena(nullptr), tail(nullptr), tailSize(0), tailCapacity(0), count(0) {}
+    explicit ArenaArray(LoaderArena& owner) : arena(&owner), tail(nullptr), tailSize(0), tailCapacity(0), count(0) {}
+
+    void push_back(const T& value) {
+        if (tailSize == tailCapacity) grow();                                            // Start a new segment
+        tail[tailSize++] = value;
+        count++;
+    }
+    size_t size() const { return count; }                                                // Number of elements
+    bool empty() const { return count == 0; }
+
+    // Copy all elements in order to out and return the position after the last one
+    T* copyTo(T* out) const {
+        for (const Segment& segment : segments) {
+            memcpy(out, segment.data, segment.size * sizeof(T));
+            out += segment.size;
+        }
+        if (tailSize) memcpy(out, tail, tailSize * sizeof(T));
+        return out + tailSize;
+    }
+
+    // Call f on every element in order
+    template <typename F>
+    void forEach(F f) const {
+        for (const Segment& segment : segments) {
+            for (size_t i = 0; i < segment.size; i++) f(segment.data[i]);
+        }
+        for (size_t i = 0; i < tailSize; i++) f(tail[i]);
+    }
+
+private:
+    struct Segment {
+        T* data;                                                                         // Full segment
+        size_t size;                                                                     // Elements in the segment
+    };
+
+    void grow() {
+        if (tail) segments.push_back({ tail, tailSize });                                // Retire the full segment
+        if (tailCapacity == 0) tailCapacity = 1024;                                      // First segment
+        else if (tailCapacity * sizeof(T) < (8 << 20)) tailCapacity *= 2;                // Double up to about 8 MB
+        tail = arena->allocateArray<T>(tailCapacity);
+        tailSize = 0;
+    }
+
+    LoaderArena* arena;                                                                  // Owner of the segments
+    std::vector<Segment> segments;                                                       // Full segments in order
+    T* tail;                                                                             // Segment being filled
+    size_t tailSize;                                                                     // Elements in the tail segment
+    size_t tailCapacity;                                                                 // Capacity of the tail segment
+    size_t count;                                                                        // Total number of elements
+};
+
+// Loader memory accounting. Arena blocks are counted as they are allocated and freed; model
+// containers are counted at checkpoints. The peak is the largest total seen since tracking began.
+void beginLoaderMemoryTracking();                                                        // Start a new measurement for one model
+void checkpointLoaderMemory(size_t containerBytes);                                      // Record the current size of the model containers
+size_t loaderPeakBytes();                                                                // Largest arena + container total since tracking began
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : fileData(nullptr), fileSize(0)
+#ifdef _WIN32
+    , fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+#else
+    , fileDescriptor(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();                                                                             // Release the mapping when going out of scope
+}
+
+#ifdef _WIN32
+// Map the whole file read-only using the Win32 file mapping API
+bool MappedFile::open(const char* filename) {
+    close();                                                                             // Drop any previous mapping
+
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {                                                  // Check if file opened successfully
+        return false;                                                                    // Return failure
+    }
+    fileHandle = file;                                                                   // Keep the handle until close()
+
+    LARGE_INTEGER length;                                                                // File size as a 64-bit value
+    if (!GetFileSizeEx(file, &length) || (unsigned long long)length.QuadPart > (size_t)-1) {
+        close();                                                                         // Size unknown or too large for this address space
+        return false;                                                                    // Return failure
+    }
+    fileSize = (size_t)length.QuadPart;                                                  // Store file size
+    if (fileSize == 0) {                                                                 // Empty files cannot be mapped but are valid
+        return true;                                                                     // Nothing to map
+    }
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);     // Create read-only mapping object
+    if (!mappingHandle) {                                                                // Check if mapping was created
+        close();                                                                         // Release file handle
+        return false;                                                                    // Return failure
+    }
+
+    fileData = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);        // Map the whole file
+    if (!fileData) {                                                                     // Check if view was mapped
+        close();                                                                         // Release handles
+        return false;                                                                    // Return failure
+    }
+    return true;                                                                         // Return success
+}
+
+// Unmap the view and close the Win32 handles
+void MappedFile::close() {
+    if (fileData) UnmapViewOfFile(fileData);                                             // Unmap the view
+    if (mappingHandle) CloseHandle(mappingHandle);                                       // Close mapping object
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);                     // Close file handle
+    fileData = nullptr;                                                                  // Reset view pointer
+    fileSize = 0;                                                                        // Reset size
+    mappingHandle = nullptr;                                                             // Reset mapping handle
+    fileHandle = INVALID_HANDLE_VALUE;                                                   // Reset file handle
+}
+#else
+// Map the whole file read-only using mmap
+bool MappedFile::open(const char* filename) {
+    close();                                                                             // Drop any previous mapping
+
+    fileDescriptor = ::open(filename, O_RDONLY);                                         // Open file for reading
+    if (fileDescriptor < 0) {                                                            // Check if file opened successfully
+        return false;                                                                    // Return failure
+    }
+
+    struct stat info;                                                                    // File metadata
+    if (fstat(fileDescriptor, &info) != 0) {                                             // Query file size
+        close();                                                                         // Release descriptor
+        return false;                                                                    // Return failure
+    }
+    fileSize = (size_t)info.st_size;                                                     // Store file size
+    if (fileSize == 0) {                                                                 // Empty files cannot be mapped but are valid
+        return true;                                                                     // Nothing to map
+    }
+
+    void* view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);     // Map the whole file
+    if (view == MAP_FAILED) {                                                            // Check if view was mapped
+        close();                                                                         // Release descriptor
+        return false;                                                                    // Return failure
+    }
+    madvise(view, fileSize, MADV_SEQUENTIAL);                                            // Hint that the file is read front to back
+    fileData = (const char*)view;                                                        // Store view pointer
+    return true;                                                                         // Return success
+}
+
+// Unmap the view and close the file descriptor
+void MappedFile::close() {
+    if (fileData) munmap((void*)fileData, fileSize);                                     // Unmap the view
+    if (fileDescriptor >= 0) ::close(fileDescriptor);                                    // Close file descriptor
+    fileData = nullptr;                                                                  // Reset view pointer
+    fileSize = 0;                                                                        // Reset size
+    fileDescriptor = -1;                                                                 // Reset descriptor
+}
+#endif
\ No newline at end of file
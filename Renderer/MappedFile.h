@@ -0,0 +1,28 @@
+#pragma once
+#include <stddef.h>
+
+// Read-only memory mapping of a whole file, used to parse model files in place
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const char* filename);                                                     // Map the file into memory (returns false on failure)
+    void close();                                                                        // Unmap the file and release its handles
+
+    const char* data() const { return fileData; }                                        // Start of the mapped bytes
+    size_t size() const { return fileSize; }                                             // Number of mapped bytes
+
+private:
+    MappedFile(const MappedFile&) = delete;                                              // Mappings are not copyable
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* fileData;                                                                // Start of the mapped view (null for empty files)
+    size_t fileSize;                                                                     // Size of the mapped view in bytes
+#ifdef _WIN32
+    void* fileHandle;                                                                    // Win32 file handle
+    void* mappingHandle;                                                                 // Win32 file mapping handle
+#else
+    int fileDescriptor;                                                                  // POSIX file descriptor
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "MeshBuffers.h"
+#include "ModelLoader.h"
+#include "GLExtensions.h"
+#include "VertexQuantization.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <chrono>
+
+// Buffer objects holding the welded mesh
+static GLuint vertexBuffer = 0;                                                          // meshVertices
+static GLuint indexBuffer = 0;                                                           // meshIndices
+static uint32_t uploadedVersion = 0;                                                     // modelVersion of the buffer contents
+static size_t uploadedBytes = 0;                                                         // Size of both buffers
+static bool uploadedQuantized = false;                                                   // Vertex buffer holds QuantizedVertex data
+static PositionDecode uploadedDecode = {};                                               // Position decode of the quantized vertices
+
+// Upload the welded mesh if the model changed since the last upload. A format change alone only
+// replaces the vertex buffer.
+bool updateMeshBuffers(bool quantized) {
+    if (!glHasBufferObjects) return false;                                               // Caller draws from client memory
+    bool indicesCurrent = vertexBuffer && uploadedVersion == modelVersion;
+    if (indicesCurrent && uploadedQuantized == quantized) return true;                   // Buffers are current
+
+    auto start = std::chrono::steady_clock::now();
+    if (!vertexBuffer) {
+        glGenBuffers(1, &vertexBuffer);
+        glGenBuffers(1, &indexBuffer);
+    }
+    size_t floatBytes = meshVertices.size() * sizeof(MeshVertex);
+    size_t vertexBytes = floatBytes;
+    size_t indexBytes = meshIndices.size() * sizeof(uint32_t);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    if (quantized) {
+        std::vector<QuantizedVertex> packed;                                             // Only the GPU keeps the quantized copy
+        QuantizationError error;
+        quantizeVertices(meshVertices, packed, uploadedDecode, error);
+        vertexBytes = packed.size() * sizeof(QuantizedVertex);
+        glBufferData(GL_ARRAY_BUFFER, (ptrdiff_t)vertexBytes, packed.data(), GL_STATIC_DRAW);
+        if (!packed.empty()) {
+            printf("Quantized %zu vertices: %.2f MB instead of %.2f MB, max error %.3g in positions (%.4f%% of the bounds), "
+                "%.3f degrees in normals, %.3g in texture coordinates\n", packed.size(), vertexBytes / (1024.0 * 1024.0),
+                floatBytes / (1024.0 * 1024.0), error.position, error.positionRelative * 100.0, error.normalDegrees, error.texCoord);
+        }
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, (ptrdiff_t)vertexBytes, meshVertices.data(), GL_STATIC_DRAW); // Replaces the old storage
+    }
+    if (!indicesCurrent) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (ptrdiff_t)indexBytes, meshIndices.data(), GL_STATIC_DRAW);
+    }
+    unbindMeshBuffers();
+    uploadedVersion = modelVersion;
+    uploadedQuantized = quantized;
+    uploadedBytes = vertexBytes + indexBytes;
+
+    if (uploadedBytes) {
+        printf("Uploaded mesh buffers: %.2f MB in %.1f ms%s\n", uploadedBytes / (1024.0 * 1024.0),
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+            quantized ? " (quantized vertices)" : "");
+    }
+    return true;
+}
+
+// Vertex buffer holds QuantizedVertex data
+bool meshBuffersQuantized() {
+    return uploadedQuantized;
+}
+
+// Attribute formats of the uploaded vertices: positions and normals of quantized vertices are
+// normalized integers, their texture coordinates half floats. vertexOffset locates vertex 0 in a buffer
+// other than the mesh buffer, such as the streamed vertices of the animation.
+void setMeshAttributePointers(size_t vertexOffset) {
+    const char* base = (const char*)vertexOffset;
+    if (uploadedQuantized) {
+        const GLsizei stride = sizeof(QuantizedVertex);
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (const void*)(base + offsetof(QuantizedVertex, position)));
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (const void*)(base + offsetof(QuantizedVertex, normal)));
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(QuantizedVertex, texCoord)));
+    }
+    else {
+        const GLsizei stride = sizeof(MeshVertex);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(MeshVertex, position)));
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(MeshVertex, normal)));
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(MeshVertex, texCoord)));
+    }
+}
+
+// Look up the decode uniforms once, so setting them per draw is free of string lookups
+MeshDecodeUniforms findMeshDecodeUniforms(unsigned program) {
+    MeshDecodeUniforms uniforms;
+    uniforms.positionOffset = glGetUniformLocation(program, "positionOffset");
+    uniforms.positionScale = glGetUniformLocation(program, "positionScale");
+    uniforms.octahedralNormals = glGetUniformLocation(program, "octahedralNormals");
+    return uniforms;
+}
+
+// Float vertices pass through decodePosition/decodeNormal unchanged
+void setMeshDecodeUniforms(const MeshDecodeUniforms& uniforms) {
+    static const PositionDecode identity = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+    const PositionDecode& decode = uploadedQuantized ? uploadedDecode : identity;
+    glUniform3fv(uniforms.positionOffset, 1, decode.offset);
+    glUniform3fv(uniforms.positionScale, 1, decode.scale);
+    glUniform1i(uniforms.octahedralNormals, uploadedQuantized ? 1 : 0);
+}
+
+// Bind the vertex and index buffers for drawing
+void bindMeshBuffers() {
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+}
+
+// Bind buffer 0 so pointers are client memory addresses again
+void unbindMeshBuffers() {
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// Delete the buffers (the next update re-creates them)
+void releaseMeshBuffers() {
+    if (!vertexBuffer) return;
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+    vertexBuffer = indexBuffer = 0;
+    uploadedBytes = 0;
+}
+
+// Name of the vertex buffer (0 before the first upload)
+unsigned meshVertexBuffer() {
+    return vertexBuffer;
+}
+
+// Bytes held in the GPU buffers
+size_t meshBufferBytes() {
+    return uploadedBytes;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include <stddef.h>
+
+// GPU copies of the welded mesh (meshVertices/meshIndices) in vertex and index buffer objects.
+// The buffers are uploaded once and only re-uploaded after modelVersion changes. The vertex buffer
+// holds either MeshVertex or QuantizedVertex data, re-uploaded when a caller asks for the other format.
+
+// Locations of the decode uniforms of meshVertexShaderHeader in one program (looked up once after linking)
+struct MeshDecodeUniforms {
+    int positionOffset;                                                                  // vec3 positionOffset
+    int positionScale;                                                                   // vec3 positionScale
+    int octahedralNormals;                                                               // bool octahedralNormals
+};
+
+bool updateMeshBuffers(bool quantized);                                                  // Upload the welded mesh if it changed; false without buffer objects
+bool meshBuffersQuantized();                                                             // Vertex buffer holds QuantizedVertex data
+void setMeshAttributePointers(size_t vertexOffset = 0);                                  // Point generic attributes 0-2 at the bound vertex buffer, from byte vertexOffset
+
+MeshDecodeUniforms findMeshDecodeUniforms(unsigned program);                             // Look up the decode uniforms of a linked program
+void setMeshDecodeUniforms(const MeshDecodeUniforms& uniforms);                          // Set them for the buffer format (program in use)
+void bindMeshBuffers();                                                                  // Bind the vertex and index buffers
+void unbindMeshBuffers();                                                                // Bind buffer 0 so client pointers work again
+void releaseMeshBuffers();                                                               // Delete the buffers
+size_t meshBufferBytes();                                                                // Bytes held in the GPU buffers
+unsigned meshVertexBuffer();                                                             // Name of the vertex buffer (0 before the first upload)
\ No newline at end of file
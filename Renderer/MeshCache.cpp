@@ -0,0 +1,287 @@
+#include "MeshCache.h"
+#include "ModelLoader.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <algorithm>
+
+// Sidecar layout: header, section table, then 16-byte aligned section payloads
+static const char meshCacheMagic[8] = { 'R', 'M', 'E', 'S', 'H', 'C', 'A', 'C' };        // File signature
+static const uint32_t meshCacheVersion = 11;                                             // Bump whenever stored data changes meaning
+
+struct MeshCacheHeader {
+    char magic[8];                                                                       // meshCacheMagic
+    uint32_t version;                                                                    // meshCacheVersion
+    uint32_t sectionCount;                                                               // Entries in the section table
+    uint64_t sourceSize;                                                                 // Size of the source file in bytes
+    uint64_t sourceHash;                                                                 // hashFileContents of the source file
+    uint64_t materialHash;                                                               // hashMaterialLibraries of the MTL files it references
+};
+
+struct MeshCacheSection {
+    uint32_t tag;                                                                        // Section identifier (four characters)
+    uint32_t elementSize;                                                                // sizeof one element, guards against layout changes
+    uint64_t offset;                                                                     // Payload offset from the start of the file
+    uint64_t count;                                                                      // Number of elements
+};
+
+// Build a four character section tag
+static constexpr uint32_t sectionTag(char a, char b, char c, char d) {
+    return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+}
+
+// Path of the sidecar for a source file
+static std::string meshCachePath(const char* sourceFilename) {
+    return std::string(sourceFilename) + ".meshcache";
+}
+
+// 64-bit mixing step (multiply-xorshift)
+static inline uint64_t mixHash(uint64_t hash, uint64_t value) {
+    hash ^= value * 0x9E3779B97F4A7C15ull;                                               // Spread input bits
+    hash = (hash << 31) | (hash >> 33);                                                  // Rotate
+    return hash * 0xC2B2AE3D27D4EB4Full;                                                 // Scramble
+}
+
+// Hash one block with four independent lanes so the loop is not latency bound
+static uint64_t hashBlock(const char* data, size_t size, uint64_t seed) {
+    uint64_t lanes[4] = { seed, seed + 1, seed + 2, seed + 3 };                          // Independent accumulators
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {                                                    // 32 bytes per iteration
+        for (int lane = 0; lane < 4; lane++) {
+            uint64_t word;
+            memcpy(&word, data + i + lane * 8, 8);
+            lanes[lane] = mixHash(lanes[lane], word);
+        }
+    }
+    uint64_t hash = mixHash(mixHash(lanes[0], lanes[1]), mixHash(lanes[2], lanes[3]));   // Fold lanes
+    for (; i < size; i++) {                                                              // Tail bytes
+        hash = mixHash(hash, (unsigned char)data[i]);
+    }
+    return mixHash(hash, size);                                                          // Include length
+}
+
+// Fast 64-bit hash of a byte range: fixed-size blocks are hashed in parallel and combined in order
+uint64_t hashFileContents(const char* data, size_t size) {
+    const size_t blockSize = 4 << 20;                                                    // Independent of thread count, so hashes are stable
+    size_t blockCount = (size + blockSize - 1) / blockSize;                              // Number of blocks
+    std::vector<uint64_t> blockHashes(blockCount);                                       // Hash of every block
+    sharedThreadPool().parallelFor(blockCount, [&](size_t i) {
+        size_t start = i * blockSize;
+        blockHashes[i] = hashBlock(data + start, std::min(blockSize, size - start), i);
+    });
+
+    uint64_t hash = 0x84222325CBF29CE4ull;                                               // Arbitrary non-zero start
+    for (uint64_t blockHash : blockHashes) {
+        hash = mixHash(hash, blockHash);                                                 // Combine in file order
+    }
+    return mixHash(hash, size);
+}
+
+// Hash the contents of the MTL libraries (NUL-terminated paths) so edits to them invalidate the sidecar
+static uint64_t hashMaterialLibraries(const std::vector<char>& libraryPaths) {
+    uint64_t hash = 0x6A09E667F3BCC908ull;                                               // Arbitrary non-zero start
+    for (size_t i = 0; i < libraryPaths.size(); i += strlen(&libraryPaths[i]) + 1) {
+        MappedFile library;                                                              // Libraries are small, mapped one at a time
+        if (library.open(&libraryPaths[i])) {
+            hash = mixHash(mixHash(hash, 1), hashFileContents(library.data(), library.size()));
+        } else {
+            hash = mixHash(hash, 0);                                                     // Missing library, so creating it invalidates too
+        }
+    }
+    return hash;
+}
+
+// Validate a section against the mapped sidecar and copy its elements into a container
+template <typename T>
+static bool readSection(const MappedFile& file, const MeshCacheSection* sections, uint32_t sectionCount,
+    uint32_t tag, std::vector<T>& out) {
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        const MeshCacheSection& section = sections[i];
+        if (section.tag != tag) continue;
+        if (section.elementSize != sizeof(T)) return false;                              // Stored with a different struct layout
+        if (section.offset > file.size() || section.count > (file.size() - section.offset) / sizeof(T)) {
+            return false;                                                                // Truncated or corrupt sidecar
+        }
+        out.resize((size_t)section.count);                                               // Size container exactly once
+        if (section.count) memcpy(out.data(), file.data() + section.offset, (size_t)section.count * sizeof(T));
+        return true;
+    }
+    return false;                                                                        // Section missing
+}
+
+// Map a sidecar written for a source of this size whose MTL libraries are unchanged, and read its section table
+static bool openMeshCache(const char* sourceFilename, uint64_t sourceSize, MappedFile& file,
+    MeshCacheHeader& header, std::vector<MeshCacheSection>& sections) {
+    if (!file.open(meshCachePath(sourceFilename).c_str())) {
+        return false;                                                                    // No sidecar yet
+    }
+    if (file.size() < sizeof(MeshCacheHeader)) return false;                             // Too small to be valid
+
+    memcpy(&header, file.data(), sizeof(header));                                        // Copy out to avoid unaligned access
+    if (memcmp(header.magic, meshCacheMagic, sizeof(meshCacheMagic)) != 0 ||
+        header.version != meshCacheVersion || header.sourceSize != sourceSize) {
+        return false;                                                                    // Stale or foreign sidecar
+    }
+    if (header.sectionCount > (file.size() - sizeof(header)) / sizeof(MeshCacheSection)) {
+        return false;                                                                    // Corrupt section table
+    }
+    sections.resize(header.sectionCount);                                                // Section table
+    memcpy(sections.data(), file.data() + sizeof(header), sections.size() * sizeof(MeshCacheSection));
+
+    std::vector<char> libraryPaths;                                                      // MTL files the cached materials came from
+    return readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'L', 'I', 'B'), libraryPaths) &&
+        hashMaterialLibraries(libraryPaths) == header.materialHash;                      // An edited .mtl means the materials are stale
+}
+
+// Check for a sidecar written for a source of this size and return the source hash it records
+bool findMeshCache(const char* sourceFilename, uint64_t sourceSize, uint64_t& storedHash) {
+    MappedFile file;                                                                     // Sidecar mapping
+    MeshCacheHeader header;                                                              // Sidecar header
+    std::vector<MeshCacheSection> sections;                                              // Section table
+    if (!openMeshCache(sourceFilename, sourceSize, file, header, sections)) return false;
+    storedHash = header.sourceHash;                                                      // Caller compares against the real hash
+    return true;
+}
+
+// Fill the model containers from the sidecar if it was written for this exact source. Every section is
+// read into a local container first, so a truncated or corrupt sidecar leaves the current model untouched.
+bool loadMeshCache(const char* sourceFilename, uint64_t sourceHash, uint64_t sourceSize) {
+    MappedFile file;                                                                     // Sidecar mapping
+    MeshCacheHeader header;                                                              // Sidecar header
+    std::vector<MeshCacheSection> sections;                                              // Section table
+    if (!openMeshCache(sourceFilename, sourceSize, file, header, sections) || header.sourceHash != sourceHash) {
+        return false;                                                                    // Stale or foreign sidecar
+    }
+
+    std::vector<Vertex> cachedVertices;                                                  // Sections, swapped in once all are valid
+    std::vector<TextureCoord> cachedTextureCoords;
+    std::vector<Normal> cachedNormals;
+    std::vector<Face> cachedFaces;
+    std::vector<Bounds> bounds;                                                          // Single stored bounds entry
+    std::vector<MeshVertex> cachedMeshVertices;
+    std::vector<uint32_t> cachedMeshIndices;
+    std::vector<Material> cachedMaterials;
+    std::vector<MaterialRun> cachedMaterialRuns;
+    std::vector<char> cachedLibraryPaths;
+    std::vector<MeshBatch> cachedBatches;
+    std::vector<Submesh> cachedSubmeshes;
+    std::vector<SubmeshRun> cachedSubmeshRuns;
+    std::vector<Meshlet> cachedMeshlets;
+    std::vector<MeshLod> cachedLods;
+    bool complete =
+        readSection(file, sections.data(), header.sectionCount, sectionTag('V', 'E', 'R', 'T'), cachedVertices) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('T', 'E', 'X', 'C'), cachedTextureCoords) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('N', 'O', 'R', 'M'), cachedNormals) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('F', 'A', 'C', 'E'), cachedFaces) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('B', 'N', 'D', 'S'), bounds) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'V', 'T', 'X'), cachedMeshVertices) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'I', 'D', 'X'), cachedMeshIndices) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'A', 'T', 'L'), cachedMaterials) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'R', 'U', 'N'), cachedMaterialRuns) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'L', 'I', 'B'), cachedLibraryPaths) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'B', 'A', 'T'), cachedBatches) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('S', 'U', 'B', 'M'), cachedSubmeshes) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('S', 'R', 'U', 'N'), cachedSubmeshRuns) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'L', 'E', 'T'), cachedMeshlets) &&
+        readSection(file, sections.data(), header.sectionCount, sectionTag('M', 'L', 'O', 'D'), cachedLods) &&
+        bounds.size() == 1 && !cachedVertices.empty() && !cachedTextureCoords.empty() && !cachedNormals.empty() &&
+        !cachedMaterials.empty() && !cachedSubmeshes.empty() && !cachedLods.empty();
+    if (!complete) {
+        return false;                                                                    // Caller reloads from the source
+    }
+
+    vertices.swap(cachedVertices);                                                       // The old model is released with the locals
+    textureCoords.swap(cachedTextureCoords);
+    normals.swap(cachedNormals);
+    faces.swap(cachedFaces);
+    meshVertices.swap(cachedMeshVertices);
+    meshIndices.swap(cachedMeshIndices);
+    materials.swap(cachedMaterials);
+    materialRuns.swap(cachedMaterialRuns);
+    materialLibraryPaths.swap(cachedLibraryPaths);
+    meshBatches.swap(cachedBatches);
+    submeshes.swap(cachedSubmeshes);
+    submeshRuns.swap(cachedSubmeshRuns);
+    meshlets.swap(cachedMeshlets);
+    meshLods.swap(cachedLods);
+    modelBounds = bounds[0];                                                             // Restore model bounds
+    modelVersion++;                                                                      // New welded mesh to upload
+    return true;
+}
+
+// One section payload to write
+struct MeshCachePayload {
+    uint32_t tag;                                                                        // Section identifier
+    uint32_t elementSize;                                                                // sizeof one element
+    uint64_t count;                                                                      // Number of elements
+    const void* data;                                                                    // Element data
+};
+
+// Write the current model containers to the sidecar (written to a temporary file, then renamed)
+bool saveMeshCache(const char* sourceFilename, uint64_t sourceHash, uint64_t sourceSize) {
+    const MeshCachePayload payloads[] = {
+        { sectionTag('V', 'E', 'R', 'T'), sizeof(Vertex), vertices.size(), vertices.data() },
+        { sectionTag('T', 'E', 'X', 'C'), sizeof(TextureCoord), textureCoords.size(), textureCoords.data() },
+        { sectionTag('N', 'O', 'R', 'M'), sizeof(Normal), normals.size(), normals.data() },
+        { sectionTag('F', 'A', 'C', 'E'), sizeof(Face), faces.size(), faces.data() },
+        { sectionTag('B', 'N', 'D', 'S'), sizeof(Bounds), 1, &modelBounds },
+        { sectionTag('M', 'V', 'T', 'X'), sizeof(MeshVertex), meshVertices.size(), meshVertices.data() },
+        { sectionTag('M', 'I', 'D', 'X'), sizeof(uint32_t), meshIndices.size(), meshIndices.data() },
+        { sectionTag('M', 'A', 'T', 'L'), sizeof(Material), materials.size(), materials.data() },
+        { sectionTag('M', 'R', 'U', 'N'), sizeof(MaterialRun), materialRuns.size(), materialRuns.data() },
+        { sectionTag('M', 'L', 'I', 'B'), sizeof(char), materialLibraryPaths.size(), materialLibraryPaths.data() },
+        { sectionTag('M', 'B', 'A', 'T'), sizeof(MeshBatch), meshBatches.size(), meshBatches.data() },
+        { sectionTag('S', 'U', 'B', 'M'), sizeof(Submesh), submeshes.size(), submeshes.data() },
+        { sectionTag('S', 'R', 'U', 'N'), sizeof(SubmeshRun), submeshRuns.size(), submeshRuns.data() },
+        { sectionTag('M', 'L', 'E', 'T'), sizeof(Meshlet), meshlets.size(), meshlets.data() },
+        { sectionTag('M', 'L', 'O', 'D'), sizeof(MeshLod), meshLods.size(), meshLods.data() },
+    };
+    const uint32_t sectionCount = (uint32_t)(sizeof(payloads) / sizeof(payloads[0]));
+
+    MeshCacheHeader header;                                                              // File header
+    memcpy(header.magic, meshCacheMagic, sizeof(meshCacheMagic));
+    header.version = meshCacheVersion;
+    header.sectionCount = sectionCount;
+    header.sourceSize = sourceSize;
+    header.sourceHash = sourceHash;
+    header.materialHash = hashMaterialLibraries(materialLibraryPaths);
+
+    std::vector<MeshCacheSection> sections(sectionCount);                                // Section table
+    uint64_t offset = sizeof(header) + sectionCount * sizeof(MeshCacheSection);          // First payload offset
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        offset = (offset + 15) & ~15ull;                                                 // Align payloads to 16 bytes
+        sections[i] = { payloads[i].tag, payloads[i].elementSize, offset, payloads[i].count };
+        offset += payloads[i].count * payloads[i].elementSize;
+    }
+
+    std::string path = meshCachePath(sourceFilename);                                    // Final sidecar path
+    std::string temporaryPath = path + ".tmp";                                           // Written first so readers never see half a file
+    FILE* file;
+    if (fopen_s(&file, temporaryPath.c_str(), "wb") != 0 || file == NULL) {
+        printf("Warning: Unable to write mesh cache %s\n", path.c_str());                // Cache is optional
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(sections.data(), sizeof(MeshCacheSection), sectionCount, file) == sectionCount;
+    static const char padding[16] = {};                                                  // Alignment filler
+    uint64_t position = sizeof(header) + sectionCount * sizeof(MeshCacheSection);        // Bytes written so far
+    for (uint32_t i = 0; ok && i < sectionCount; i++) {
+        size_t paddingBytes = (size_t)(sections[i].offset - position);                   // Gap up to the aligned offset
+        size_t bytes = (size_t)(payloads[i].count * payloads[i].elementSize);            // Payload size
+        ok = (paddingBytes == 0 || fwrite(padding, 1, paddingBytes, file) == paddingBytes) &&
+            (bytes == 0 || fwrite(payloads[i].data, 1, bytes, file) == bytes);
+        position = sections[i].offset + bytes;
+    }
+    ok = (fclose(file) == 0) && ok;
+
+    remove(path.c_str());                                                                // rename does not replace on Windows
+    if (!ok || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        remove(temporaryPath.c_str());                                                   // Drop partial file
+        printf("Warning: Unable to write mesh cache %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
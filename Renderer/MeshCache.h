@@ -0,0 +1,12 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Binary sidecar cache of a loaded model, stored next to the source file as "<source>.meshcache".
+// The sidecar holds the resolved model arrays, the model bounds and hashes of the source file and
+// its MTL libraries; it is only used when both still match the current file contents.
+
+uint64_t hashFileContents(const char* data, size_t size);                                // Fast 64-bit hash of a byte range (parallel for large inputs)
+bool findMeshCache(const char* sourceFilename, uint64_t sourceSize, uint64_t& storedHash); // Check for a sidecar written for a source of this size
+bool loadMeshCache(const char* sourceFilename, uint64_t sourceHash, uint64_t sourceSize); // Fill the model containers from a matching sidecar
+bool saveMeshCache(const char* sourceFilename, uint64_t sourceHash, uint64_t sourceSize); // Write the current model containers to the sidecar
\ No newline at end of file
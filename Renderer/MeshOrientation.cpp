@@ -0,0 +1,184 @@
+#include "MeshOrientation.h"
+#include <freeglut.h>
+#include <stdio.h>
+#include <numeric>
+#include <functional>
+#include <algorithm>
+
+bool backfaceCullingEnabled = true;                                                      // Cull back faces of closed batches
+
+// One directed edge of a triangle, keyed by the position ids of its ends
+struct TriangleEdge {
+    uint64_t key;                                                                        // Smaller id in the high half, larger in the low half
+    uint32_t triangle;                                                                   // Triangle the edge belongs to
+    uint32_t forward;                                                                    // The triangle runs from the smaller id to the larger
+};
+
+// Neighbour across a manifold edge
+struct TriangleLink {
+    uint32_t triangle;                                                                   // Triangle on the other side
+    uint32_t sameDirection;                                                              // Both run along the edge the same way: windings disagree
+};
+
+// Flip triangles piece by piece: breadth-first over manifold edges, each triangle takes the winding that
+// agrees with the neighbour that reached it, then the whole piece turns outwards
+void orientMeshTriangles(const std::vector<MeshVertex>& meshVertices, std::vector<uint32_t>& indices,
+    std::vector<MeshBatch>& batches, OrientationStats& outStats) {
+    outStats = {};
+    for (MeshBatch& batch : batches) batch.closed = 0;
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // Id of every distinct position, so vertices split by a normal or texture seam still connect
+    std::vector<uint32_t> byPosition(meshVertices.size());
+    std::iota(byPosition.begin(), byPosition.end(), 0u);
+    auto positionLess = [&](uint32_t a, uint32_t b) {
+        const float* pa = meshVertices[a].position;
+        const float* pb = meshVertices[b].position;
+        return pa[0] != pb[0] ? pa[0] < pb[0] : pa[1] != pb[1] ? pa[1] < pb[1] : pa[2] < pb[2];
+    };
+    std::sort(byPosition.begin(), byPosition.end(), positionLess);
+    std::vector<uint32_t> positionId(meshVertices.size());
+    uint32_t nextId = 0;
+    for (size_t i = 0; i < byPosition.size(); i++) {
+        if (i > 0 && positionLess(byPosition[i - 1], byPosition[i])) nextId++;           // New position
+        positionId[byPosition[i]] = nextId;
+    }
+
+    // Directed edges of the non-degenerate triangles, sorted so the sides of every edge are neighbours
+    std::vector<TriangleEdge> edges;
+    edges.reserve(indices.size());
+    std::vector<uint8_t> degenerate(triangleCount, 0);                                   // Collapsed to a line or point
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        const uint32_t ids[3] = { positionId[indices[t * 3]], positionId[indices[t * 3 + 1]], positionId[indices[t * 3 + 2]] };
+        if (ids[0] == ids[1] || ids[1] == ids[2] || ids[0] == ids[2]) {                  // No area and no edges: invisible either way
+            degenerate[t] = 1;
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            uint32_t from = ids[k], to = ids[(k + 1) % 3];
+            edges.push_back({ ((uint64_t)std::min(from, to) << 32) | std::max(from, to), t, from < to ? 1u : 0u });
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const TriangleEdge& a, const TriangleEdge& b) { return a.key < b.key; });
+
+    // Links across edges with exactly two sides (compressed rows); a border or non-manifold edge opens the
+    // piece of every triangle along it
+    std::vector<uint8_t> touchesOpenEdge(triangleCount, 0);
+    std::vector<uint32_t> firstLink(triangleCount + 1, 0);                               // Row start of each triangle
+    auto forEachEdge = [&](const std::function<void(const TriangleEdge*, size_t)>& visit) {
+        for (size_t begin = 0, end; begin < edges.size(); begin = end) {
+            for (end = begin + 1; end < edges.size() && edges[end].key == edges[begin].key; end++) {}
+            visit(&edges[begin], end - begin);
+        }
+    };
+    forEachEdge([&](const TriangleEdge* sides, size_t count) {
+        if (count == 2) {
+            firstLink[sides[0].triangle + 1]++;
+            firstLink[sides[1].triangle + 1]++;
+        }
+        else {
+            for (size_t i = 0; i < count; i++) touchesOpenEdge[sides[i].triangle] = 1;
+        }
+    });
+    for (size_t t = 0; t < triangleCount; t++) firstLink[t + 1] += firstLink[t];
+    std::vector<TriangleLink> links(firstLink[triangleCount]);
+    {
+        std::vector<uint32_t> writePosition(firstLink.begin(), firstLink.end() - 1);
+        forEachEdge([&](const TriangleEdge* sides, size_t count) {
+            if (count != 2) return;
+            uint32_t same = sides[0].forward == sides[1].forward ? 1u : 0u;
+            links[writePosition[sides[0].triangle]++] = { sides[1].triangle, same };
+            links[writePosition[sides[1].triangle]++] = { sides[0].triangle, same };
+        });
+    }
+    std::vector<TriangleEdge>().swap(edges);
+
+    // Walk the pieces
+    std::vector<uint8_t> visited(triangleCount, 0), flip(triangleCount, 0), closedTriangle(triangleCount, 0);
+    std::vector<uint32_t> queue;
+    for (uint32_t seed = 0; seed < triangleCount; seed++) {
+        if (visited[seed]) continue;
+        if (degenerate[seed]) {                                                          // Not a piece of its own, and never blocks culling
+            closedTriangle[seed] = 1;
+            continue;
+        }
+        queue.assign(1, seed);
+        visited[seed] = 1;
+        bool open = false, orientable = true;
+        for (size_t head = 0; head < queue.size(); head++) {
+            uint32_t t = queue[head];
+            open = open || touchesOpenEdge[t];
+            for (uint32_t l = firstLink[t]; l < firstLink[t + 1]; l++) {
+                uint32_t neighbour = links[l].triangle;
+                uint8_t wanted = flip[t] ^ (uint8_t)links[l].sameDirection;
+                if (!visited[neighbour]) {
+                    visited[neighbour] = 1;
+                    flip[neighbour] = wanted;
+                    queue.push_back(neighbour);
+                }
+                else if (flip[neighbour] != wanted) {
+                    orientable = false;                                                  // Odd cycle of disagreements, as on a Moebius strip
+                }
+            }
+        }
+
+        // Which way the piece faces with the chosen flips: enclosed volume for closed pieces, agreement
+        // with the vertex normals for open ones
+        double volume = 0.0, normalAgreement = 0.0;
+        for (uint32_t t : queue) {
+            const MeshVertex& va = meshVertices[indices[t * 3]];
+            const MeshVertex& vb = meshVertices[indices[t * 3 + (flip[t] ? 2 : 1)]];
+            const MeshVertex& vc = meshVertices[indices[t * 3 + (flip[t] ? 1 : 2)]];
+            const float* a = va.position;
+            double ab[3] = { (double)vb.position[0] - a[0], (double)vb.position[1] - a[1], (double)vb.position[2] - a[2] };
+            double ac[3] = { (double)vc.position[0] - a[0], (double)vc.position[1] - a[1], (double)vc.position[2] - a[2] };
+            double cross[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+            for (int k = 0; k < 3; k++) {
+                volume += a[k] * cross[k];                                               // Six times the signed tetrahedron volume
+                normalAgreement += cross[k] * ((double)va.normal[k] + vb.normal[k] + vc.normal[k]);
+            }
+        }
+        bool closed = !open && orientable;
+        if (closed ? volume < 0.0 : normalAgreement < 0.0) {
+            for (uint32_t t : queue) flip[t] ^= 1;                                       // Inside out: turn the whole piece
+        }
+        for (uint32_t t : queue) closedTriangle[t] = closed ? 1 : 0;
+        outStats.components++;
+        if (closed) outStats.closedComponents++;
+        if (!orientable) outStats.nonOrientableComponents++;
+    }
+
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (!flip[t]) continue;
+        std::swap(indices[t * 3 + 1], indices[t * 3 + 2]);
+        outStats.flippedTriangles++;
+    }
+    for (MeshBatch& batch : batches) {
+        uint32_t firstTriangle = batch.firstIndex / 3, endTriangle = firstTriangle + batch.indexCount / 3;
+        batch.closed = std::all_of(closedTriangle.begin() + firstTriangle, closedTriangle.begin() + endTriangle,
+            [](uint8_t closed) { return closed != 0; }) ? 1 : 0;
+        outStats.closedBatches += batch.closed;
+    }
+}
+
+// Toggle culling of back faces on closed batches
+void toggleBackfaceCulling() {
+    backfaceCullingEnabled = !backfaceCullingEnabled;
+    printf("Back-face culling: %s\n", backfaceCullingEnabled ? "on" : "off");
+}
+
+// Closed batches are wound counter-clockwise from outside, the default glFrontFace
+void applyBatchCulling(const MeshBatch& batch, int& cullState) {
+    int wanted = backfaceCullingEnabled && batch.closed ? 1 : 0;
+    if (wanted == cullState) return;
+    if (wanted) glEnable(GL_CULL_FACE);
+    else glDisable(GL_CULL_FACE);
+    cullState = wanted;
+}
+
+// Leave culling disabled for the rest of the frame
+void endBatchCulling(int& cullState) {
+    if (cullState != 0) glDisable(GL_CULL_FACE);
+    cullState = 0;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+#include "ModelLoader.h"
+
+// Outcome of orientMeshTriangles
+struct OrientationStats {
+    size_t components;                                                                   // Edge-connected pieces of surface
+    size_t closedComponents;                                                             // Watertight and consistently wound after the repair
+    size_t nonOrientableComponents;                                                      // Pieces no choice of windings makes consistent
+    size_t flippedTriangles;                                                             // Triangles whose winding was reversed
+    size_t closedBatches;                                                                // Batches marked closed
+};
+
+// Make the winding of the triangles consistent across every connected piece of surface and mark the batches
+// whose back faces can be culled. Triangles are connected through edges between equal positions (so
+// attribute seams do not split a surface) and flipped so neighbours traverse their shared edge in opposite
+// directions. A closed piece is then wound counter-clockwise seen from outside (positive volume); an open
+// one so its faces agree with the vertex normals. A batch is closed when all its triangles lie on closed
+// pieces. Flips swap two indices in place, so batch and meshlet ranges stay valid.
+void orientMeshTriangles(const std::vector<MeshVertex>& meshVertices, std::vector<uint32_t>& indices,
+    std::vector<MeshBatch>& batches, OrientationStats& outStats);
+
+extern bool backfaceCullingEnabled;                                                      // Cull back faces of closed batches (toggled from the menu)
+void toggleBackfaceCulling();                                                            // Toggle back-face culling
+
+// Enable GL_CULL_FACE for a closed batch and disable it otherwise, skipping redundant changes. cullState
+// holds the current setting between calls: start it at -1 and pass it to endBatchCulling afterwards.
+void applyBatchCulling(const MeshBatch& batch, int& cullState);
+void endBatchCulling(int& cullState);                                                    // Leave culling disabled, as drawModel expects
\ No newline at end of file
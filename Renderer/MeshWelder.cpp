@@ -0,0 +1,360 @@
+#include "MeshWelder.h"
+#include "ThreadPool.h"
+#include "LoaderArena.h"
+#include "Meshlets.h"
+#include "LevelOfDetail.h"
+#include "TriangleOrder.h"
+#include "MeshOrientation.h"
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+// One face corner as the triple of attribute indices it references
+struct WeldKey {
+    int vertex;                                                                          // Index into vertices (0 = missing)
+    int textureCoord;                                                                    // Index into textureCoords (0 = missing)
+    int normal;                                                                          // Index into normals (0 = missing)
+
+    bool operator==(const WeldKey& other) const {
+        return vertex == other.vertex && textureCoord == other.textureCoord && normal == other.normal;
+    }
+};
+
+// Hash of a corner key; the high bits pick the shard, the rest feed the shard's table
+static inline uint64_t hashWeldKey(const WeldKey& key) {
+    uint64_t hash = (uint64_t)(uint32_t)key.vertex * 0x9E3779B97F4A7C15ull;
+    hash ^= (uint64_t)(uint32_t)key.textureCoord * 0xC2B2AE3D27D4EB4Full;
+    hash ^= (uint64_t)(uint32_t)key.normal * 0x165667B19E3779F9ull;
+    return hash ^ (hash >> 29);
+}
+
+// Marks an unused slot in a shard's hash table
+static const uint32_t emptySlot = 0xFFFFFFFFu;
+
+// Corner i of a triangulated face (quads become 0-1-2 and 0-2-3)
+static const int triangulatedCorners[2][6] = {
+    { 0, 1, 2, -1, -1, -1 },                                                             // Triangle
+    { 0, 1, 2, 0, 2, 3 },                                                                // Quad
+};
+
+// Clamp an attribute index to the container, mapping missing or invalid indices to the dummy at 0
+static inline int validIndex(int index, size_t count) {
+    return (index > 0 && (size_t)index < count) ? index : 0;
+}
+
+// Weld unique corners into an interleaved vertex array plus a triangle index buffer.
+// Corners are hashed in parallel into shards by key; each shard finds the first corner that
+// uses every key, then one in-order pass numbers the first corners and fills the indices.
+void weldMesh(const std::vector<Vertex>& inVertices, const std::vector<TextureCoord>& inTextureCoords,
+    const std::vector<Normal>& inNormals, const std::vector<Face>& inFaces, ThreadPool& pool,
+    std::vector<MeshVertex>& outVertices, std::vector<uint32_t>& outIndices) {
+    std::vector<MeshVertex>().swap(outVertices);                                         // Release old capacity; outputs are sized exactly
+    std::vector<uint32_t>().swap(outIndices);
+
+    // Split the faces into ranges and count the triangulated corners of each range
+    const size_t faceCount = inFaces.size();
+    const size_t rangeCount = std::max<size_t>(1, std::min<size_t>(pool.threadCount() * 4, faceCount / 4096));
+    std::vector<size_t> rangeStart(rangeCount + 1);                                      // First face of each range
+    for (size_t r = 0; r <= rangeCount; r++) rangeStart[r] = faceCount * r / rangeCount;
+    std::vector<size_t> cornerStart(rangeCount + 1, 0);                                  // First corner of each range
+    pool.parallelFor(rangeCount, [&](size_t r) {
+        size_t corners = 0;
+        for (size_t f = rangeStart[r]; f < rangeStart[r + 1]; f++) {
+            corners += inFaces[f].vertexCount == 4 ? 6 : inFaces[f].vertexCount == 3 ? 3 : 0;
+        }
+        cornerStart[r + 1] = corners;
+    });
+    for (size_t r = 0; r < rangeCount; r++) cornerStart[r + 1] += cornerStart[r];        // Prefix sum
+    const size_t cornerCount = cornerStart[rangeCount];
+    if (cornerCount == 0) return;
+
+    // Small meshes are welded in one shard; large ones use a power of two shards per thread
+    unsigned shardBits = 0;
+    if (cornerCount >= (1 << 16)) {
+        while ((1u << shardBits) < pool.threadCount() * 2) shardBits++;
+    }
+    const size_t shardCount = (size_t)1 << shardBits;
+
+    // Per-corner temporaries live in one arena that is freed when welding is done
+    LoaderArena arena(16 << 20);                                                         // Weld temporaries
+    WeldKey* keys = arena.allocateArray<WeldKey>(cornerCount);                           // Key of every corner in draw order
+    uint32_t* shardOf = shardBits ? arena.allocateArray<uint32_t>(cornerCount) : nullptr; // Shard of every corner
+    uint32_t* shardCorners = shardBits ? arena.allocateArray<uint32_t>(cornerCount) : nullptr; // Corner numbers grouped by shard (one shard: identity)
+    uint32_t* firstCorner = arena.allocateArray<uint32_t>(cornerCount);                  // Earliest corner sharing the key
+
+    // Gather the corner keys and their shards, counting corners per (range, shard)
+    std::vector<size_t> shardCounts(rangeCount * shardCount, 0);                         // Corners of a range in each shard
+    pool.parallelFor(rangeCount, [&](size_t r) {
+        size_t corner = cornerStart[r];
+        size_t* counts = &shardCounts[r * shardCount];
+        for (size_t f = rangeStart[r]; f < rangeStart[r + 1]; f++) {
+            const Face& face = inFaces[f];
+            if (face.vertexCount != 3 && face.vertexCount != 4) continue;                // Not drawable
+            const int* order = triangulatedCorners[face.vertexCount == 4];
+            for (int i = 0; i < (face.vertexCount == 4 ? 6 : 3); i++, corner++) {
+                int c = order[i];
+                WeldKey key = { validIndex(face.vertexIndices[c], inVertices.size()),
+                    validIndex(face.textureIndices[c], inTextureCoords.size()),
+                    validIndex(face.normalIndices[c], inNormals.size()) };
+                keys[corner] = key;
+                uint32_t shard = shardBits ? (uint32_t)(hashWeldKey(key) >> (64 - shardBits)) : 0;
+                if (shardOf) shardOf[corner] = shard;
+                counts[shard]++;
+            }
+        }
+    });
+
+    // Scatter corner numbers into per-shard lists, keeping draw order inside each shard
+    std::vector<size_t> shardStart(shardCount + 1, 0);                                   // First slot of each shard
+    std::vector<size_t> scatterOffsets(rangeCount * shardCount);                         // Write position of a range in a shard
+    size_t slot = 0;
+    for (size_t s = 0; s < shardCount; s++) {
+        shardStart[s] = slot;
+        for (size_t r = 0; r < rangeCount; r++) {
+            scatterOffsets[r * shardCount + s] = slot;
+            slot += shardCounts[r * shardCount + s];
+        }
+    }
+    shardStart[shardCount] = slot;
+    if (shardCorners) pool.parallelFor(rangeCount, [&](size_t r) {
+        size_t* offsets = &scatterOffsets[r * shardCount];
+        for (size_t corner = cornerStart[r]; corner < cornerStart[r + 1]; corner++) {
+            shardCorners[offsets[shardOf[corner]]++] = (uint32_t)corner;
+        }
+    });
+
+    // Within each shard, map every corner to the first corner with the same key using an
+    // open-addressed table of corner numbers (keys are compared through the corner)
+    std::vector<size_t> tableStart(shardCount + 1, 0);                                   // Slot range of each shard's table
+    for (size_t s = 0; s < shardCount; s++) {
+        size_t capacity = 16;
+        while (capacity < (shardStart[s + 1] - shardStart[s]) * 2) capacity *= 2;        // Load factor at most one half
+        tableStart[s + 1] = tableStart[s] + capacity;
+    }
+    uint32_t* tables = arena.allocateArray<uint32_t>(tableStart[shardCount]);            // All shard tables, allocated once
+    std::vector<size_t> shardUnique(shardCount, 0);                                      // Unique keys per shard
+    pool.parallelFor(shardCount, [&](size_t s) {
+        uint32_t* table = tables + tableStart[s];                                        // First corner of each key, by slot
+        const size_t mask = tableStart[s + 1] - tableStart[s] - 1;
+        std::fill(table, table + mask + 1, emptySlot);
+        size_t unique = 0;
+        for (size_t i = shardStart[s]; i < shardStart[s + 1]; i++) {
+            uint32_t corner = shardCorners ? shardCorners[i] : (uint32_t)i;
+            const WeldKey& key = keys[corner];
+            size_t slot = (size_t)hashWeldKey(key) & mask;
+            while (table[slot] != emptySlot && !(keys[table[slot]] == key)) {
+                slot = (slot + 1) & mask;                                                // Linear probing
+            }
+            if (table[slot] == emptySlot) {
+                table[slot] = corner;                                                    // First use of this key
+                unique++;
+            }
+            firstCorner[corner] = table[slot];
+        }
+        shardUnique[s] = unique;
+    });
+
+    // Size both outputs exactly once
+    size_t uniqueCount = 0;
+    for (size_t unique : shardUnique) uniqueCount += unique;
+    outVertices.reserve(uniqueCount);
+
+    // Number the first corners in draw order; every other corner reuses its first corner's vertex
+    outIndices.resize(cornerCount);
+    checkpointLoaderMemory(modelMemoryBytes());                                          // Weld temporaries and outputs are both alive here
+    for (size_t corner = 0; corner < cornerCount; corner++) {
+        if (firstCorner[corner] == corner) {
+            const WeldKey& key = keys[corner];
+            const Vertex& position = inVertices[key.vertex];
+            const TextureCoord& texCoord = inTextureCoords[key.textureCoord];
+            const Normal& normal = inNormals[key.normal];
+            outIndices[corner] = (uint32_t)outVertices.size();
+            outVertices.push_back({ { position.x, position.y, position.z },
+                { normal.x, normal.y, normal.z }, { texCoord.u, texCoord.v } });
+        }
+        else {
+            outIndices[corner] = outIndices[firstCorner[corner]];                        // Earlier corner, already numbered
+        }
+    }
+}
+
+// Sum the unnormalized cross products of the triangles around every position (twice the area times the
+// unit normal, so larger faces weigh more) and hand the direction to the vertices at that position with no
+// normal. Positions are matched by value, so texture seams do not split the sums.
+size_t generateMissingNormals(std::vector<MeshVertex>& meshVertices, const std::vector<uint32_t>& indices) {
+    auto isMissing = [](const MeshVertex& vertex) {
+        return vertex.normal[0] == 0.0f && vertex.normal[1] == 0.0f && vertex.normal[2] == 0.0f;
+    };
+    if (std::none_of(meshVertices.begin(), meshVertices.end(), isMissing)) return 0;
+
+    // Id of every distinct position
+    std::vector<uint32_t> byPosition(meshVertices.size());
+    for (uint32_t i = 0; i < byPosition.size(); i++) byPosition[i] = i;
+    auto positionLess = [&](uint32_t a, uint32_t b) {
+        const float* pa = meshVertices[a].position;
+        const float* pb = meshVertices[b].position;
+        return pa[0] != pb[0] ? pa[0] < pb[0] : pa[1] != pb[1] ? pa[1] < pb[1] : pa[2] < pb[2];
+    };
+    std::sort(byPosition.begin(), byPosition.end(), positionLess);
+    std::vector<uint32_t> positionId(meshVertices.size());
+    uint32_t idCount = 0;
+    for (size_t i = 0; i < byPosition.size(); i++) {
+        if (i > 0 && positionLess(byPosition[i - 1], byPosition[i])) idCount++;          // New position
+        positionId[byPosition[i]] = idCount;
+    }
+
+    std::vector<double> sums((size_t)(idCount + 1) * 3, 0.0);                            // Area-weighted normal sum per position
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const float* a = meshVertices[indices[t]].position;
+        const float* b = meshVertices[indices[t + 1]].position;
+        const float* c = meshVertices[indices[t + 2]].position;
+        double ab[3] = { (double)b[0] - a[0], (double)b[1] - a[1], (double)b[2] - a[2] };
+        double ac[3] = { (double)c[0] - a[0], (double)c[1] - a[1], (double)c[2] - a[2] };
+        double cross[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+        for (int k = 0; k < 3; k++) {
+            double* sum = &sums[positionId[indices[t + k]] * 3];
+            for (int axis = 0; axis < 3; axis++) sum[axis] += cross[axis];
+        }
+    }
+
+    size_t generated = 0;
+    for (size_t i = 0; i < meshVertices.size(); i++) {
+        if (!isMissing(meshVertices[i])) continue;
+        const double* sum = &sums[positionId[i] * 3];
+        double length = sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+        if (length == 0.0) continue;                                                     // Only degenerate faces: no direction
+        for (int axis = 0; axis < 3; axis++) meshVertices[i].normal[axis] = (float)(sum[axis] / length);
+        generated++;
+    }
+    return generated;
+}
+
+// Value of a face run list at face f, advancing the run cursor (faces are visited in order)
+template <typename Run, typename Field>
+static inline int32_t runValueAt(const std::vector<Run>& runs, size_t& run, size_t f, Field field, size_t limit) {
+    while (run + 1 < runs.size() && runs[run + 1].firstFace <= f) run++;                 // Advance to the face's run
+    int32_t value = runs.empty() ? 0 : runs[run].*field;
+    return (value < 0 || (size_t)value >= limit) ? 0 : value;                            // Guard against stale runs
+}
+
+// Reorder triangles by (submesh, material) with a stable counting sort, then build the submesh
+// ranges and the batches, and sort the batches by material
+void groupMeshTriangles(const std::vector<Face>& inFaces, const std::vector<MaterialRun>& materialRuns,
+    const std::vector<SubmeshRun>& submeshRuns, size_t materialCount, std::vector<Submesh>& submeshes,
+    std::vector<uint32_t>& indices, std::vector<MeshBatch>& outBatches) {
+    outBatches.clear();
+    for (Submesh& submesh : submeshes) submesh.firstIndex = submesh.indexCount = 0;
+    if (indices.empty()) return;
+
+    // Group key of every triangle, following the face layout used by weldMesh
+    const size_t keyCount = submeshes.size() * materialCount;                            // Submesh-major keys
+    std::vector<uint32_t> triangleKeys;                                                  // One entry per output triangle
+    triangleKeys.reserve(indices.size() / 3);
+    std::vector<size_t> triangleCounts(keyCount, 0);                                     // Triangles per key
+    size_t materialRun = 0, submeshRun = 0;                                              // Runs containing the current face
+    for (size_t f = 0; f < inFaces.size(); f++) {
+        int32_t material = runValueAt(materialRuns, materialRun, f, &MaterialRun::material, materialCount);
+        int32_t submesh = runValueAt(submeshRuns, submeshRun, f, &SubmeshRun::submesh, submeshes.size());
+        uint32_t key = (uint32_t)(submesh * materialCount + material);
+        int triangles = inFaces[f].vertexCount == 4 ? 2 : inFaces[f].vertexCount == 3 ? 1 : 0;
+        for (int t = 0; t < triangles; t++) triangleKeys.push_back(key);
+        triangleCounts[key] += triangles;
+    }
+
+    // Ranges in key order: every submesh is contiguous and split into one batch per material
+    std::vector<size_t> writePosition(keyCount);                                         // Next triangle slot of each key
+    size_t triangle = 0;
+    for (size_t key = 0; key < keyCount; key++) {
+        writePosition[key] = triangle;
+        if (triangleCounts[key]) {
+            Submesh& submesh = submeshes[key / materialCount];
+            if (submesh.indexCount == 0) submesh.firstIndex = (uint32_t)(triangle * 3);  // First batch of the submesh
+            submesh.indexCount += (uint32_t)(triangleCounts[key] * 3);
+            outBatches.push_back({ (int32_t)(key % materialCount), (uint32_t)(triangle * 3),
+                (uint32_t)(triangleCounts[key] * 3), (int32_t)(key / materialCount) });
+        }
+        triangle += triangleCounts[key];
+    }
+
+    // Draw order: by material so each material is set once per frame
+    std::stable_sort(outBatches.begin(), outBatches.end(), [](const MeshBatch& a, const MeshBatch& b) {
+        return a.material < b.material;
+    });
+    if (outBatches.size() == 1) return;                                                  // Already contiguous
+
+    std::vector<uint32_t> grouped(indices.size());                                       // Reordered index buffer
+    for (size_t t = 0; t < triangleKeys.size(); t++) {
+        size_t slot = writePosition[triangleKeys[t]]++;
+        memcpy(&grouped[slot * 3], &indices[t * 3], 3 * sizeof(uint32_t));
+    }
+    indices.swap(grouped);
+}
+
+// Compute the bounds of every submesh from the welded vertices its index range references
+void computeSubmeshBounds(const std::vector<MeshVertex>& meshVertices, const std::vector<uint32_t>& indices,
+    ThreadPool& pool, std::vector<Submesh>& submeshes) {
+    pool.parallelFor(submeshes.size(), [&](size_t s) {
+        Submesh& submesh = submeshes[s];
+        Bounds bounds = { {FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX} }; // Start inverted
+        for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; i++) {
+            const float* position = meshVertices[indices[i]].position;
+            for (int axis = 0; axis < 3; axis++) {
+                bounds.min[axis] = std::min(bounds.min[axis], position[axis]);           // Grow minimum
+                bounds.max[axis] = std::max(bounds.max[axis], position[axis]);           // Grow maximum
+            }
+        }
+        if (submesh.indexCount == 0) bounds = { {0, 0, 0}, {0, 0, 0} };                  // Empty submesh
+        submesh.bounds = bounds;
+    });
+}
+
+// Weld the model containers into meshVertices/meshIndices, repair the winding, optimize the draw order and
+// report the dedup ratio, winding, vertex cache efficiency and memory use
+void weldModel() {
+    auto start = std::chrono::steady_clock::now();                                       // Start weld timer
+    weldMesh(vertices, textureCoords, normals, faces, sharedThreadPool(), meshVertices, meshIndices);
+    if (materials.empty()) materials.assign(1, defaultMaterial);                         // Loaders without materials
+    if (submeshes.empty()) submeshes.assign(1, defaultSubmesh);                          // Loaders without groups
+    groupMeshTriangles(faces, materialRuns, submeshRuns, materials.size(), submeshes, meshIndices, meshBatches);
+    OrientationStats orientation;
+    orientMeshTriangles(meshVertices, meshIndices, meshBatches, orientation);            // Consistent winding, closed batches marked
+    size_t generatedNormals = generateMissingNormals(meshVertices, meshIndices);         // After orientation, so they face outwards
+    VertexCacheStats fileOrder = analyzeVertexCache(meshIndices.data(), meshIndices.size(), meshVertices.size());
+    buildMeshlets(meshVertices, meshIndices, meshBatches, sharedThreadPool(), meshlets); // Clusters for per-frame culling
+    auto orderStart = std::chrono::steady_clock::now();
+    optimizeTriangleOrder(meshIndices, meshBatches, sharedThreadPool(), meshlets);       // Overdraw order of meshlets, cache order inside them
+    optimizeVertexFetch(meshVertices, meshIndices);                                      // Vertices in first-use order
+    double orderElapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - orderStart).count();
+    VertexCacheStats optimized = analyzeVertexCache(meshIndices.data(), meshIndices.size(), meshVertices.size());
+    computeSubmeshBounds(meshVertices, meshIndices, sharedThreadPool(), submeshes);      // Per-submesh culling bounds
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    auto lodStart = std::chrono::steady_clock::now();
+    buildMeshLods(meshVertices, meshIndices, meshBatches, meshlets, sharedThreadPool(), meshLods); // Simplified levels appended after the full mesh
+    double lodElapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - lodStart).count();
+    modelVersion++;                                                                      // New welded mesh to upload
+
+    size_t bytesBefore = vertices.size() * sizeof(Vertex) + textureCoords.size() * sizeof(TextureCoord) +
+        normals.size() * sizeof(Normal) + faces.size() * sizeof(Face);                   // Separate attribute streams and faces
+    const MeshLod& fullDetail = meshLods[0];                                             // Welded mesh before the simplified levels
+    size_t bytesAfter = meshVertices.size() * sizeof(MeshVertex) + fullDetail.indexCount * sizeof(uint32_t);
+    printf("Welded %u corners into %zu vertices (dedup ratio %.2f:1) in %.1f ms\n",
+        fullDetail.indexCount, meshVertices.size(),
+        meshVertices.empty() ? 0.0 : (double)fullDetail.indexCount / meshVertices.size(), elapsed);
+    printf("Mesh memory: %.2f MB separate streams, %.2f MB interleaved + indices\n",
+        bytesBefore / (1024.0 * 1024.0), bytesAfter / (1024.0 * 1024.0));
+    if (generatedNormals) printf("Generated %zu vertex normals for corners without one\n", generatedNormals);
+    printf("Draw batches: %u (materials: %zu, submeshes: %zu), meshlets: %zu (%.1f triangles each)\n",
+        fullDetail.batchCount, materials.size() - 1, submeshes.size(), meshlets.size(),
+        meshlets.empty() ? 0.0 : (double)fullDetail.indexCount / 3 / meshlets.size());
+    printf("Winding: %zu pieces of surface (%zu closed, %zu non-orientable), %zu triangles flipped, back faces culled in %zu of %u batches\n",
+        orientation.components, orientation.closedComponents, orientation.nonOrientableComponents, orientation.flippedTriangles,
+        orientation.closedBatches, fullDetail.batchCount);
+    printf("Vertex cache (FIFO %d): ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, reordered in %.1f ms\n", vertexCacheSize,
+        fileOrder.acmr, optimized.acmr, fileOrder.atvr, optimized.atvr, orderElapsed);
+    printf("Levels of detail: %zu in %.1f ms, triangles", meshLods.size(), lodElapsed);
+    for (const MeshLod& lod : meshLods) printf(" %u (error %.3g)", lod.indexCount / 3, lod.error);
+    printf(", %.2f MB of extra indices\n", (meshIndices.size() - fullDetail.indexCount) * sizeof(uint32_t) / (1024.0 * 1024.0));
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "ModelLoader.h"
+
+class ThreadPool;
+
+// Weld every unique (v, vt, vn) corner of the faces into one interleaved vertex array and
+// build a triangle index buffer over it. Quads are split into two triangles. Vertices are
+// numbered in order of first use, so the result is identical for any thread count.
+void weldMesh(const std::vector<Vertex>& inVertices, const std::vector<TextureCoord>& inTextureCoords,
+    const std::vector<Normal>& inNormals, const std::vector<Face>& inFaces, ThreadPool& pool,
+    std::vector<MeshVertex>& outVertices, std::vector<uint32_t>& outIndices);
+
+// Reorder the triangles of a welded index buffer so each submesh is one contiguous range made of
+// one batch per material (keeping face order inside a batch). The batches are returned sorted by
+// material so a frame sets each material once.
+void groupMeshTriangles(const std::vector<Face>& inFaces, const std::vector<MaterialRun>& materialRuns,
+    const std::vector<SubmeshRun>& submeshRuns, size_t materialCount, std::vector<Submesh>& submeshes,
+    std::vector<uint32_t>& indices, std::vector<MeshBatch>& outBatches);
+
+// Give vertices without a normal (corners with no "vn") the area-weighted normal of the triangles around
+// their position, following the triangles' winding. Returns the number of normals generated.
+size_t generateMissingNormals(std::vector<MeshVertex>& meshVertices, const std::vector<uint32_t>& indices);
+
+// Compute the bounds of every submesh from the vertices its index range references
+void computeSubmeshBounds(const std::vector<MeshVertex>& meshVertices, const std::vector<uint32_t>& indices,
+    ThreadPool& pool, std::vector<Submesh>& submeshes);
+
+// Weld the model containers into the indexed mesh and build everything drawn from it (batches,
+// meshlets, levels of detail), reporting the dedup ratio and memory use
+void weldModel();
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "Meshlets.h"
+#include "ThreadPool.h"
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include <algorithm>
+
+// A triangle joins a cluster only while its normal is within about 45 degrees of the cluster average
+static const float meshletMinNormalDot = 0.7f;
+
+// Unit geometric normal of triangle t (zero for degenerate triangles). It follows the counter-clockwise
+// winding, flipped when the vertex normals point the other way: the faces are lit from the vertex
+// normals and open surfaces are drawn two-sided, so those decide which side of such a face is the outside.
+static void triangleNormal(const std::vector<MeshVertex>& meshVertices, const uint32_t* indices, size_t t, float normal[3]) {
+    const MeshVertex& va = meshVertices[indices[t * 3 + 0]];
+    const MeshVertex& vb = meshVertices[indices[t * 3 + 1]];
+    const MeshVertex& vc = meshVertices[indices[t * 3 + 2]];
+    const float* a = va.position;
+    const float* b = vb.position;
+    const float* c = vc.position;
+    float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    normal[0] = ab[1] * ac[2] - ab[2] * ac[1];
+    normal[1] = ab[2] * ac[0] - ab[0] * ac[2];
+    normal[2] = ab[0] * ac[1] - ab[1] * ac[0];
+    float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    float scale = length > 0.0f ? 1.0f / length : 0.0f;
+    float shading = 0.0f;                                                                // Agreement with the vertex normals
+    for (int k = 0; k < 3; k++) shading += normal[k] * (va.normal[k] + vb.normal[k] + vc.normal[k]);
+    if (shading < 0.0f) scale = -scale;                                                  // Wound clockwise from the lit side
+    for (int k = 0; k < 3; k++) normal[k] *= scale;
+}
+
+// Bounding sphere and normal cone of the triangles indices[firstIndex, firstIndex + indexCount)
+static Meshlet meshletBounds(const std::vector<MeshVertex>& meshVertices, const std::vector<uint32_t>& indices,
+    const std::vector<float>& triangleNormals, uint32_t firstIndex, uint32_t indexCount) {
+    Meshlet meshlet = {};
+    meshlet.firstIndex = firstIndex;
+    meshlet.indexCount = indexCount;
+
+    // Sphere around the box of the corners, with the radius to the farthest corner
+    float boxMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, boxMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t i = firstIndex; i < firstIndex + indexCount; i++) {
+        const float* position = meshVertices[indices[i]].position;
+        for (int k = 0; k < 3; k++) {
+            boxMin[k] = std::min(boxMin[k], position[k]);
+            boxMax[k] = std::max(boxMax[k], position[k]);
+        }
+    }
+    for (int k = 0; k < 3; k++) meshlet.center[k] = (boxMin[k] + boxMax[k]) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (uint32_t i = firstIndex; i < firstIndex + indexCount; i++) {
+        const float* position = meshVertices[indices[i]].position;
+        float dx = position[0] - meshlet.center[0], dy = position[1] - meshlet.center[1], dz = position[2] - meshlet.center[2];
+        radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+    }
+    meshlet.radius = sqrtf(radiusSquared);
+
+    // Cone around the average normal; its cutoff is cos(angle + 90) negated, i.e. the sine of the half angle
+    float axis[3] = { 0, 0, 0 };
+    for (uint32_t t = firstIndex / 3; t < (firstIndex + indexCount) / 3; t++) {
+        for (int k = 0; k < 3; k++) axis[k] += triangleNormals[t * 3 + k];
+    }
+    float length = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    meshlet.coneCutoff = 1.0f;                                                           // Never faces away
+    if (length <= 0.0f) return meshlet;                                                  // Degenerate or opposing normals
+    for (int k = 0; k < 3; k++) meshlet.coneAxis[k] = axis[k] / length;
+    float minDot = 1.0f;                                                                 // Cosine of the widest normal
+    for (uint32_t t = firstIndex / 3; t < (firstIndex + indexCount) / 3; t++) {
+        const float* normal = &triangleNormals[t * 3];
+        if (normal[0] == 0.0f && normal[1] == 0.0f && normal[2] == 0.0f) continue;       // Degenerate triangles are never visible
+        minDot = std::min(minDot, normal[0] * meshlet.coneAxis[0] + normal[1] * meshlet.coneAxis[1] + normal[2] * meshlet.coneAxis[2]);
+    }
+    if (minDot > 0.0f) meshlet.coneCutoff = sqrtf(1.0f - minDot * minDot);               // Cones of 90 degrees or more never cull
+    return meshlet;
+}
+
+// Cluster the triangles of every batch, then reorder each batch's indices cluster by cluster
+void buildMeshlets(const std::vector<MeshVertex>& meshVertices, std::vector<uint32_t>& indices,
+    std::vector<MeshBatch>& batches, ThreadPool& pool, std::vector<Meshlet>& outMeshlets) {
+    outMeshlets.clear();
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        for (MeshBatch& batch : batches) batch.firstMeshlet = batch.meshletCount = 0;
+        return;
+    }
+
+    // Triangles around every vertex (compressed rows)
+    std::vector<uint32_t> vertexFirstTriangle(meshVertices.size() + 1, 0);               // Row start of each vertex
+    for (uint32_t index : indices) vertexFirstTriangle[index + 1]++;
+    for (size_t v = 0; v < meshVertices.size(); v++) vertexFirstTriangle[v + 1] += vertexFirstTriangle[v];
+    std::vector<uint32_t> vertexTriangles(indices.size());                               // Triangle of every corner, grouped by vertex
+    {
+        std::vector<uint32_t> writePosition(vertexFirstTriangle.begin(), vertexFirstTriangle.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) vertexTriangles[writePosition[indices[i]]++] = (uint32_t)(i / 3);
+    }
+
+    std::vector<float> triangleNormals(triangleCount * 3);                               // Unit face normals
+    pool.parallelFor((triangleCount + 65535) / 65536, [&](size_t block) {
+        size_t end = std::min(triangleCount, (block + 1) * 65536);
+        for (size_t t = block * 65536; t < end; t++) triangleNormal(meshVertices, indices.data(), t, &triangleNormals[t * 3]);
+    });
+
+    // Grow clusters inside each batch; batches cover disjoint triangles, so they run in parallel
+    std::vector<uint32_t> grouped(indices.size());                                       // Reordered index buffer
+    std::vector<float> groupedNormals(triangleNormals.size());                           // Face normals in the new order
+    std::vector<uint32_t> queuedBy(triangleCount, UINT32_MAX);                           // Seed of the cluster that queued a triangle
+    std::vector<uint8_t> assigned(triangleCount, 0);                                     // Triangle already belongs to a cluster
+    std::vector<std::vector<uint32_t>> batchClusterSizes(batches.size());                // Triangles per cluster, in output order
+    pool.parallelFor(batches.size(), [&](size_t b) {
+        const uint32_t firstTriangle = batches[b].firstIndex / 3;
+        const uint32_t endTriangle = firstTriangle + batches[b].indexCount / 3;
+        uint32_t output = firstTriangle;                                                 // Next triangle slot in grouped
+        std::vector<uint32_t> queue;                                                     // Candidates of the growing cluster
+        for (uint32_t seed = firstTriangle; seed < endTriangle; seed++) {
+            if (assigned[seed]) continue;
+            uint32_t clusterStart = output;
+            float axis[3] = { 0, 0, 0 };                                                 // Sum of the member normals
+            queue.assign(1, seed);
+            queuedBy[seed] = seed;
+            for (size_t head = 0; head < queue.size() && output - clusterStart < meshletMaxTriangles; head++) {
+                uint32_t t = queue[head];
+                const float* normal = &triangleNormals[t * 3];
+                if (assigned[t]) continue;
+                float axisLength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+                if (axisLength > 0.0f &&
+                    (normal[0] * axis[0] + normal[1] * axis[1] + normal[2] * axis[2]) < meshletMinNormalDot * axisLength &&
+                    (normal[0] != 0.0f || normal[1] != 0.0f || normal[2] != 0.0f)) {
+                    continue;                                                            // Would widen the cone; left for a later cluster
+                }
+                assigned[t] = 1;
+                for (int k = 0; k < 3; k++) axis[k] += normal[k];
+                memcpy(&grouped[output * 3], &indices[t * 3], 3 * sizeof(uint32_t));
+                memcpy(&groupedNormals[output * 3], normal, 3 * sizeof(float));
+                output++;
+                for (int corner = 0; corner < 3; corner++) {                             // Queue the triangles sharing a vertex
+                    uint32_t vertex = indices[t * 3 + corner];
+                    for (uint32_t i = vertexFirstTriangle[vertex]; i < vertexFirstTriangle[vertex + 1]; i++) {
+                        uint32_t neighbour = vertexTriangles[i];
+                        if (neighbour < firstTriangle || neighbour >= endTriangle) continue; // Other batch
+                        if (assigned[neighbour] || queuedBy[neighbour] == seed) continue;
+                        queuedBy[neighbour] = seed;
+                        queue.push_back(neighbour);
+                    }
+                }
+            }
+            batchClusterSizes[b].push_back(output - clusterStart);
+        }
+    });
+    indices.swap(grouped);
+    triangleNormals.swap(groupedNormals);
+
+    // Meshlet ranges and bounds in batch order
+    for (size_t b = 0; b < batches.size(); b++) {
+        batches[b].firstMeshlet = (uint32_t)outMeshlets.size();
+        batches[b].meshletCount = (uint32_t)batchClusterSizes[b].size();
+        uint32_t firstIndex = batches[b].firstIndex;
+        for (uint32_t size : batchClusterSizes[b]) {
+            outMeshlets.push_back({ firstIndex, size * 3 });
+            firstIndex += size * 3;
+        }
+    }
+    pool.parallelFor(outMeshlets.size(), [&](size_t m) {
+        outMeshlets[m] = meshletBounds(meshVertices, indices, triangleNormals, outMeshlets[m].firstIndex, outMeshlets[m].indexCount);
+    });
+}
+
+// Cone test against the bounding sphere, so it holds for every point of every triangle in the meshlet
+bool meshletFacesAway(const Meshlet& meshlet, const float eye[3]) {
+    float toCenter[3] = { meshlet.center[0] - eye[0], meshlet.center[1] - eye[1], meshlet.center[2] - eye[2] };
+    float distance = sqrtf(toCenter[0] * toCenter[0] + toCenter[1] * toCenter[1] + toCenter[2] * toCenter[2]);
+    float along = toCenter[0] * meshlet.coneAxis[0] + toCenter[1] * meshlet.coneAxis[1] + toCenter[2] * meshlet.coneAxis[2];
+    return along >= meshlet.coneCutoff * distance + meshlet.radius;
+}
\ No newline at end of file
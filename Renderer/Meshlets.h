@@ -0,0 +1,16 @@
+#pragma once
+#include "ModelLoader.h"
+
+class ThreadPool;
+
+// Split every batch into meshlets of up to meshletMaxTriangles neighbouring triangles. Clusters grow
+// breadth-first over triangles sharing a vertex and only take triangles whose normal stays close
+// to the cluster's average, so the normal cones stay narrow. The triangles of each batch are
+// reordered so every meshlet is a contiguous index range; batches keep their ranges.
+void buildMeshlets(const std::vector<MeshVertex>& meshVertices, std::vector<uint32_t>& indices,
+    std::vector<MeshBatch>& batches, ThreadPool& pool, std::vector<Meshlet>& outMeshlets);
+
+// True when every triangle of the meshlet faces away from an eye at the given point (model space)
+bool meshletFacesAway(const Meshlet& meshlet, const float eye[3]);
+
+const uint32_t meshletMaxTriangles = 128;                                                // Triangles per meshlet at most
\ No newline at end of file
@@ -1,20 +1,95 @@
 #include "ModelLoader.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "ThreadPool.h"
+#include "MeshCache.h"
+#include "StreamingLoader.h"
+#include "MeshWelder.h"
+#include "LoaderArena.h"
+#include "Decompressor.h"
+#include "RenderBackend.h"
+#include "FrustumCulling.h"
+#include "Instancing.h"
+#include "CachedLines.h"
+#include "DepthPrepass.h"
+#include "VertexAnimation.h"
 #include <stdio.h>
 #include <string.h>
 #include <algorithm>
 #include <freeglut.h>
+#include <float.h>
+#include <math.h>
+#include <chrono>
 
 // Model data containers
 std::vector<Vertex> vertices = { {0, 0, 0} };                                            // Start with dummy vertex at index 0
 std::vector<TextureCoord> textureCoords = { {0, 0} };                                    // Start with dummy texture coordinate at index 0
 std::vector<Normal> normals = { {0, 0, 0} };                                             // Start with dummy normal at index 0
 std::vector<Face> faces;                                                                 // Collection of faces
+Bounds modelBounds = { {0, 0, 0}, {0, 0, 0} };                                           // Bounds of all model vertices
+std::vector<MeshVertex> meshVertices;                                                    // Welded interleaved vertices
+std::vector<uint32_t> meshIndices;                                                       // Triangle lists of every level into meshVertices
+std::vector<Material> materials;                                                         // Materials, [0] is the default material
+std::vector<MaterialRun> materialRuns;                                                   // Material of every face, as runs
+std::vector<char> materialLibraryPaths;                                                  // MTL files the materials were read from, each NUL-terminated
+std::vector<MeshBatch> meshBatches;                                                      // Index ranges of meshIndices, sorted by material
+std::vector<Submesh> submeshes;                                                          // Parts of the model with their own bounds
+std::vector<SubmeshRun> submeshRuns;                                                     // Submesh of every face, as runs
+std::vector<Meshlet> meshlets;                                                           // Triangle clusters of every batch
+std::vector<MeshLod> meshLods;                                                           // Levels of detail, [0] is the full mesh
+
+// White ambient and diffuse, as the glColor-tracked material in setupLighting renders untextured models
+const Material defaultMaterial = { "default", { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f },
+    { 0.5f, 0.5f, 0.5f, 1.0f }, 50.0f };
+const Submesh defaultSubmesh = { "default", 0, 0, { {0, 0, 0}, {0, 0, 0} } };            // Ranges and bounds filled by weldModel
+uint32_t modelVersion = 0;                                                               // Incremented whenever the model data changes
 
 // Model transformation variables
 float modelX = 0.0f, modelY = 0.0f, modelZ = 0.0f;                                       // Model position
 float modelRotX = 0.0f, modelRotY = 0.0f, modelRotZ = 0.0f;                              // Model rotation angles
 float modelScale = 1.0f;                                                                 // Model scale factor
 
+// Release every model container and restore the empty model (dummy entries, default material and submesh)
+void clearModelData() {
+    std::vector<Vertex>(1, Vertex{ 0, 0, 0 }).swap(vertices);                            // Swap releases the old capacity
+    std::vector<TextureCoord>(1, TextureCoord{ 0, 0 }).swap(textureCoords);
+    std::vector<Normal>(1, Normal{ 0, 0, 0 }).swap(normals);
+    std::vector<Face>().swap(faces);
+    std::vector<MeshVertex>().swap(meshVertices);                                        // Welded mesh is rebuilt after loading
+    std::vector<uint32_t>().swap(meshIndices);
+    std::vector<MeshBatch>().swap(meshBatches);
+    std::vector<Material>(1, defaultMaterial).swap(materials);
+    std::vector<MaterialRun>().swap(materialRuns);
+    std::vector<char>().swap(materialLibraryPaths);
+    std::vector<Submesh>(1, defaultSubmesh).swap(submeshes);
+    std::vector<SubmeshRun>().swap(submeshRuns);
+    std::vector<Meshlet>().swap(meshlets);
+    std::vector<MeshLod>().swap(meshLods);
+    modelBounds = { {0, 0, 0}, {0, 0, 0} };
+    modelVersion++;                                                                      // GPU copies are stale
+}
+
+// Bytes held by the model containers (capacity, so growth slack is included)
+size_t modelMemoryBytes() {
+    return vertices.capacity() * sizeof(Vertex) + textureCoords.capacity() * sizeof(TextureCoord) +
+        normals.capacity() * sizeof(Normal) + faces.capacity() * sizeof(Face) +
+        meshVertices.capacity() * sizeof(MeshVertex) + meshIndices.capacity() * sizeof(uint32_t) +
+        meshBatches.capacity() * sizeof(MeshBatch) + materials.capacity() * sizeof(Material) +
+        materialRuns.capacity() * sizeof(MaterialRun) + materialLibraryPaths.capacity() + submeshes.capacity() * sizeof(Submesh) +
+        submeshRuns.capacity() * sizeof(SubmeshRun) + meshlets.capacity() * sizeof(Meshlet) +
+        meshLods.capacity() * sizeof(MeshLod);
+}
+
+// Print the peak loader memory of the last load and the memory the loaded model keeps
+void reportModelMemory() {
+    size_t steadyBytes = modelMemoryBytes();                                             // Containers after loading
+    checkpointLoaderMemory(steadyBytes);
+    size_t triangles = meshLods.empty() ? 0 : meshLods[0].indexCount / 3;                // Full-detail triangles
+    printf("Memory: peak %.2f MB while loading, %.2f MB steady state (%.1f bytes per triangle)\n",
+        loaderPeakBytes() / (1024.0 * 1024.0), steadyBytes / (1024.0 * 1024.0),
+        triangles ? (double)steadyBytes / triangles : 0.0);
+}
+
 // Reset model transformations to default values
 void resetModel() {
     modelX = 0.0f;                                                                       // Reset X position
@@ -26,8 +101,61 @@ void resetModel() {
     modelScale = 1.0f;                                                                   // Reset scale
 }
 
-// Load OBJ file and parse its contents
+// Recompute modelBounds from the vertices (skipping the dummy at index 0)
+void computeModelBounds() {
+    if (vertices.size() <= 1) {                                                          // Empty model
+        modelBounds = { {0, 0, 0}, {0, 0, 0} };
+        return;
+    }
+    Bounds bounds = { {FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX} };     // Start inverted
+    for (size_t i = 1; i < vertices.size(); i++) {
+        const float position[3] = { vertices[i].x, vertices[i].y, vertices[i].z };
+        for (int axis = 0; axis < 3; axis++) {
+            bounds.min[axis] = std::min(bounds.min[axis], position[axis]);               // Grow minimum
+            bounds.max[axis] = std::max(bounds.max[axis], position[axis]);               // Grow maximum
+        }
+    }
+    modelBounds = bounds;                                                                // Publish bounds
+}
+
+// Load OBJ file by mapping it into memory and tokenizing it in place
 bool loadOBJ(const char* filename) {
+    MappedFile file;                                                                     // Read-only view of the whole file
+    if (!file.open(filename)) {                                                          // Check if file mapped successfully
+        printf("Error opening file: %s\n", filename);                                    // Print error message
+        return false;                                                                    // Return failure
+    }
+
+    // Clear previous model data
+    clearModelData();                                                                    // Release containers, keep the dummy entries
+
+    // Reset model transformations
+    resetModel();                                                                        // Reset position, rotation, and scale
+
+    // Parse newline-aligned chunks of the mapped text on all cores and merge them in file order
+    std::vector<ObjNamedRecord> records;                                                 // "mtllib" and "usemtl" records
+    CompressionFormat compression = compressionFormatOf(filename);                       // ".obj.gz" / ".obj.zst"
+    if (compression != COMPRESSION_NONE) {                                               // Parse blocks while the rest is decompressed
+        if (!parseCompressedOBJText(compression, file.data(), file.size(), sharedThreadPool(),
+            vertices, textureCoords, normals, faces, records)) {
+            clearModelData();                                                            // Drop the partial model
+            return false;
+        }
+    }
+    else {
+        parseOBJText(file.data(), file.data() + file.size(), sharedThreadPool(), vertices, textureCoords, normals, faces, records);
+    }
+    loadOBJMaterials(filename, records, materials, materialRuns, materialLibraryPaths);  // Material runs for batching
+    loadOBJSubmeshes(records, faces.size(), submeshes, submeshRuns);                     // Submesh runs from "o"/"g" records
+
+    printf("Loaded model: %s\n", filename);                                              // Print success message
+    printf("Vertices: %zu, Texture Coords: %zu, Normals: %zu, Faces: %zu\n",
+        vertices.size() - 1, textureCoords.size() - 1, normals.size() - 1, faces.size()); // Print model statistics
+    return true;                                                                         // Return success
+}
+
+// Load OBJ file with the original fgets/sscanf_s parser (kept for benchmarking)
+bool loadOBJLegacy(const char* filename) {
     FILE* file;                                                                          // File handle
     errno_t err = fopen_s(&file, filename, "r");                                         // Open file for reading
     if (err != 0 || file == NULL) {                                                      // Check if file opened successfully
@@ -36,10 +164,7 @@ bool loadOBJ(const char* filename) {
     }
 
     // Clear previous model data
-    vertices = { {0, 0, 0} };                                                            // Reset vertices with dummy at index 0
-    textureCoords = { {0, 0} };                                                          // Reset texture coordinates with dummy at index 0
-    normals = { {0, 0, 0} };                                                             // Reset normals with dummy at index 0
-    faces.clear();                                                                       // Clear all faces
+    clearModelData();                                                                    // Release containers, keep the dummy entries
 
     // Reset model transformations
     resetModel();                                                                        // Reset position, rotation, and scale
@@ -152,16 +277,9 @@ bool loadOBJ(const char* filename) {
 #if _WIN64
 // Load an FBX format 3D model file
 bool loadFBX(const char* filename) {
-    // Clear existing model data
-    vertices.clear();
-    textureCoords.clear();
-    normals.clear();
-    faces.clear();
-
-    // Add dummy elements at index 0 since FBX indices start at 0 but our system expects 1-based
-    vertices.push_back({ 0.0f, 0.0f, 0.0f });
-    textureCoords.push_back({ 0.0f, 0.0f });
-    normals.push_back({ 0.0f, 0.0f, 0.0f });
+    // Clear existing model data; the dummy elements at index 0 stay since FBX indices start at 0
+    // but our system expects 1-based (FBX materials and nodes are not imported)
+    clearModelData();
 
     // Initialize FBX SDK manager
     FbxManager* fbxManager = FbxManager::Create();
@@ -353,40 +471,159 @@ void loadNewModel() {
     printf("Enter model file path (OBJ or FBX format): ");
     scanf_s("%255s", filename, (unsigned)_countof(filename));
 
-    // Get file extension
-    const char* extension = strrchr(filename, '.');
+    cancelStreamingLoad();                                                               // Replace any model still arriving
+    const char* extension = strrchr(filename, '.');                                      // OBJ files can be shown while they load
+    if (streamingLoadEnabled && extension && _stricmp(extension, ".obj") == 0) {
+        if (!startStreamingLoad(filename)) {
+            printf("Failed to load model: %s\n", filename);
+        }
+        return;
+    }
+    if (!loadModelFile(filename)) {
+        printf("Failed to load model: %s\n", filename);
+    }
+}
+
+// Load OBJ or FBX file, using the binary sidecar cache when it matches the source contents
+bool loadModelFile(const char* filename) {
+    // Get file extension (of "model.obj" for "model.obj.gz")
+    CompressionFormat compression = compressionFormatOf(filename);                       // Compressed OBJ text
+    std::string baseName = stripCompressionSuffix(filename);                             // Name without the compression suffix
+    const char* extension = strrchr(baseName.c_str(), '.');
     if (!extension) {
         printf("Error: File has no extension. Please specify .obj or .fbx file.\n");
-        return;
+        return false;
+    }
+    bool isOBJ = _stricmp(extension, ".obj") == 0;                                       // Text OBJ model
+    bool isFBX = _stricmp(extension, ".fbx") == 0 && compression == COMPRESSION_NONE;    // Binary or ASCII FBX model
+    if (!isCompressionSupported(compression)) {
+        printf("Error: This build cannot read .zst files (add zstd under Libs\\zstd and rebuild).\n");
+        return false;
+    }
+#if !_WIN64
+    isFBX = false;                                                                       // FBX SDK is only linked on x64
+#endif
+    if (!isOBJ && !isFBX) {
+        printf("Error: Unsupported file format. Only .obj (optionally .gz/.zst) and .fbx are supported.\n");
+        return false;
+    }
+
+    // Hash the source so a stale sidecar is never used
+    auto start = std::chrono::steady_clock::now();                                       // Start load timer
+    beginLoaderMemoryTracking();                                                         // Peak memory of this load only
+    uint64_t sourceHash = 0, sourceSize = 0;                                             // Identity of the source contents
+    {
+        MappedFile source;                                                               // Mapping closed before parsing
+        if (!source.open(filename)) {
+            printf("Error opening file: %s\n", filename);                                // Print error message
+            return false;
+        }
+        sourceSize = source.size();
+        sourceHash = hashFileContents(source.data(), source.size());
+    }
+
+    if (loadMeshCache(filename, sourceHash, sourceSize)) {                               // Sidecar written for these exact bytes
+        resetModel();                                                                    // Reset position, rotation, and scale
+        printf("Loaded model from cache: %s (%.1f ms)\n", filename,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        printf("Vertices: %zu, Texture Coords: %zu, Normals: %zu, Faces: %zu\n",
+            vertices.size() - 1, textureCoords.size() - 1, normals.size() - 1, faces.size()); // Print model statistics
+        reportModelMemory();
+        return true;
     }
 
     // Load based on file extension
     bool success = false;
-    if (_stricmp(extension, ".obj") == 0) {
-        success = loadOBJ(filename);
-    }
 #if _WIN64
-    else if (_stricmp(extension, ".fbx") == 0) {
+    if (isFBX) {
         success = loadFBX(filename);
     }
+    else
 #endif
-    else {
-        printf("Error: Unsupported file format. Only .obj and .fbx are supported.\n");
-        return;
+    {
+        success = loadOBJ(filename);
+    }
+    if (!success) {
+        return false;
     }
 
-    if (success) {
-        // Reset model position and orientation after loading
-        resetModel();
+    // Reset model position and orientation after loading
+    resetModel();
+    computeModelBounds();                                                                // Bounds are stored in the sidecar
+    weldModel();                                                                         // Single index buffer for indexed drawing
+    printf("Load time: %.1f ms\n",
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    reportModelMemory();                                                                 // Peak and steady-state bytes
+    saveMeshCache(filename, sourceHash, sourceSize);                                     // Next load of this file skips parsing
+    return true;
+}
+
+// Replace the model with a square grid of cubeCount cubes (0.8 units wide, 1.5 apart on the XZ plane), one
+// submesh ("o") each, cycling through materialCount generated materials. Every cube is its own draw range,
+// which makes it the submission-bound scene of the multi-draw indirect benchmark.
+void generateCubeScene(size_t cubeCount, size_t materialCount) {
+    static const float cubeNormals[6][3] = { { 0, 0, -1 }, { 0, 0, 1 }, { 0, -1, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { -1, 0, 0 } };
+    static const int cubeFaces[6][4] = {                                                 // Corners of every side, outward counter-clockwise
+        { 0, 3, 2, 1 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 }, { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 } };
+    const float cubeSize = 0.8f, cubeSpacing = 1.5f;
+
+    auto start = std::chrono::steady_clock::now();                                       // Start generation timer
+    beginLoaderMemoryTracking();
+    cancelStreamingLoad();                                                               // The scene replaces the model containers
+    clearModelData();
+    resetModel();
+
+    for (const float* normal : cubeNormals) normals.push_back({ normal[0], normal[1], normal[2] });
+    materialCount = std::max(materialCount, (size_t)1);
+    for (size_t m = 0; m < materialCount; m++) {
+        float hue = (float)m / materialCount;                                            // Spread the colors around the hue circle
+        Material material = defaultMaterial;
+        snprintf(material.name, sizeof(material.name), "cube%zu", m);
+        for (int k = 0; k < 3; k++) {
+            material.ambient[k] = 0.2f;
+            material.diffuse[k] = 0.55f + 0.35f * cosf(6.2831853f * (hue - k / 3.0f));
+        }
+        material.shininess = 30.0f * 128.0f / 1000.0f;                                   // Ns 30, as the MTL loader scales it
+        materials.push_back(material);
     }
-    else {
-        printf("Failed to load model: %s\n", filename);
+
+    size_t rowLength = (size_t)ceil(sqrt((double)cubeCount));                            // Cubes per grid row
+    vertices.reserve(1 + cubeCount * 8);
+    faces.reserve(cubeCount * 6);
+    std::vector<ObjNamedRecord> records(cubeCount);                                      // One object per cube
+    for (size_t i = 0; i < cubeCount; i++) {
+        const float origin[3] = { (i % rowLength) * cubeSpacing, 0.0f, (i / rowLength) * cubeSpacing };
+        int firstVertex = (int)vertices.size();
+        for (int corner = 0; corner < 8; corner++) {
+            vertices.push_back({ origin[0] + ((corner + 1) & 2 ? cubeSize : 0.0f),
+                origin[1] + (corner & 2 ? cubeSize : 0.0f), origin[2] + (corner & 4 ? cubeSize : 0.0f) });
+        }
+        records[i] = { (unsigned)faces.size(), OBJ_RECORD_OBJECT, "cube" + std::to_string(i) };
+        int32_t material = (int32_t)(1 + i % materialCount);                             // Index 0 is the default material
+        if (materialRuns.empty() || materialRuns.back().material != material) materialRuns.push_back({ (uint32_t)faces.size(), material });
+        for (int side = 0; side < 6; side++) {
+            Face face;
+            for (int corner = 0; corner < 4; corner++) {
+                face.vertexIndices[corner] = firstVertex + cubeFaces[side][corner];
+                face.textureIndices[corner] = 0;                                         // Dummy texture coordinate
+                face.normalIndices[corner] = 1 + side;
+            }
+            face.vertexCount = 4;
+            faces.push_back(face);
+        }
     }
+    loadOBJSubmeshes(records, faces.size(), submeshes, submeshRuns);
+
+    computeModelBounds();
+    weldModel();
+    printf("Generated scene: %zu cubes, %zu materials (%.1f ms)\n", cubeCount, materialCount,
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    reportModelMemory();
 }
 
 // Function to render the 3D model with current transformations
 void drawModel() {
-    // Enable two-sided rendering for better model visibility
+    // Enable two-sided rendering for better model visibility; the backends cull back faces of closed batches only
     glDisable(GL_CULL_FACE);                                                             // Disable face culling to show both sides
 
     // Apply model transformations in proper order: scale, rotate, translate
@@ -397,7 +634,33 @@ void drawModel() {
     glRotatef(modelRotZ, 0.0f, 0.0f, 1.0f);                                              // Apply rotation around Z axis
     glScalef(modelScale, modelScale, modelScale);                                        // Apply uniform scaling
 
-    // Iterate through all faces in the model
+    // Draw the visible part of the welded mesh through the selected render backend when it has been built,
+    // or every visible copy of it in instancing mode
+    if (!meshIndices.empty()) {
+        static std::vector<DrawRange> visibleRanges;                                     // Visible submeshes and meshlets
+        glDisable(GL_COLOR_MATERIAL);                                                    // Batches set the material explicitly
+        if (!instances.empty()) {
+            cullModelInstances();                                                        // Cull once, draw once per pass
+            auto submitStart = std::chrono::steady_clock::now();
+            drawWithDepthPrepass(drawModelInstances);
+            renderStats.submitMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitStart).count();
+        }
+        else {
+            cullModelRanges(visibleRanges);
+            RenderBackend& backend = renderBackend(currentRenderBackend());
+            streamAnimatedVertices();                                                    // Deformed vertices for both passes, when animating
+            auto submitStart = std::chrono::steady_clock::now();
+            drawWithDepthPrepass([&] { backend.drawRanges(visibleRanges.data(), visibleRanges.size()); });
+            renderStats.submitMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitStart).count();
+            finishAnimatedFrame();
+        }
+        applyMaterial(defaultMaterial);                                                  // Restore the setupLighting material
+        glEnable(GL_COLOR_MATERIAL);
+        glPopMatrix();                                                                   // Restore previous transformation matrix
+        return;
+    }
+
+    // Iterate through all faces in the model (used while a model is still streaming in)
     for (const auto& face : faces) {
         if (face.vertexCount == 3) {                                                     // If face is a triangle
             // Draw triangle
@@ -452,39 +715,34 @@ void drawModel() {
     glPopMatrix();                                                                       // Restore previous transformation matrix
 }
 
+// Grid lines built by the last drawWireGrid call, rebuilt only when its parameters change
+static CachedLines gridLines;                                                            // Cached grid geometry
+static float gridSize = 0.0f, gridY = 0.0f;                                              // Parameters of gridLines
+static int gridDivisions = 0;
+
 // Function to draw a reference grid on the XZ plane
 void drawWireGrid(float size, int divisions, float y) {
-    // Disable lighting for the grid to ensure consistent appearance
-    glDisable(GL_LIGHTING);                                                              // Turn off lighting for grid drawing
-
-    // Set grid color (light gray)
-    glColor3f(0.7f, 0.7f, 0.7f);                                                         // Set color to light gray
-
-    // Draw in wireframe mode
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);                                           // Set polygon mode to wireframe
-
-    float halfSize = size / 2.0f;                                                        // Calculate half of grid size
-    float step = size / divisions;                                                       // Calculate cell size
-
-    glBegin(GL_QUADS);                                                                   // Begin drawing quads
-    for (int x = 0; x < divisions; x++) {                                                // Iterate through grid cells in X direction
-        for (int z = 0; z < divisions; z++) {                                            // Iterate through grid cells in Z direction
-            float x1 = -halfSize + x * step;                                             // Calculate left edge of cell
-            float x2 = x1 + step;                                                        // Calculate right edge of cell
-            float z1 = -halfSize + z * step;                                             // Calculate front edge of cell
-            float z2 = z1 + step;                                                        // Calculate back edge of cell
-
-            // Draw grid cell as a quad
-            glVertex3f(x1, y, z1);                                                       // Bottom-left corner
-            glVertex3f(x2, y, z1);                                                       // Bottom-right corner
-            glVertex3f(x2, y, z2);                                                       // Top-right corner
-            glVertex3f(x1, y, z2);                                                       // Top-left corner
+    // Build the divisions + 1 lines along each axis once; every later frame replays the cached buffer
+    if (!gridLines.isBuilt() || size != gridSize || divisions != gridDivisions || y != gridY) {
+        float halfSize = size / 2.0f;                                                    // Calculate half of grid size
+        float step = size / divisions;                                                   // Calculate cell size
+        std::vector<LineVertex> lines;                                                   // Two vertices per grid line
+        for (int i = 0; i <= divisions; i++) {
+            float offset = -halfSize + i * step;                                         // Position of the i-th line
+            lines.push_back({ { offset, y, -halfSize }, { 0.7f, 0.7f, 0.7f } });         // Line parallel to Z
+            lines.push_back({ { offset, y, halfSize }, { 0.7f, 0.7f, 0.7f } });
+            lines.push_back({ { -halfSize, y, offset }, { 0.7f, 0.7f, 0.7f } });         // Line parallel to X
+            lines.push_back({ { halfSize, y, offset }, { 0.7f, 0.7f, 0.7f } });
         }
+        gridLines.build(lines);                                                          // Light gray, as before
+        gridSize = size;
+        gridDivisions = divisions;
+        gridY = y;
     }
-    glEnd();                                                                             // End quad drawing
 
-    // Reset polygon mode to filled
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);                                           // Restore default polygon mode
+    // Disable lighting for the grid to ensure consistent appearance
+    glDisable(GL_LIGHTING);                                                              // Turn off lighting for grid drawing
+    gridLines.draw();                                                                    // Draw the cached lines
 
     // Re-enable lighting for subsequent rendering
     glEnable(GL_LIGHTING);                                                               // Turn lighting back on
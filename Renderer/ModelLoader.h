@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cstdint>
 #if _WIN64
 #include <fbxsdk.h>
 #endif
@@ -25,11 +26,99 @@ struct Face {
     int vertexCount;                                                                     // Number of vertices (3 for triangle, 4 for quad)
 };
 
+// Interleaved vertex of the welded mesh (one per unique v/vt/vn corner)
+struct MeshVertex {
+    float position[3];                                                                   // 3D position coordinates
+    float normal[3];                                                                     // Normal vector components
+    float texCoord[2];                                                                   // 2D texture coordinates
+};
+
+// Surface material from an MTL library (fixed-size name so it can be cached as plain data)
+struct Material {
+    char name[64];                                                                       // "newmtl" name
+    float ambient[4];                                                                    // Ka (alpha from d)
+    float diffuse[4];                                                                    // Kd (alpha from d)
+    float specular[4];                                                                   // Ks
+    float shininess;                                                                     // Ns scaled to the OpenGL 0-128 range
+};
+
+// Faces from firstFace up to the next run's firstFace use one material
+struct MaterialRun {
+    uint32_t firstFace;                                                                  // First face of the run
+    int32_t material;                                                                    // Index into materials
+};
+
+// Faces from firstFace up to the next run's firstFace belong to one submesh
+struct SubmeshRun {
+    uint32_t firstFace;                                                                  // First face of the run
+    int32_t submesh;                                                                     // Index into submeshes
+};
+
+// Contiguous range of meshIndices drawn with one material
+struct MeshBatch {
+    int32_t material;                                                                    // Index into materials
+    uint32_t firstIndex;                                                                 // First entry in meshIndices
+    uint32_t indexCount;                                                                 // Number of indices (3 per triangle)
+    int32_t submesh;                                                                     // Submesh the range belongs to
+    uint32_t firstMeshlet;                                                               // First entry in meshlets
+    uint32_t meshletCount;                                                               // Meshlets tiling the range
+    uint32_t closed;                                                                     // 1 when every triangle lies on a closed, consistently wound surface
+};
+
+// Cluster of up to 128 neighbouring triangles of one batch with its culling bounds. The cluster faces
+// away from an eye at e when dot(center - e, coneAxis) >= coneCutoff * |center - e| + radius.
+struct Meshlet {
+    uint32_t firstIndex;                                                                 // First entry in meshIndices
+    uint32_t indexCount;                                                                 // Number of indices (3 per triangle)
+    float center[3];                                                                     // Bounding sphere center
+    float radius;                                                                        // Bounding sphere radius
+    float coneAxis[3];                                                                   // Average face normal (unit length)
+    float coneCutoff;                                                                    // Sine of the cone half angle, 1 disables the test
+};
+
+// Level of detail: meshBatches[firstBatch, firstBatch + batchCount) hold one simplified copy of every
+// full-detail batch, in the same order and over the same meshVertices. Level 0 is the full mesh.
+struct MeshLod {
+    uint32_t firstBatch;                                                                 // First entry in meshBatches
+    uint32_t batchCount;                                                                 // Batches of the level (one per level 0 batch)
+    uint32_t firstIndex;                                                                 // First entry in meshIndices
+    uint32_t indexCount;                                                                 // Number of indices (3 per triangle)
+    float error;                                                                         // Largest estimated deviation from the full mesh
+};
+
+// Axis-aligned bounding box
+struct Bounds {
+    float min[3];                                                                        // Smallest x, y, z
+    float max[3];                                                                        // Largest x, y, z
+};
+
+// Part of the model from an OBJ "o"/"g" record; its batches cover one contiguous index range
+struct Submesh {
+    char name[64];                                                                       // "object/group" name
+    uint32_t firstIndex;                                                                 // First entry in meshIndices
+    uint32_t indexCount;                                                                 // Number of indices (3 per triangle)
+    Bounds bounds;                                                                       // Bounds of the referenced vertices
+};
+
 // Model data containers
 extern std::vector<Vertex> vertices;                                                     // Collection of vertices
 extern std::vector<TextureCoord> textureCoords;                                          // Collection of texture coordinates
 extern std::vector<Normal> normals;                                                      // Collection of normal vectors
 extern std::vector<Face> faces;                                                          // Collection of faces
+extern Bounds modelBounds;                                                               // Bounds of all model vertices
+extern std::vector<MeshVertex> meshVertices;                                             // Welded interleaved vertices
+extern std::vector<uint32_t> meshIndices;                                                // Triangle lists of every level into meshVertices
+extern std::vector<Material> materials;                                                  // Materials, [0] is the default material
+extern std::vector<MaterialRun> materialRuns;                                            // Material of every face, as runs
+extern std::vector<char> materialLibraryPaths;                                           // MTL files the materials were read from, each NUL-terminated
+extern std::vector<MeshBatch> meshBatches;                                               // Index ranges of meshIndices, sorted by material
+extern std::vector<Submesh> submeshes;                                                   // Parts of the model with their own bounds
+extern std::vector<SubmeshRun> submeshRuns;                                              // Submesh of every face, as runs
+extern std::vector<Meshlet> meshlets;                                                    // Triangle clusters of every batch
+extern std::vector<MeshLod> meshLods;                                                    // Levels of detail, [0] is the full mesh
+extern const Material defaultMaterial;                                                   // Material matching setupLighting
+extern const Submesh defaultSubmesh;                                                     // Single part of models without groups
+extern uint32_t modelVersion;                                                            // Incremented whenever the model data changes
 
 // Model transformation variables
 extern float modelX, modelY, modelZ;                                                     // Model position
@@ -38,8 +127,15 @@ extern float modelScale;
 
 // Function declarations
 bool loadOBJ(const char* filename);                                                      // Load OBJ file
+bool loadOBJLegacy(const char* filename);                                                // Load OBJ file with the original line-based parser
 bool loadFBX(const char* filename);                                                      // Load FBX file
+bool loadModelFile(const char* filename);                                                // Load OBJ or FBX file, using the binary sidecar cache when valid
+void generateCubeScene(size_t cubeCount, size_t materialCount);                          // Replace the model with a grid of cubes, one submesh each
 void loadNewModel();                                                                     // Load a new model from user input
+void computeModelBounds();                                                               // Recompute modelBounds from the vertices
+void clearModelData();                                                                   // Release all model containers and restore the empty model
+size_t modelMemoryBytes();                                                               // Bytes held by the model containers
+void reportModelMemory();                                                                // Print peak loader memory and steady-state model memory
 void resetModel();                                                                       // Reset model transformations
 void drawModel();                                                                        // Render the model
 void drawWireGrid(float size, int divisions, float y);                                   // Draw a reference grid on the XZ plane
@@ -47,4 +143,4 @@ void drawWireGrid(float size, int divisions, float y);
 // Helper function for FBX loading
 #if _WIN64
 void ProcessFbxNode(FbxNode* node);
-#endif
+#endif
\ No newline at end of file
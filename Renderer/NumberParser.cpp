@@ -0,0 +1,298 @@
+#include "NumberParser.h"
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <charconv>
+
+// Pick the widest character classifier the compiler targets
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NUMBER_BLOCK_SIZE 32                                                             // Bytes classified per AVX2 block
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define NUMBER_BLOCK_SIZE 16                                                             // Bytes classified per SSE2 block
+#else
+#define NUMBER_BLOCK_SIZE 16                                                             // Bytes classified per scalar block
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// The fast paths read up to one block plus eight bytes past the start of a token
+static const ptrdiff_t fastPathMargin = NUMBER_BLOCK_SIZE + 16;
+
+// Bit masks of character classes for one block of text (bit i describes byte i)
+struct CharClassMasks {
+    uint32_t digits;                                                                     // '0'..'9'
+    uint32_t signs;                                                                      // '+' or '-'
+    uint32_t dots;                                                                       // '.'
+    uint32_t exponents;                                                                  // 'e' or 'E'
+    uint32_t slashes;                                                                    // '/'
+};
+
+// Exact powers of ten representable in a double
+static const double powersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Integer powers of ten for combining digit groups
+static const uint64_t integerPowersOfTen[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull
+};
+
+// Index of the lowest set bit (mask must be non-zero)
+static inline unsigned lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;                                                                 // Bit position
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// Number of consecutive set bits in mask starting at bit i
+static inline unsigned runLength(uint32_t mask, unsigned i) {
+    uint32_t clear = ~(mask >> i);                                                       // First clear bit ends the run
+    return clear ? lowestBit(clear) : 32 - i;                                            // Whole 32-bit block set
+}
+
+// Classify one block of text; p must have NUMBER_BLOCK_SIZE readable bytes
+static inline CharClassMasks classifyBlock(const char* p) {
+    CharClassMasks masks;                                                                // Result masks
+#if defined(__AVX2__)
+    __m256i chars = _mm256_loadu_si256((const __m256i*)p);                               // Load 32 bytes
+    __m256i offset = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));                      // Digits map to 0..9
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(9)), offset);
+    masks.digits = (uint32_t)_mm256_movemask_epi8(isDigit);
+    masks.signs = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+        _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('-')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('+'))));
+    masks.dots = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('.')));
+    masks.exponents = (uint32_t)_mm256_movemask_epi8(                                    // 'e' and 'E' differ only in bit 5
+        _mm256_cmpeq_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('e')));
+    masks.slashes = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/')));
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+    __m128i chars = _mm_loadu_si128((const __m128i*)p);                                  // Load 16 bytes
+    __m128i offset = _mm_sub_epi8(chars, _mm_set1_epi8('0'));                            // Digits map to 0..9
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(9)), offset);    // Unsigned offset <= 9
+    masks.digits = (uint32_t)_mm_movemask_epi8(isDigit);
+    masks.signs = (uint32_t)_mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(chars, _mm_set1_epi8('-')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('+'))));
+    masks.dots = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('.')));
+    masks.exponents = (uint32_t)_mm_movemask_epi8(                                       // 'e' and 'E' differ only in bit 5
+        _mm_cmpeq_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('e')));
+    masks.slashes = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('/')));
+#else
+    masks.digits = masks.signs = masks.dots = masks.exponents = masks.slashes = 0;
+    for (int i = 0; i < NUMBER_BLOCK_SIZE; i++) {                                        // Portable fallback
+        char c = p[i];
+        if ((unsigned)(c - '0') < 10u) masks.digits |= 1u << i;
+        if (c == '-' || c == '+') masks.signs |= 1u << i;
+        if (c == '.') masks.dots |= 1u << i;
+        if ((c | 0x20) == 'e') masks.exponents |= 1u << i;
+        if (c == '/') masks.slashes |= 1u << i;
+    }
+#endif
+    return masks;
+}
+
+// Value of exactly eight ASCII digits (SWAR: pairs, then quads, then the full group)
+static inline uint32_t eightDigitsValue(uint64_t chunk) {
+    chunk = (chunk & 0x0F0F0F0F0F0F0F0Full) * 2561 >> 8;                                 // Combine digit pairs
+    chunk = (chunk & 0x00FF00FF00FF00FFull) * 6553601 >> 16;                             // Combine pairs into quads
+    return (uint32_t)((chunk & 0x0000FFFF0000FFFFull) * 42949672960001ull >> 32);        // Combine quads
+}
+
+// Value of count (0..8) ASCII digits at p; reads eight bytes
+static inline uint32_t digitsValue(const char* p, unsigned count) {
+    if (count == 0) return 0;                                                            // Empty digit run
+    uint64_t chunk;                                                                      // Eight bytes starting at p
+    memcpy(&chunk, p, 8);
+    chunk <<= (8 - count) * 8;                                                           // Drop trailing bytes, pad with leading zeros
+    return eightDigitsValue(chunk);
+}
+
+// Append a run of count digits to an accumulated integer
+static inline uint64_t appendDigits(uint64_t value, const char* p, unsigned count) {
+    while (count >= 8) {                                                                 // Whole groups of eight digits
+        value = value * 100000000ull + digitsValue(p, 8);
+        p += 8;
+        count -= 8;
+    }
+    return value * integerPowersOfTen[count] + digitsValue(p, count);                    // Remaining digits
+}
+
+// Convert mantissa * 10^exponent to the correctly rounded float, or return false when unsure
+static inline bool decimalToFloat(uint64_t mantissa, int exponent, bool negative, float& value) {
+    if (mantissa == 0) {                                                                 // Zero with any exponent
+        value = negative ? -0.0f : 0.0f;
+        return true;
+    }
+    if (mantissa > (1ull << 53) || exponent < -22 || exponent > 22) {                    // Outside the exact double range
+        return false;
+    }
+
+    // Mantissa and power of ten are exact doubles, so one operation gives the correctly rounded double
+    double result = exponent < 0 ? (double)mantissa / powersOfTen[-exponent] : (double)mantissa * powersOfTen[exponent];
+    if (result < FLT_MIN || result > FLT_MAX) {                                          // Subnormal or overflowing float
+        return false;
+    }
+
+    // Rounding twice is only wrong when the double landed exactly halfway between two floats,
+    // i.e. when the 29 mantissa bits a float drops are exactly 1000...0
+    uint64_t bits;                                                                       // Bit pattern of the double
+    memcpy(&bits, &result, sizeof(bits));
+    if ((bits & 0x1FFFFFFFull) == 0x10000000ull) {
+        return false;
+    }
+    float rounded = (float)result;                                                       // Second rounding to float
+    value = negative ? -rounded : rounded;                                               // Apply sign
+    return true;
+}
+
+// Slow path: std::from_chars is correctly rounded but does not accept a leading '+'
+static const char* parseFloatFallback(const char* p, const char* end, float& value) {
+    const char* start = p;                                                               // Position to return on failure
+    if (p < end && *p == '+') p++;                                                       // Skip explicit plus sign
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec == std::errc::invalid_argument) return start;                          // Not a number
+    if (result.ec == std::errc::result_out_of_range) value = 0.0f;                       // Clamp unrepresentable values to zero
+    return result.ptr;
+}
+
+// Parse a decimal float starting at p
+const char* parseFloat(const char* p, const char* end, float& value) {
+    if (end - p < fastPathMargin) {                                                      // Too close to the end for block loads
+        return parseFloatFallback(p, end, value);
+    }
+
+    CharClassMasks masks = classifyBlock(p);                                             // Classify the block at the token
+    unsigned i = 0;                                                                      // Current byte within the block
+    bool negative = false;                                                               // Sign of the mantissa
+    if (masks.signs & 1u) {                                                              // Optional leading sign
+        negative = (*p == '-');
+        i = 1;
+    }
+
+    unsigned integerStart = i;                                                           // First integer digit
+    unsigned integerDigits = runLength(masks.digits, i);                                 // Digits before the dot
+    i += integerDigits;
+    unsigned fractionStart = i;                                                          // First fraction digit
+    unsigned fractionDigits = 0;                                                         // Digits after the dot
+    if (i < NUMBER_BLOCK_SIZE && (masks.dots >> i & 1u)) {
+        fractionStart = ++i;                                                             // Skip the dot
+        fractionDigits = i < NUMBER_BLOCK_SIZE ? runLength(masks.digits, i) : 0;
+        i += fractionDigits;
+    }
+    if (integerDigits + fractionDigits == 0) {                                           // No mantissa digits: not a number
+        return p;
+    }
+
+    int exponent = 0;                                                                    // Explicit decimal exponent
+    if (i < NUMBER_BLOCK_SIZE && (masks.exponents >> i & 1u)) {
+        unsigned j = i + 1;                                                              // Candidate exponent start
+        bool negativeExponent = false;
+        if (j < NUMBER_BLOCK_SIZE && (masks.signs >> j & 1u)) {                          // Optional exponent sign
+            negativeExponent = (p[j] == '-');
+            j++;
+        }
+        if (j >= NUMBER_BLOCK_SIZE) {                                                    // Exponent continues past the block
+            return parseFloatFallback(p, end, value);
+        }
+        unsigned exponentDigits = runLength(masks.digits, j);                            // Digits after 'e' and sign
+        if (exponentDigits > 0 && exponentDigits <= 4) {                                 // "1e" alone ends before the 'e'
+            exponent = (int)digitsValue(p + j, exponentDigits);
+            if (negativeExponent) exponent = -exponent;
+            i = j + exponentDigits;
+        }
+        else if (exponentDigits > 4) {                                                   // Extreme exponents take the slow path
+            return parseFloatFallback(p, end, value);
+        }
+    }
+    if (i >= NUMBER_BLOCK_SIZE || integerDigits + fractionDigits > 19) {                 // Token may continue past the block
+        return parseFloatFallback(p, end, value);
+    }
+
+    uint64_t mantissa = appendDigits(0, p + integerStart, integerDigits);                // Integer digits
+    mantissa = appendDigits(mantissa, p + fractionStart, fractionDigits);                // Fraction digits
+    if (!decimalToFloat(mantissa, exponent - (int)fractionDigits, negative, value)) {
+        return parseFloatFallback(p, end, value);                                        // Needs full-precision conversion
+    }
+    return p + i;                                                                        // Continue after the number
+}
+
+// Parse a signed integer with a plain scalar loop (used near the end of the buffer)
+static const char* parseIntScalar(const char* p, const char* end, int& value) {
+    const char* start = p;                                                               // Position to return on failure
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {                                           // Optional sign
+        negative = (*p == '-');
+        p++;
+    }
+    const char* digits = p;                                                              // First digit
+    int result = 0;                                                                      // Accumulated magnitude
+    while (p < end && (unsigned)(*p - '0') < 10u) {
+        result = result * 10 + (*p - '0');
+        p++;
+    }
+    if (p == digits) return start;                                                       // No digits
+    value = negative ? -result : result;                                                 // Apply sign
+    return p;
+}
+
+// Parse a signed decimal integer
+const char* parseInt(const char* p, const char* end, int& value) {
+    if (end - p < fastPathMargin) {                                                      // Too close to the end for block loads
+        return parseIntScalar(p, end, value);
+    }
+    CharClassMasks masks = classifyBlock(p);                                             // Classify the block at the token
+    unsigned i = masks.signs & 1u;                                                       // Skip optional sign
+    unsigned digits = runLength(masks.digits, i);                                        // Length of the digit run
+    if (digits == 0) return p;                                                           // No digits
+    if (digits > 9) return parseIntScalar(p, end, value);                                // Beyond the fast conversion range
+    int result = (int)digitsValue(p + i, digits);                                        // SWAR conversion
+    value = (i && *p == '-') ? -result : result;                                         // Apply sign
+    return p + i + digits;
+}
+
+// Scalar version of parseIndexGroup (used near the end of the buffer)
+static const char* parseIndexGroupScalar(const char* p, const char* end, int values[3]) {
+    values[0] = values[1] = values[2] = 0;                                               // Missing fields read as 0
+    const char* next = parseIntScalar(p, end, values[0]);                                // First field is required
+    if (next == p) return p;
+    p = next;
+    for (int field = 1; field < 3 && p < end && *p == '/'; field++) {                    // Optional further fields
+        p = parseIntScalar(p + 1, end, values[field]);                                   // Empty field leaves 0
+    }
+    return p;
+}
+
+// Parse "a", "a/b", "a//c" or "a/b/c" using one block classification for the whole group
+const char* parseIndexGroup(const char* p, const char* end, int values[3]) {
+    if (end - p < fastPathMargin) {                                                      // Too close to the end for block loads
+        return parseIndexGroupScalar(p, end, values);
+    }
+    CharClassMasks masks = classifyBlock(p);                                             // Digits, signs and '/' separators
+    values[0] = values[1] = values[2] = 0;                                               // Missing fields read as 0
+    unsigned i = 0;                                                                      // Current byte within the block
+    for (int field = 0; field < 3; field++) {
+        if (i + 1 >= NUMBER_BLOCK_SIZE) return parseIndexGroupScalar(p, end, values);    // Group may continue past the block
+        unsigned sign = (masks.signs >> i) & 1u;                                         // Optional sign
+        unsigned digits = runLength(masks.digits, i + sign);                             // Length of the digit run
+        if (digits > 9) return parseIndexGroupScalar(p, end, values);                    // Beyond the fast conversion range
+        if (digits == 0) {
+            if (field == 0) return p;                                                    // First field is required
+        }
+        else {
+            int magnitude = (int)digitsValue(p + i + sign, digits);                      // SWAR conversion
+            values[field] = (sign && p[i] == '-') ? -magnitude : magnitude;              // Apply sign
+            i += sign + digits;
+        }
+        if (i >= NUMBER_BLOCK_SIZE - 1) return parseIndexGroupScalar(p, end, values);    // Group may continue past the block
+        if (field == 2 || !(masks.slashes >> i & 1u)) break;                             // No further separator
+        i++;                                                                             // Skip the '/'
+    }
+    return p + i;
+}
\ No newline at end of file
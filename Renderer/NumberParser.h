@@ -0,0 +1,12 @@
+#pragma once
+#include <stddef.h>
+
+// Number parsing kernel shared by the text model loaders. Each call classifies a block of
+// 16 bytes (32 with AVX2) into digit, sign, dot, exponent and '/' masks with SIMD compares,
+// converts digit runs eight at a time, and falls back to std::from_chars whenever the fast
+// path cannot guarantee the correctly rounded result. None of the functions skip leading
+// blanks; all of them return the position after the parsed text, or p when nothing was parsed.
+
+const char* parseFloat(const char* p, const char* end, float& value);                    // Decimal float ("-1.5", "2e-3", ".5")
+const char* parseInt(const char* p, const char* end, int& value);                        // Signed decimal integer
+const char* parseIndexGroup(const char* p, const char* end, int values[3]);              // "a", "a/b", "a//c" or "a/b/c"; empty fields read as 0
\ No newline at end of file
@@ -0,0 +1,547 @@
+#include "ObjParser.h"
+#include "ThreadPool.h"
+#include "NumberParser.h"
+#include "MappedFile.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+// Skip spaces and tabs inside a line
+static inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;                                    // Advance past blank characters
+    return p;                                                                            // Return first non-blank position
+}
+
+// Parse one floating point field; a missing or malformed field reads as 0. end may lie past the line: the
+// blanks and the number both stop at the newline, and a distant end keeps the kernel on its block loads,
+// which need fastPathMargin bytes that few lines have on their own.
+static inline const char* parseFloatField(const char* p, const char* end, float& value) {
+    p = skipBlanks(p, end);                                                              // Fields are separated by blanks
+    const char* next = parseFloat(p, end, value);                                        // SIMD number kernel
+    if (next == p) value = 0.0f;                                                         // Treat missing component as zero
+    return next;                                                                         // Continue after the number
+}
+
+ObjChunk::ObjChunk()
+    : arena(new LoaderArena()), vertices(*arena), textureCoords(*arena), normals(*arena), faces(*arena), fixups(*arena) {
+}
+
+// Return the position after keyword when the record at p is that keyword followed by a blank, else nullptr
+static inline const char* matchKeyword(const char* p, const char* end, const char* keyword) {
+    size_t length = strlen(keyword);                                                     // Keyword length
+    if ((size_t)(end - p) <= length || memcmp(p, keyword, length) != 0) return nullptr;  // Different record
+    if (p[length] != ' ' && p[length] != '\t') return nullptr;                           // Longer keyword with the same prefix
+    return p + length;
+}
+
+// Rest of a record line with surrounding blanks and the carriage return removed
+static std::string parseNameField(const char* p, const char* end) {
+    p = skipBlanks(p, end);                                                              // Leading blanks
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;     // Trailing blanks and CR
+    return std::string(p, end);
+}
+
+// One parsed face corner and which of its indices were relative in the file
+struct ObjCorner {
+    int index[3];                                                                        // Vertex, texture coordinate and normal index
+    int relativeMask;                                                                    // Bit i set when index[i] is chunk-local
+};
+
+// Resolve an index against a chunk holding count records; relative indices become chunk-local
+static inline int resolveIndex(int index, size_t count, int bit, int& relativeMask) {
+    if (index >= 0) return index;                                                        // Absolute (or missing) index
+    relativeMask |= bit;                                                                 // Needs the chunk base added later
+    return (int)count + 1 + index;                                                       // -1 refers to the most recent record
+}
+
+// Parse a "v/vt/vn" corner token; returns false when no corner starts at p
+static inline bool parseFaceCorner(const char*& p, const char* end, int& v, int& vt, int& vn) {
+    p = skipBlanks(p, end);                                                              // Corners are separated by blanks
+    int indices[3];                                                                      // Vertex, texture coordinate and normal index
+    const char* next = parseIndexGroup(p, end, indices);                                 // Digits and '/' separators in one pass
+    if (next == p) {                                                                     // Corner must start with an index
+        return false;                                                                    // End of face line
+    }
+    v = indices[0];                                                                      // Missing attributes are 0 (the dummy entry)
+    vt = indices[1];
+    vn = indices[2];
+    p = next;                                                                            // Continue after the corner
+    return true;                                                                         // Corner parsed
+}
+
+// Copy one corner into slot i of a face
+static inline void setFaceCorner(Face& face, int i, const ObjCorner& corner) {
+    face.vertexIndices[i] = corner.index[0];                                             // Vertex index
+    face.textureIndices[i] = corner.index[1];                                            // Texture coordinate index
+    face.normalIndices[i] = corner.index[2];                                             // Normal index
+}
+
+// Append a face and record fixups for its chunk-local indices
+static void addFace(const Face& face, const ObjCorner* const corners[4], ObjChunk& chunk) {
+    unsigned faceIndex = (unsigned)chunk.faces.size();                                   // Index the face will get
+    for (int i = 0; i < face.vertexCount; i++) {
+        for (int attribute = 0; attribute < 3; attribute++) {
+            if (corners[i]->relativeMask & (1 << attribute)) {                           // Index was relative in the file
+                chunk.fixups.push_back({ faceIndex, (unsigned char)i, (unsigned char)attribute });
+            }
+        }
+    }
+    chunk.faces.push_back(face);                                                         // Add face to collection
+}
+
+// Parse the corners of an "f" line; triangles and quads map to one Face, larger polygons are fanned into triangles.
+// Like parseFloatField, end may be the end of the text: the corners stop at the newline.
+static void parseFaceLine(const char* p, const char* end, ObjChunk& chunk) {
+    ObjCorner corners[4];                                                                // First four corners of the polygon
+    int count = 0;                                                                       // Number of corners read so far
+    int v, vt, vn;                                                                       // Indices of the current corner
+
+    while (parseFaceCorner(p, end, v, vt, vn)) {                                         // Single pass over the face line
+        ObjCorner corner;                                                                // Resolved corner
+        corner.relativeMask = 0;
+        corner.index[0] = resolveIndex(v, chunk.vertices.size(), 1, corner.relativeMask);
+        corner.index[1] = resolveIndex(vt, chunk.textureCoords.size(), 2, corner.relativeMask);
+        corner.index[2] = resolveIndex(vn, chunk.normals.size(), 4, corner.relativeMask);
+
+        if (count < 4) {                                                                 // Still collecting a triangle or quad
+            corners[count] = corner;                                                     // Store corner
+        }
+        else {                                                                           // Polygon with more than four corners
+            Face face;                                                                   // Fan triangle (first, previous, current)
+            face.vertexCount = 3;                                                        // Emit as triangle
+            face.vertexIndices[3] = face.textureIndices[3] = face.normalIndices[3] = 0;  // Unused fourth slot
+            if (count == 4) {                                                            // First overflow: split the stored quad
+                for (int t = 0; t < 2; t++) {                                            // Triangles (0,1,2) and (0,2,3)
+                    const ObjCorner* fan[4] = { &corners[0], &corners[1 + t], &corners[2 + t], nullptr };
+                    for (int i = 0; i < 3; i++) setFaceCorner(face, i, *fan[i]);         // Fan center, previous, current
+                    addFace(face, fan, chunk);                                           // Add fan triangle
+                }
+            }
+            const ObjCorner* fan[4] = { &corners[0], &corners[3], &corner, nullptr };
+            for (int i = 0; i < 3; i++) setFaceCorner(face, i, *fan[i]);                 // Fan center, previous, current
+            addFace(face, fan, chunk);                                                   // Add fan triangle
+            corners[3] = corner;                                                         // Current becomes previous
+        }
+        count++;                                                                         // Count corner
+    }
+
+    if (count == 3 || count == 4) {                                                      // Triangle or quad
+        Face face;                                                                       // Create new face
+        face.vertexCount = count;                                                        // Number of corners
+        const ObjCorner* slots[4] = { &corners[0], &corners[1], &corners[2], &corners[3] };
+        for (int i = 0; i < 4; i++) {                                                    // Fill all slots (unused ones are 0)
+            if (i < count) {
+                setFaceCorner(face, i, corners[i]);                                      // Copy parsed corner
+            }
+            else {
+                face.vertexIndices[i] = face.textureIndices[i] = face.normalIndices[i] = 0;
+            }
+        }
+        addFace(face, slots, chunk);                                                     // Add face to collection
+    }
+}
+
+// Parse one slice of OBJ text in place into a chunk
+void parseOBJChunk(const char* begin, const char* end, ObjChunk& chunk) {
+    const char* p = begin;                                                               // Current line start
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', end - p);                     // Find end of the current line
+        if (!lineEnd) lineEnd = end;                                                     // Last line without newline
+
+        const char* q = skipBlanks(p, lineEnd);                                          // First character of the record
+        if (lineEnd - q >= 2) {                                                          // Shortest record is "f " or "v "
+            if (q[0] == 'v') {
+                if (q[1] == ' ' || q[1] == '\t') {                                       // Line defines a vertex
+                    Vertex vertex;                                                       // Create new vertex
+                    q = parseFloatField(q + 1, end, vertex.x);                           // Parse X coordinate
+                    q = parseFloatField(q, end, vertex.y);                               // Parse Y coordinate
+                    parseFloatField(q, end, vertex.z);                                   // Parse Z coordinate
+                    chunk.vertices.push_back(vertex);                                    // Add vertex to collection
+                }
+                else if (q[1] == 't' && lineEnd - q >= 3 && (q[2] == ' ' || q[2] == '\t')) { // Line defines a texture coordinate
+                    TextureCoord texCoord;                                               // Create new texture coordinate
+                    q = parseFloatField(q + 2, end, texCoord.u);                         // Parse U coordinate
+                    parseFloatField(q, end, texCoord.v);                                 // Parse V coordinate
+                    chunk.textureCoords.push_back(texCoord);                             // Add texture coordinate to collection
+                }
+                else if (q[1] == 'n' && lineEnd - q >= 3 && (q[2] == ' ' || q[2] == '\t')) { // Line defines a normal vector
+                    Normal normal;                                                       // Create new normal
+                    q = parseFloatField(q + 2, end, normal.x);                           // Parse X component
+                    q = parseFloatField(q, end, normal.y);                               // Parse Y component
+                    parseFloatField(q, end, normal.z);                                   // Parse Z component
+                    chunk.normals.push_back(normal);                                     // Add normal to collection
+                }
+            }
+            else if (q[0] == 'f' && (q[1] == ' ' || q[1] == '\t')) {                     // Line defines a face
+                parseFaceLine(q + 1, end, chunk);                                        // Parse corners and add faces
+            }
+            else if ((q[0] == 'o' || q[0] == 'g') && (q[1] == ' ' || q[1] == '\t')) {    // Line starts an object or group
+                chunk.records.push_back({ (unsigned)chunk.faces.size(), q[0] == 'o' ? OBJ_RECORD_OBJECT : OBJ_RECORD_GROUP,
+                    parseNameField(q + 1, lineEnd) });
+            }
+            else if (const char* name = matchKeyword(q, lineEnd, "usemtl")) {            // Line selects a material
+                chunk.records.push_back({ (unsigned)chunk.faces.size(), OBJ_RECORD_USE_MATERIAL, parseNameField(name, lineEnd) });
+            }
+            else if (const char* name = matchKeyword(q, lineEnd, "mtllib")) {            // Line names material libraries
+                const char* token = skipBlanks(name, lineEnd);
+                while (token < lineEnd && *token != '\r') {                              // One record per file name
+                    const char* tokenEnd = token;
+                    while (tokenEnd < lineEnd && *tokenEnd != ' ' && *tokenEnd != '\t' && *tokenEnd != '\r') tokenEnd++;
+                    chunk.records.push_back({ (unsigned)chunk.faces.size(), OBJ_RECORD_MATERIAL_LIBRARY, std::string(token, tokenEnd) });
+                    token = skipBlanks(tokenEnd, lineEnd);
+                }
+            }
+        }
+
+        p = lineEnd + 1;                                                                 // Continue with the next line
+    }
+}
+
+// Copy a chunk's records into their slice of the output containers and rebase its relative indices
+static void mergeOBJChunk(const ObjChunk& chunk, const size_t base[4],
+    std::vector<Vertex>& outVertices, std::vector<TextureCoord>& outTextureCoords,
+    std::vector<Normal>& outNormals, std::vector<Face>& outFaces) {
+    chunk.vertices.copyTo(outVertices.data() + base[0]);                                 // Segment-wise copies into the final arrays
+    chunk.textureCoords.copyTo(outTextureCoords.data() + base[1]);
+    chunk.normals.copyTo(outNormals.data() + base[2]);
+    chunk.faces.copyTo(outFaces.data() + base[3]);
+
+    chunk.fixups.forEach([&](const ObjIndexFixup& fixup) {                               // Only relative indices depend on earlier chunks
+        Face& face = outFaces[base[3] + fixup.faceIndex];                                // Face in the output
+        int* indices = fixup.attribute == 0 ? face.vertexIndices :
+            fixup.attribute == 1 ? face.textureIndices : face.normalIndices;             // Index array of the attribute
+        indices[fixup.corner] += (int)(base[fixup.attribute] - 1);                       // Shift past records of earlier chunks (minus the dummy)
+    });
+}
+
+// Append a chunk's named records, rebasing their face indices past the faces of earlier chunks
+static void appendOBJRecords(const ObjChunk& chunk, size_t faceBase, std::vector<ObjNamedRecord>& outRecords) {
+    for (const ObjNamedRecord& record : chunk.records) {
+        outRecords.push_back({ (unsigned)(faceBase + record.faceIndex), record.kind, record.name });
+    }
+}
+
+// Append a parsed chunk after the records already in the containers
+void appendOBJChunk(const ObjChunk& chunk,
+    std::vector<Vertex>& outVertices, std::vector<TextureCoord>& outTextureCoords,
+    std::vector<Normal>& outNormals, std::vector<Face>& outFaces, std::vector<ObjNamedRecord>& outRecords) {
+    const size_t base[4] = { outVertices.size(), outTextureCoords.size(), outNormals.size(), outFaces.size() };
+    outVertices.resize(base[0] + chunk.vertices.size());                                 // Grow every container once per chunk
+    outTextureCoords.resize(base[1] + chunk.textureCoords.size());
+    outNormals.resize(base[2] + chunk.normals.size());
+    outFaces.resize(base[3] + chunk.faces.size());
+    mergeOBJChunk(chunk, base, outVertices, outTextureCoords, outNormals, outFaces);     // Copy and rebase relative indices
+    appendOBJRecords(chunk, base[3], outRecords);                                        // Materials of the new faces
+}
+
+// Find the start of the line following position p (or end)
+const char* nextOBJLineStart(const char* p, const char* end) {
+    if (p >= end) return end;                                                            // Already at the end
+    const char* newline = (const char*)memchr(p, '\n', end - p);                         // Next line break
+    return newline ? newline + 1 : end;
+}
+
+// Bytes held by the output arrays a parse fills (which need not be the global model containers)
+static size_t objOutputBytes(const std::vector<Vertex>& vertices, const std::vector<TextureCoord>& textureCoords,
+    const std::vector<Normal>& normals, const std::vector<Face>& faces, const std::vector<ObjNamedRecord>& records) {
+    return vertices.capacity() * sizeof(Vertex) + textureCoords.capacity() * sizeof(TextureCoord) +
+        normals.capacity() * sizeof(Normal) + faces.capacity() * sizeof(Face) + records.capacity() * sizeof(ObjNamedRecord);
+}
+
+// Parse OBJ text on a thread pool and merge the chunks deterministically in file order
+void parseOBJText(const char* begin, const char* end, ThreadPool& pool,
+    std::vector<Vertex>& outVertices, std::vector<TextureCoord>& outTextureCoords,
+    std::vector<Normal>& outNormals, std::vector<Face>& outFaces, std::vector<ObjNamedRecord>& outRecords) {
+    const size_t minChunkSize = 1 << 20;                                                 // Small files are not worth splitting
+    size_t length = (size_t)(end - begin);                                               // Total text size
+    size_t chunkCount = std::min((size_t)pool.threadCount() * 4, length / minChunkSize + 1); // A few chunks per thread for load balance
+
+    // Split into newline-aligned slices so no line straddles two chunks
+    std::vector<const char*> bounds(chunkCount + 1);                                     // Slice i is [bounds[i], bounds[i + 1])
+    bounds[0] = begin;
+    bounds[chunkCount] = end;
+    for (size_t i = 1; i < chunkCount; i++) {
+        const char* split = std::max(begin + length / chunkCount * i, bounds[i - 1]);    // Nominal split point
+        bounds[i] = nextOBJLineStart(split, end);                                        // Move to the next line start
+    }
+
+    // Parse all chunks independently
+    std::vector<ObjChunk> chunks(chunkCount);                                            // Per-chunk records
+    pool.parallelFor(chunkCount, [&](size_t i) {
+        parseOBJChunk(bounds[i], bounds[i + 1], chunks[i]);
+    });
+
+    // Prefix sums of the record counts give every chunk its output offsets
+    std::vector<size_t> bases(chunkCount * 4);                                           // v, vt, vn and face offsets per chunk
+    size_t totals[4] = { outVertices.size(), outTextureCoords.size(), outNormals.size(), outFaces.size() };
+    for (size_t i = 0; i < chunkCount; i++) {
+        size_t counts[4] = { chunks[i].vertices.size(), chunks[i].textureCoords.size(),
+            chunks[i].normals.size(), chunks[i].faces.size() };
+        for (int k = 0; k < 4; k++) {
+            bases[i * 4 + k] = totals[k];                                                // Chunk starts after all earlier records
+            totals[k] += counts[k];
+        }
+    }
+
+    // Named records are few; append them in file order before the chunks are released
+    for (size_t i = 0; i < chunkCount; i++) {
+        appendOBJRecords(chunks[i], bases[i * 4 + 3], outRecords);
+    }
+
+    // Size every output once, then copy the chunks into place in parallel
+    outVertices.resize(totals[0]);
+    outTextureCoords.resize(totals[1]);
+    outNormals.resize(totals[2]);
+    outFaces.resize(totals[3]);
+    checkpointLoaderMemory(objOutputBytes(outVertices, outTextureCoords, outNormals, outFaces, outRecords)); // Chunks and outputs are both alive here
+    pool.parallelFor(chunkCount, [&](size_t i) {
+        mergeOBJChunk(chunks[i], &bases[i * 4], outVertices, outTextureCoords, outNormals, outFaces);
+        chunks[i] = ObjChunk();                                                          // Release chunk memory early
+    });
+}
+
+// Decompressed text handed from the decompression thread to the parser, in file order
+struct ObjTextBlockQueue {
+    std::mutex mutex;                                                                    // Guards the fields below
+    std::condition_variable changed;                                                     // Signals a push, a pop or the end
+    std::deque<std::vector<char>> blocks;                                                // Newline-aligned text blocks
+    size_t capacity;                                                                     // Blocks buffered before the producer waits
+    bool finished;                                                                       // Producer is done (no more blocks)
+    bool failed;                                                                         // Input was corrupt or truncated
+};
+
+// Parse a compressed OBJ buffer while it is being decompressed
+bool parseCompressedOBJText(CompressionFormat format, const char* data, size_t size, ThreadPool& pool,
+    std::vector<Vertex>& outVertices, std::vector<TextureCoord>& outTextureCoords,
+    std::vector<Normal>& outNormals, std::vector<Face>& outFaces, std::vector<ObjNamedRecord>& outRecords) {
+    const size_t blockSize = 4 << 20;                                                    // Text per parse task
+    ObjTextBlockQueue queue;
+    queue.capacity = pool.threadCount() * 2;                                             // One batch in parsing, one being filled
+    queue.finished = queue.failed = false;
+
+    // Producer: cut the decompressed stream into blocks that end at a line break
+    std::thread producer([&] {
+        std::vector<char> block;                                                         // Block being filled
+        block.reserve(blockSize + (blockSize >> 2));
+        auto push = [&](std::vector<char>& text) {                                       // Wait for room, then queue the block
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.changed.wait(lock, [&] { return queue.blocks.size() < queue.capacity; });
+            queue.blocks.push_back(std::move(text));
+            queue.changed.notify_all();
+        };
+        bool ok = decompressBuffer(format, data, size, [&](const char* bytes, size_t count) {
+            block.insert(block.end(), bytes, bytes + count);
+            if (block.size() < blockSize) return true;
+            const char* lastBreak = block.data() + block.size();                         // Split after the last complete line
+            while (lastBreak > block.data() && lastBreak[-1] != '\n') lastBreak--;
+            if (lastBreak == block.data()) return true;                                  // One very long line: keep growing
+            std::vector<char> tail(lastBreak, (const char*)block.data() + block.size()); // Partial line starts the next block
+            block.resize(lastBreak - block.data());
+            push(block);
+            block.swap(tail);
+            block.reserve(blockSize + (blockSize >> 2));
+            return true;
+        });
+        if (ok && !block.empty()) push(block);                                           // Last line may lack a line break
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.failed = !ok;
+        queue.finished = true;
+        queue.changed.notify_all();
+    });
+
+    // Consumer: parse up to one block per thread at a time and append the chunks in order
+    std::vector<std::vector<char>> batch;                                                // Blocks parsed together
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.changed.wait(lock, [&] { return !queue.blocks.empty() || queue.finished; });
+            if (queue.blocks.empty()) break;                                             // Finished and drained
+            while (!queue.blocks.empty() && batch.size() < pool.threadCount()) {
+                batch.push_back(std::move(queue.blocks.front()));
+                queue.blocks.pop_front();
+            }
+            queue.changed.notify_all();                                                  // Producer may refill while we parse
+        }
+        std::vector<ObjChunk> chunks(batch.size());
+        pool.parallelFor(batch.size(), [&](size_t i) {
+            parseOBJChunk(batch[i].data(), batch[i].data() + batch[i].size(), chunks[i]);
+        });
+        for (size_t i = 0; i < chunks.size(); i++) {
+            appendOBJChunk(chunks[i], outVertices, outTextureCoords, outNormals, outFaces, outRecords);
+            chunks[i] = ObjChunk();                                                      // Release chunk memory early
+        }
+        checkpointLoaderMemory(objOutputBytes(outVertices, outTextureCoords, outNormals, outFaces, outRecords));
+        batch.clear();
+    }
+    producer.join();
+    if (queue.failed) {
+        printf("Error: compressed data is corrupt or truncated\n");
+    }
+    return !queue.failed;
+}
+
+// Copy a material name into the fixed-size field, truncating long names
+static void setMaterialName(Material& material, const std::string& name) {
+    size_t length = std::min(name.size(), sizeof(material.name) - 1);                    // Leave room for the terminator
+    memcpy(material.name, name.data(), length);
+    material.name[length] = '\0';
+}
+
+// Parse three color components of a Ka/Kd/Ks line into an RGBA array (alpha untouched)
+static void parseColorField(const char* p, const char* end, float color[4]) {
+    for (int i = 0; i < 3; i++) p = parseFloatField(p, end, color[i]);                   // Red, green, blue
+}
+
+// Parse MTL text into materials (colors, specular exponent and dissolve; texture maps are ignored)
+static void parseMTLText(const char* begin, const char* end, std::vector<Material>& outMaterials) {
+    const char* p = begin;                                                               // Current line start
+    Material* material = nullptr;                                                        // Material being defined
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', end - p);                     // Find end of the current line
+        if (!lineEnd) lineEnd = end;                                                     // Last line without newline
+        const char* q = skipBlanks(p, lineEnd);                                          // First character of the statement
+
+        if (const char* name = matchKeyword(q, lineEnd, "newmtl")) {                     // Start a new material with MTL defaults
+            Material defined = { "", { 0.2f, 0.2f, 0.2f, 1.0f }, { 0.8f, 0.8f, 0.8f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 0.0f };
+            setMaterialName(defined, parseNameField(name, lineEnd));
+            outMaterials.push_back(defined);
+            material = &outMaterials.back();
+        }
+        else if (material) {
+            float value;                                                                 // Scalar statement argument
+            if (const char* args = matchKeyword(q, lineEnd, "Ka")) {                     // Ambient color
+                parseColorField(args, end, material->ambient);
+            }
+            else if (const char* args = matchKeyword(q, lineEnd, "Kd")) {                // Diffuse color
+                parseColorField(args, end, material->diffuse);
+            }
+            else if (const char* args = matchKeyword(q, lineEnd, "Ks")) {                // Specular color
+                parseColorField(args, end, material->specular);
+            }
+            else if (const char* args = matchKeyword(q, lineEnd, "Ns")) {                // Specular exponent (0-1000)
+                parseFloatField(args, end, value);
+                material->shininess = std::min(std::max(value * 128.0f / 1000.0f, 0.0f), 128.0f);
+            }
+            else if (const char* args = matchKeyword(q, lineEnd, "d")) {                 // Dissolve (opacity)
+                parseFloatField(args, end, value);
+                material->ambient[3] = material->diffuse[3] = value;
+            }
+            else if (const char* args = matchKeyword(q, lineEnd, "Tr")) {                // Transparency (1 - dissolve)
+                parseFloatField(args, end, value);
+                material->ambient[3] = material->diffuse[3] = 1.0f - value;
+            }
+        }
+
+        p = lineEnd + 1;                                                                 // Continue with the next line
+    }
+}
+
+// Load the MTL libraries of an OBJ file and turn its "usemtl" records into material runs
+void loadOBJMaterials(const char* objFilename, const std::vector<ObjNamedRecord>& records,
+    std::vector<Material>& outMaterials, std::vector<MaterialRun>& outRuns, std::vector<char>& outLibraryPaths) {
+    outMaterials.assign(1, defaultMaterial);                                             // Index 0 is always the default
+    outLibraryPaths.clear();
+    outRuns.assign(1, { 0, 0 });                                                         // Faces before any "usemtl"
+
+    // Libraries are looked up next to the OBJ file
+    std::string directory(objFilename);
+    size_t slash = directory.find_last_of("/\\");
+    directory = slash == std::string::npos ? std::string() : directory.substr(0, slash + 1);
+    for (const ObjNamedRecord& record : records) {
+        if (record.kind != OBJ_RECORD_MATERIAL_LIBRARY) continue;
+        std::string path = directory + record.name;                                      // Library path
+        outLibraryPaths.insert(outLibraryPaths.end(), path.c_str(), path.c_str() + path.size() + 1); // A missing library that appears later matters too
+        MappedFile library;
+        if (!library.open(path.c_str())) {
+            printf("Warning: Unable to open material library %s\n", path.c_str());       // Faces fall back to the default
+            continue;
+        }
+        parseMTLText(library.data(), library.data() + library.size(), outMaterials);
+    }
+
+    std::unordered_map<std::string, int32_t> materialIndex;                              // Name -> index, first definition wins
+    for (size_t i = 1; i < outMaterials.size(); i++) {
+        materialIndex.emplace(outMaterials[i].name, (int32_t)i);
+    }
+
+    for (const ObjNamedRecord& record : records) {
+        if (record.kind != OBJ_RECORD_USE_MATERIAL) continue;
+        std::string name = record.name.substr(0, sizeof(Material::name) - 1);            // Names are stored truncated
+        auto found = materialIndex.find(name);
+        int32_t material = found != materialIndex.end() ? found->second : 0;             // Unknown names use the default
+        if (outRuns.back().firstFace == record.faceIndex) {
+            outRuns.back().material = material;                                          // No faces since the previous "usemtl"
+        }
+        else if (outRuns.back().material != material) {
+            outRuns.push_back({ record.faceIndex, material });                           // New run
+        }
+        if (outRuns.size() >= 2 && outRuns[outRuns.size() - 2].material == outRuns.back().material) {
+            outRuns.pop_back();                                                          // Merged back into the previous run
+        }
+    }
+    printf("Materials: %zu\n", outMaterials.size() - 1);
+}
+
+// Turn the "o"/"g" records into named submeshes and face runs, dropping submeshes without faces
+void loadOBJSubmeshes(const std::vector<ObjNamedRecord>& records, size_t faceCount,
+    std::vector<Submesh>& outSubmeshes, std::vector<SubmeshRun>& outRuns) {
+    std::vector<std::string> names(1, "default");                                        // Faces before any "o"/"g"
+    std::vector<SubmeshRun> runs(1, { 0, 0 });                                           // Runs over all submeshes
+    std::unordered_map<std::string, int32_t> submeshIndex;                               // Name -> index
+    submeshIndex.emplace(names[0], 0);
+    std::string object, group;                                                           // Current "o" and "g" names
+
+    for (const ObjNamedRecord& record : records) {
+        if (record.kind == OBJ_RECORD_OBJECT) {
+            object = record.name;                                                        // New object starts without a group
+            group.clear();
+        }
+        else if (record.kind == OBJ_RECORD_GROUP) {
+            group = record.name;
+        }
+        else {
+            continue;
+        }
+        std::string name = group.empty() ? object : object.empty() ? group : object + "/" + group;
+        if (name.empty()) name = names[0];                                               // "g" without a name
+        int32_t submesh = submeshIndex.emplace(name, (int32_t)names.size()).first->second;
+        if (submesh == (int32_t)names.size()) names.push_back(name);                     // First use of the name
+        if (runs.back().firstFace == record.faceIndex) {
+            runs.back().submesh = submesh;                                               // No faces since the previous record
+        }
+        else if (runs.back().submesh != submesh) {
+            runs.push_back({ record.faceIndex, submesh });                               // New run
+        }
+        if (runs.size() >= 2 && runs[runs.size() - 2].submesh == runs.back().submesh) {
+            runs.pop_back();                                                             // Merged back into the previous run
+        }
+    }
+
+    // Keep submeshes that own faces, numbered in order of first use
+    std::vector<int32_t> remap(names.size(), -1);                                        // Old index -> kept index
+    outSubmeshes.clear();
+    outRuns.clear();
+    for (size_t r = 0; r < runs.size(); r++) {
+        uint32_t runEnd = r + 1 < runs.size() ? runs[r + 1].firstFace : (uint32_t)faceCount;
+        if (runs[r].firstFace >= runEnd) continue;                                       // Run without faces
+        int32_t& kept = remap[runs[r].submesh];
+        if (kept < 0) {
+            kept = (int32_t)outSubmeshes.size();
+            Submesh submesh = defaultSubmesh;                                            // Ranges and bounds filled by weldModel
+            size_t length = std::min(names[runs[r].submesh].size(), sizeof(submesh.name) - 1);
+            memcpy(submesh.name, names[runs[r].submesh].data(), length);
+            submesh.name[length] = '\0';
+            outSubmeshes.push_back(submesh);
+        }
+        if (outRuns.empty() || outRuns.back().submesh != kept) {
+            outRuns.push_back({ runs[r].firstFace, kept });
+        }
+    }
+    if (outSubmeshes.empty()) outSubmeshes.assign(1, defaultSubmesh);                    // Model without faces
+    printf("Submeshes: %zu\n", outSubmeshes.size());
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#include "ModelLoader.h"
+#include "LoaderArena.h"
+#include "Decompressor.h"
+#include <memory>
+
+class ThreadPool;
+
+// Face index that was written relative to the records before it (negative in the file).
+// Chunks resolve it against their own records; the merge adds the chunk's base offset.
+struct ObjIndexFixup {
+    unsigned faceIndex;                                                                  // Face within the chunk
+    unsigned char corner;                                                                // Corner slot within the face
+    unsigned char attribute;                                                             // 0 = vertex, 1 = texture coordinate, 2 = normal
+};
+
+// Kinds of named OBJ records that are kept for later stages
+enum ObjRecordKind : unsigned char {
+    OBJ_RECORD_MATERIAL_LIBRARY,                                                         // "mtllib": MTL file to load
+    OBJ_RECORD_USE_MATERIAL,                                                             // "usemtl": material of the faces that follow
+    OBJ_RECORD_OBJECT,                                                                   // "o": object of the faces that follow
+    OBJ_RECORD_GROUP,                                                                    // "g": group of the faces that follow
+};
+
+// Named record in file order; faceIndex is the first face after it
+struct ObjNamedRecord {
+    unsigned faceIndex;                                                                  // Faces from here on are affected
+    ObjRecordKind kind;                                                                  // What the name refers to
+    std::string name;                                                                    // Rest of the line, blanks trimmed
+};
+
+// Records parsed from one newline-aligned slice of an OBJ file (no dummy entries). The record
+// arrays live in the chunk's arena, so parsing never reallocates and the merge copies them once.
+struct ObjChunk {
+    ObjChunk();
+
+    std::unique_ptr<LoaderArena> arena;                                                  // Backs the arrays below, freed with the chunk
+    ArenaArray<Vertex> vertices;                                                         // "v" records in file order
+    ArenaArray<TextureCoord> textureCoords;                                              // "vt" records in file order
+    ArenaArray<Normal> normals;                                                          // "vn" records in file order
+    ArenaArray<Face> faces;                                                              // "f" records with absolute or chunk-local indices
+    ArenaArray<ObjIndexFixup> fixups;                                                    // Chunk-local indices to rebase during the merge
+    std::vector<ObjNamedRecord> records;                                                 // "mtllib"/"usemtl"/"o"/"g" with chunk-local face indices
+};
+
+// Parse one slice of OBJ text in place (no per-line copies) into a chunk
+void parseOBJChunk(const char* begin, const char* end, ObjChunk& chunk);
+
+// Append a parsed chunk after the records already in the containers (chunks must arrive in file order)
+void appendOBJChunk(const ObjChunk& chunk,
+    std::vector<Vertex>& outVertices, std::vector<TextureCoord>& outTextureCoords,
+    std::vector<Normal>& outNormals, std::vector<Face>& outFaces, std::vector<ObjNamedRecord>& outRecords);
+
+// Find the start of the line following position p (or end)
+const char* nextOBJLineStart(const char* p, const char* end);
+
+// Parse OBJ text on a thread pool: the text is split into newline-aligned chunks, each chunk is
+// parsed independently, and the chunks are merged in file order using prefix sums of their
+// v/vt/vn counts. The result is identical for any thread count. The containers must hold only
+// their dummy element at index 0.
+void parseOBJText(const char* begin, const char* end, ThreadPool& pool,
+    std::vector<Vertex>& outVertices, std::vector<TextureCoord>& outTextureCoords,
+    std::vector<Normal>& outNormals, std::vector<Face>& outFaces, std::vector<ObjNamedRecord>& outRecords);
+
+// Parse a compressed OBJ buffer while it is being decompressed: a producer thread inflates it into
+// newline-aligned text blocks (a bounded queue keeps memory flat) and the caller parses each batch
+// of blocks on the pool and appends the chunks in file order, so the result matches parseOBJText
+// on the decompressed text. Returns false if the data is corrupt or truncated.
+bool parseCompressedOBJText(CompressionFormat format, const char* data, size_t size, ThreadPool& pool,
+    std::vector<Vertex>& outVertices, std::vector<TextureCoord>& outTextureCoords,
+    std::vector<Normal>& outNormals, std::vector<Face>& outFaces, std::vector<ObjNamedRecord>& outRecords);
+
+// Load the MTL libraries named by "mtllib" records (relative to the OBJ file) and turn the
+// "usemtl" records into material runs. materials[0] is always the default material, which is
+// also used for faces before the first "usemtl" and for names no library defines. The paths of the
+// libraries (found or not) are returned NUL-terminated in outLibraryPaths, for the mesh cache key.
+void loadOBJMaterials(const char* objFilename, const std::vector<ObjNamedRecord>& records,
+    std::vector<Material>& outMaterials, std::vector<MaterialRun>& outRuns, std::vector<char>& outLibraryPaths);
+
+// Turn the "o"/"g" records into submeshes named "object/group" and runs assigning every face to
+// one. A name that reappears continues its submesh; submeshes without faces are dropped.
+void loadOBJSubmeshes(const std::vector<ObjNamedRecord>& records, size_t faceCount,
+    std::vector<Submesh>& outSubmeshes, std::vector<SubmeshRun>& outRuns);
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "OcclusionCulling.h"
+#include "ModelLoader.h"
+#include "RenderBackend.h"
+#include "ThreadPool.h"
+#include <freeglut.h>
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// SSE is part of every x64 target; other targets use the scalar loops
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define OCCLUSION_SSE 1
+#else
+#define OCCLUSION_SSE 0
+#endif
+
+bool occlusionCullingEnabled = false;                                                    // Test submeshes against the occluders
+bool showOcclusionBuffer = false;                                                        // Draw the occlusion buffer in the overlay
+
+static const size_t occluderTriangleBudget = 100000;                                     // Most triangles rasterized per frame
+static const float minOccluderArea = 64.0f;                                              // Smallest useful occluder, in texels of its box
+static const float minOccluderTexelsPerTriangle = 4.0f;                                  // Finer meshes cost more than they cover
+static const int occlusionBandRows = 8;                                                  // Rows rasterized by one task
+
+static std::vector<float> occlusionBuffer(occlusionBufferWidth * occlusionBufferHeight); // 1/w per texel, row 0 at the bottom
+static std::vector<float> rasterBuffer(occlusionBufferWidth * occlusionBufferHeight);    // Occluders before the erosion
+static bool occlusionBufferValid = false;                                                // Buffer holds a rasterized frame
+static GLuint occlusionTexture = 0;                                                      // Debug view of the buffer
+
+// Occluder triangle prepared for rasterization: three edge functions sampled at texel centers (x, y),
+// so neighbouring triangles leave no cracks, and the depth plane moved back by half a texel so that it
+// gives the farthest depth of the triangle's plane over each texel
+struct OccluderTriangle {
+    float edges[3][3];                                                                   // A, B, C of A * x + B * y + C >= 0
+    float depth[3];                                                                      // 1/w = a * x + b * y + c
+    int minX, maxX, minY, maxY;                                                          // Texel bounds (minX > maxX when skipped)
+};
+
+static std::vector<OccluderTriangle> occluderTriangles;                                  // Triangles of the current frame
+
+// Clip coordinates of a model-space point (column-major clip matrix)
+static inline void transformPoint(const float clip[16], const float* point, float out[4]) {
+    for (int row = 0; row < 4; row++) {
+        out[row] = clip[0 * 4 + row] * point[0] + clip[1 * 4 + row] * point[1] + clip[2 * 4 + row] * point[2] + clip[3 * 4 + row];
+    }
+}
+
+// Texel position and 1/w of a clip-space point; false when it lies behind the near plane
+static inline bool projectPoint(const float clipPoint[4], float& x, float& y, float& inverseW) {
+    if (clipPoint[3] <= 0.0f || clipPoint[2] < -clipPoint[3]) return false;
+    inverseW = 1.0f / clipPoint[3];
+    x = (clipPoint[0] * inverseW * 0.5f + 0.5f) * occlusionBufferWidth;
+    y = (clipPoint[1] * inverseW * 0.5f + 0.5f) * occlusionBufferHeight;
+    return true;
+}
+
+// Set up triangle t of meshIndices; triangles crossing the near plane are skipped (fewer occluders is safe)
+static void setupOccluderTriangle(const float clip[16], size_t t, OccluderTriangle& triangle) {
+    triangle.minX = 1;
+    triangle.maxX = 0;
+    float x[3], y[3], inverseW[3];
+    for (int corner = 0; corner < 3; corner++) {
+        float clipPoint[4];
+        transformPoint(clip, meshVertices[meshIndices[t * 3 + corner]].position, clipPoint);
+        if (!projectPoint(clipPoint, x[corner], y[corner], inverseW[corner])) return;
+    }
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (fabsf(area) < 1e-6f) return;                                                     // Degenerate on screen
+    if (area < 0.0f) {                                                                   // Either winding occludes
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(inverseW[1], inverseW[2]);
+        area = -area;
+    }
+
+    for (int edge = 0; edge < 3; edge++) {
+        int a = edge, b = (edge + 1) % 3;
+        float edgeA = y[a] - y[b], edgeB = x[b] - x[a];
+        triangle.edges[edge][0] = edgeA;
+        triangle.edges[edge][1] = edgeB;
+        triangle.edges[edge][2] = x[a] * y[b] - y[a] * x[b];
+    }
+    float depthX = ((inverseW[1] - inverseW[0]) * (y[2] - y[0]) - (inverseW[2] - inverseW[0]) * (y[1] - y[0])) / area;
+    float depthY = ((inverseW[2] - inverseW[0]) * (x[1] - x[0]) - (inverseW[1] - inverseW[0]) * (x[2] - x[0])) / area;
+    triangle.depth[0] = depthX;
+    triangle.depth[1] = depthY;
+    triangle.depth[2] = inverseW[0] - depthX * x[0] - depthY * y[0] - 0.5f * (fabsf(depthX) + fabsf(depthY)); // Farthest over the texel
+
+    float minX = std::min(x[0], std::min(x[1], x[2])), maxX = std::max(x[0], std::max(x[1], x[2]));
+    float minY = std::min(y[0], std::min(y[1], y[2])), maxY = std::max(y[0], std::max(y[1], y[2]));
+    triangle.minX = std::max(0, (int)ceilf(minX - 0.5f));                                // Texel centers inside the bounds
+    triangle.maxX = std::min(occlusionBufferWidth - 1, (int)floorf(maxX - 0.5f));
+    triangle.minY = std::max(0, (int)ceilf(minY - 0.5f));
+    triangle.maxY = std::min(occlusionBufferHeight - 1, (int)floorf(maxY - 0.5f));
+}
+
+// Rasterize every triangle into rows [firstRow, endRow), keeping the nearest depth per texel
+static void rasterizeBand(int firstRow, int endRow) {
+    for (const OccluderTriangle& triangle : occluderTriangles) {
+        if (triangle.minX > triangle.maxX) continue;
+        int rowStart = std::max(firstRow, triangle.minY), rowEnd = std::min(endRow - 1, triangle.maxY);
+        for (int row = rowStart; row <= rowEnd; row++) {
+            float centerY = row + 0.5f;
+            float* texels = &rasterBuffer[(size_t)row * occlusionBufferWidth];
+            int column = triangle.minX & ~3;                                             // Aligned start, so four texels never pass the row end
+#if OCCLUSION_SSE
+            __m128 rowEdge[3], edgeX[3];
+            for (int edge = 0; edge < 3; edge++) {
+                rowEdge[edge] = _mm_set1_ps(triangle.edges[edge][1] * centerY + triangle.edges[edge][2]);
+                edgeX[edge] = _mm_set1_ps(triangle.edges[edge][0]);
+            }
+            __m128 rowDepth = _mm_set1_ps(triangle.depth[1] * centerY + triangle.depth[2]);
+            __m128 depthX = _mm_set1_ps(triangle.depth[0]);
+            const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 zero = _mm_setzero_ps();
+            for (; column <= triangle.maxX; column += 4) {
+                __m128 centerX = _mm_add_ps(_mm_set1_ps((float)column), laneOffsets);
+                __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeX[0], centerX), rowEdge[0]), zero);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeX[1], centerX), rowEdge[1]), zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeX[2], centerX), rowEdge[2]), zero));
+                if (!_mm_movemask_ps(inside)) continue;
+                __m128 depth = _mm_and_ps(inside, _mm_add_ps(_mm_mul_ps(depthX, centerX), rowDepth)); // 0 outside
+                _mm_storeu_ps(texels + column, _mm_max_ps(_mm_loadu_ps(texels + column), depth));
+            }
+#else
+            for (; column <= triangle.maxX; column++) {
+                float centerX = column + 0.5f;
+                bool inside = true;
+                for (const float* edge : triangle.edges) inside = inside && edge[0] * centerX + edge[1] * centerY + edge[2] >= 0.0f;
+                if (inside) texels[column] = std::max(texels[column], triangle.depth[0] * centerX + triangle.depth[1] * centerY + triangle.depth[2]);
+            }
+#endif
+        }
+    }
+}
+
+// Occlusion buffer rows [firstRow, endRow): each texel takes the farthest depth of its 3x3 neighbourhood
+// in the rasterized buffer. Texels sampled as covered at their center but only partly covered along an
+// occluder's silhouette, or next to a deeper neighbour, then never hide anything behind the uncovered part.
+static void erodeBand(int firstRow, int endRow) {
+    for (int row = firstRow; row < endRow; row++) {
+        float* texels = &occlusionBuffer[(size_t)row * occlusionBufferWidth];
+        if (row == 0 || row == occlusionBufferHeight - 1) {                              // Neighbours beyond the edge are unknown
+            std::fill(texels, texels + occlusionBufferWidth, 0.0f);
+            continue;
+        }
+        const float* above = &rasterBuffer[(size_t)(row + 1) * occlusionBufferWidth];
+        const float* center = &rasterBuffer[(size_t)row * occlusionBufferWidth];
+        const float* below = &rasterBuffer[(size_t)(row - 1) * occlusionBufferWidth];
+        texels[0] = texels[occlusionBufferWidth - 1] = 0.0f;
+        int column = 1;
+#if OCCLUSION_SSE
+        for (; column + 4 <= occlusionBufferWidth - 1; column += 4) {
+            __m128 farthest = _mm_min_ps(_mm_loadu_ps(above + column - 1), _mm_loadu_ps(above + column));
+            farthest = _mm_min_ps(farthest, _mm_loadu_ps(above + column + 1));
+            farthest = _mm_min_ps(farthest, _mm_min_ps(_mm_loadu_ps(center + column - 1), _mm_loadu_ps(center + column)));
+            farthest = _mm_min_ps(farthest, _mm_loadu_ps(center + column + 1));
+            farthest = _mm_min_ps(farthest, _mm_min_ps(_mm_loadu_ps(below + column - 1), _mm_loadu_ps(below + column)));
+            farthest = _mm_min_ps(farthest, _mm_loadu_ps(below + column + 1));
+            _mm_storeu_ps(texels + column, farthest);
+        }
+#endif
+        for (; column < occlusionBufferWidth - 1; column++) {
+            float farthest = center[column];
+            for (int offset = -1; offset <= 1; offset++) {
+                farthest = std::min(farthest, std::min(above[column + offset], std::min(center[column + offset], below[column + offset])));
+            }
+            texels[column] = farthest;
+        }
+    }
+}
+
+// Texel rectangle touched by a box and the 1/w of its nearest point; false when the box reaches
+// behind the near plane (it may cover the whole view)
+static bool projectBox(const float clip[16], const Bounds& bounds, float& minX, float& maxX, float& minY, float& maxY, float& nearest) {
+    minX = minY = 1e30f;
+    maxX = maxY = -1e30f;
+    nearest = 0.0f;
+    for (int corner = 0; corner < 8; corner++) {
+        float point[3] = { (corner & 1) ? bounds.max[0] : bounds.min[0], (corner & 2) ? bounds.max[1] : bounds.min[1],
+            (corner & 4) ? bounds.max[2] : bounds.min[2] };
+        float clipPoint[4], x, y, inverseW;
+        transformPoint(clip, point, clipPoint);
+        if (!projectPoint(clipPoint, x, y, inverseW)) return false;
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+        nearest = std::max(nearest, inverseW);                                           // w is affine, so a corner is nearest
+    }
+    return true;
+}
+
+// True when every texel the box touches holds an occluder nearer than the box's nearest point
+static bool boxOccluded(const float clip[16], const Bounds& bounds) {
+    float minX, maxX, minY, maxY, nearest;
+    if (!projectBox(clip, bounds, minX, maxX, minY, maxY, nearest)) return false;
+    int firstColumn = std::max(0, (int)floorf(minX)), lastColumn = std::min(occlusionBufferWidth - 1, (int)floorf(maxX));
+    int firstRow = std::max(0, (int)floorf(minY)), lastRow = std::min(occlusionBufferHeight - 1, (int)floorf(maxY));
+    if (firstColumn > lastColumn || firstRow > lastRow) return false;                    // Off screen; left to the frustum test
+    for (int row = firstRow; row <= lastRow; row++) {
+        const float* texels = &occlusionBuffer[(size_t)row * occlusionBufferWidth];
+        int column = firstColumn;
+#if OCCLUSION_SSE
+        __m128 boxDepth = _mm_set1_ps(nearest);
+        for (; column + 4 <= lastColumn + 1; column += 4) {
+            if (_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(texels + column), boxDepth))) return false;
+        }
+#endif
+        for (; column <= lastColumn; column++) {
+            if (texels[column] <= nearest) return false;
+        }
+    }
+    return true;
+}
+
+void cullOccludedSubmeshes(uint8_t* visible) {
+    auto start = std::chrono::steady_clock::now();
+    float projection[16], modelView[16], clip[16];                                       // Column-major
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelView);
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            clip[column * 4 + row] = 0.0f;
+            for (int k = 0; k < 4; k++) clip[column * 4 + row] += projection[k * 4 + row] * modelView[column * 4 + k];
+        }
+    }
+
+    // Occluders: the visible submeshes with the largest boxes on screen whose triangles are large enough
+    // to fill texels, up to the triangle budget
+    struct Candidate { float area; uint32_t submesh; };
+    std::vector<Candidate> candidates;
+    for (uint32_t i = 0; i < (uint32_t)submeshes.size(); i++) {
+        if (!visible[i] || !submeshes[i].indexCount) continue;
+        float minX, maxX, minY, maxY, nearest;
+        float area = (float)occlusionBufferWidth * occlusionBufferHeight;                // Boxes around the eye count as full screen
+        if (projectBox(clip, submeshes[i].bounds, minX, maxX, minY, maxY, nearest)) {
+            area = (std::min(maxX, (float)occlusionBufferWidth) - std::max(minX, 0.0f)) *
+                (std::min(maxY, (float)occlusionBufferHeight) - std::max(minY, 0.0f));
+        }
+        if (area >= minOccluderArea && area >= minOccluderTexelsPerTriangle * (submeshes[i].indexCount / 3)) candidates.push_back({ area, i });
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.area > b.area; });
+    std::vector<uint8_t> isOccluder(submeshes.size(), 0);
+    std::vector<uint32_t> occluderTriangleIndices;                                       // Triangles of meshIndices to rasterize
+    for (const Candidate& candidate : candidates) {
+        const Submesh& submesh = submeshes[candidate.submesh];
+        if (occluderTriangleIndices.size() + submesh.indexCount / 3 > occluderTriangleBudget) continue;
+        isOccluder[candidate.submesh] = 1;
+        renderStats.occluderSubmeshes++;
+        for (uint32_t t = submesh.firstIndex / 3; t < (submesh.firstIndex + submesh.indexCount) / 3; t++) occluderTriangleIndices.push_back(t);
+    }
+    renderStats.occluderTriangles = occluderTriangleIndices.size();
+
+    // Set up the triangles, then rasterize bands of rows in parallel (each task owns its rows)
+    ThreadPool& pool = sharedThreadPool();
+    occluderTriangles.resize(occluderTriangleIndices.size());
+    pool.parallelFor((occluderTriangleIndices.size() + 4095) / 4096, [&](size_t block) {
+        size_t end = std::min(occluderTriangleIndices.size(), (block + 1) * 4096);
+        for (size_t i = block * 4096; i < end; i++) setupOccluderTriangle(clip, occluderTriangleIndices[i], occluderTriangles[i]);
+    });
+    std::fill(rasterBuffer.begin(), rasterBuffer.end(), 0.0f);
+    pool.parallelFor(occlusionBufferHeight / occlusionBandRows, [](size_t band) {
+        rasterizeBand((int)band * occlusionBandRows, (int)(band + 1) * occlusionBandRows);
+    });
+    pool.parallelFor(occlusionBufferHeight / occlusionBandRows, [](size_t band) {
+        erodeBand((int)band * occlusionBandRows, (int)(band + 1) * occlusionBandRows);
+    });
+    occlusionBufferValid = true;
+
+    // Test the remaining visible submeshes
+    for (uint32_t i = 0; i < (uint32_t)submeshes.size(); i++) {
+        if (!visible[i] || isOccluder[i] || !submeshes[i].indexCount) continue;
+        if (boxOccluded(clip, submeshes[i].bounds)) {
+            visible[i] = 0;
+            renderStats.occludedSubmeshes++;
+        }
+    }
+    renderStats.occlusionMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Draw the buffer scaled to its nearest texel, so near occluders are bright and uncovered texels black
+void drawOcclusionBufferView(float x, float y, float width, float height) {
+    if (!occlusionBufferValid) return;
+    float nearest = *std::max_element(occlusionBuffer.begin(), occlusionBuffer.end());
+    static std::vector<unsigned char> image(occlusionBuffer.size());
+    for (size_t i = 0; i < occlusionBuffer.size(); i++) {
+        image[i] = occlusionBuffer[i] > 0.0f ? (unsigned char)(48.0f + 207.0f * occlusionBuffer[i] / nearest) : 0;
+    }
+
+    glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+    if (!occlusionTexture) {
+        glGenTextures(1, &occlusionTexture);
+        glBindTexture(GL_TEXTURE_2D, occlusionTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);               // Show the texels as they are
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, occlusionBufferWidth, occlusionBufferHeight, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glBindTexture(GL_TEXTURE_2D, occlusionTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, occlusionBufferWidth, occlusionBufferHeight, GL_LUMINANCE, GL_UNSIGNED_BYTE, image.data());
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0, 0); glVertex2f(x, y);
+    glTexCoord2f(1, 0); glVertex2f(x + width, y);
+    glTexCoord2f(1, 1); glVertex2f(x + width, y + height);
+    glTexCoord2f(0, 1); glVertex2f(x, y + height);
+    glEnd();
+    glDisable(GL_TEXTURE_2D);
+    glColor3f(1.0f, 1.0f, 0.0f);                                                         // Yellow frame
+    glBegin(GL_LINE_LOOP);
+    glVertex2f(x, y); glVertex2f(x + width, y); glVertex2f(x + width, y + height); glVertex2f(x, y + height);
+    glEnd();
+    glPopAttrib();
+}
+
+// Toggle occlusion culling
+void toggleOcclusionCulling() {
+    occlusionCullingEnabled = !occlusionCullingEnabled;
+    printf("Occlusion culling: %s\n", occlusionCullingEnabled ? "on" : "off");
+}
+
+// Toggle the occlusion buffer overlay
+void toggleOcclusionBufferView() {
+    showOcclusionBuffer = !showOcclusionBuffer;
+    printf("Occlusion buffer view: %s\n", showOcclusionBuffer ? "on" : "off");
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+// Coarse depth buffer of the largest occluders, rasterized on the CPU over the whole viewport and shrunk
+// by one texel. A texel holds 1/w of the farthest occluder point over it, or 0 where no occluder covers
+// it, so a box whose nearest point has a smaller 1/w than every texel it touches is hidden.
+const int occlusionBufferWidth = 256;                                                    // Texels across (multiple of 4)
+const int occlusionBufferHeight = 128;                                                   // Texels down
+
+extern bool occlusionCullingEnabled;                                                     // Test submeshes against the occluders (toggled from the menu)
+extern bool showOcclusionBuffer;                                                         // Draw the occlusion buffer in the overlay
+
+// Rasterize the largest visible submeshes into the occlusion buffer with the current GL matrices
+// (model transform applied), then clear visible[i] of every other submesh hidden behind them.
+// Updates the occlusion counters of renderStats.
+void cullOccludedSubmeshes(uint8_t* visible);
+
+void drawOcclusionBufferView(float x, float y, float width, float height);               // Draw the last occlusion buffer as a grayscale image
+void toggleOcclusionCulling();                                                           // Toggle occlusion culling
+void toggleOcclusionBufferView();                                                        // Toggle the occlusion buffer overlay
\ No newline at end of file
@@ -0,0 +1,490 @@
+#include "RenderBackend.h"
+#include "GLExtensions.h"
+#include "MeshBuffers.h"
+#include "ShaderProgram.h"
+#include "VertexQuantization.h"
+#include "MeshOrientation.h"
+#include "UniformLighting.h"
+#include "VertexAnimation.h"
+#include "StreamBuffer.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <string>
+#include <string.h>
+#include <vector>
+
+// Counters of the last drawn frame
+RenderStats renderStats = {};
+
+// Set the fixed-function material state for one batch (the shader backend reads it as gl_FrontMaterial)
+void applyMaterial(const Material& material) {
+    glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, material.ambient);                       // Set material ambient properties
+    glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, material.diffuse);                       // Set material diffuse properties
+    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, material.specular);                     // Set material specular properties
+    glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, material.shininess);                    // Set material shininess
+}
+
+// Fixed-function backends and the shader backend read the material from the glMaterial state
+void RenderBackend::applyBatchMaterial(int32_t material) {
+    applyMaterial(materials[material]);
+}
+
+// Draw the visible ranges, changing the material and face culling only between batches that differ
+void RenderBackend::drawRanges(const DrawRange* ranges, size_t count) {
+    if (count == 0) return;
+    beginRanges();
+    int32_t currentMaterial = -1;                                                        // Material state last applied
+    int cullState = -1;                                                                  // Face culling state last applied
+    for (size_t i = 0; i < count; i++) {
+        const MeshBatch& batch = meshBatches[ranges[i].batch];                           // Batches are sorted by material
+        if (batch.material != currentMaterial) {
+            applyBatchMaterial(batch.material);                                          // One state change per material
+            currentMaterial = batch.material;
+        }
+        applyBatchCulling(batch, cullState);                                             // Closed batches hide their back faces
+        drawRange(ranges[i]);
+        renderStats.drawCalls++;
+    }
+    endBatchCulling(cullState);
+    endRanges();
+}
+
+// Draw one index range with glDrawElements; indexBase is an offset into the bound index buffer or a client address
+static void drawElements(uint32_t firstIndex, uint32_t indexCount, const char* indexBase) {
+    glDrawElements(GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_INT, indexBase + firstIndex * sizeof(uint32_t));
+}
+
+// Point the fixed-function vertex arrays at interleaved MeshVertex data (offsets or client addresses)
+static void enableClientArrays(const char* vertexBase) {
+    const GLsizei stride = sizeof(MeshVertex);                                           // Interleaved vertex size
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, vertexBase + offsetof(MeshVertex, position));
+    glNormalPointer(GL_FLOAT, stride, vertexBase + offsetof(MeshVertex, normal));
+    glTexCoordPointer(2, GL_FLOAT, stride, vertexBase + offsetof(MeshVertex, texCoord));
+}
+
+static void disableClientArrays() {
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+// Immediate mode: every corner is sent with glNormal/glTexCoord/glVertex calls
+class ImmediateBackend : public RenderBackend {
+public:
+    const char* name() const override { return "Immediate mode"; }
+    bool isSupported() override { return true; }
+
+protected:
+    void drawRange(const DrawRange& range) override {
+        glBegin(GL_TRIANGLES);
+        const uint32_t* indices = meshIndices.data() + range.firstIndex;
+        for (uint32_t i = 0; i < range.indexCount; i++) {
+            const MeshVertex& vertex = meshVertices[indices[i]];
+            glNormal3fv(vertex.normal);
+            glTexCoord2fv(vertex.texCoord);
+            glVertex3fv(vertex.position);
+        }
+        glEnd();
+    }
+};
+
+// Display lists: each batch's client-array draw call is compiled into its own list once per model,
+// so visible batches can be called individually. Batches with culled meshlets are drawn from the
+// client arrays instead, since a list cannot draw part of its contents.
+class DisplayListBackend : public RenderBackend {
+public:
+    const char* name() const override { return "Display list"; }
+    bool isSupported() override { return true; }
+    void release() override {
+        if (listCount) glDeleteLists(firstList, listCount);
+        firstList = 0;
+        listCount = 0;
+    }
+
+protected:
+    void beginRanges() override {
+        compileLists();
+        enableClientArrays((const char*)meshVertices.data());                            // For partial batches
+    }
+    void drawRange(const DrawRange& range) override {
+        if (range.indexCount == meshBatches[range.batch].indexCount) glCallList(firstList + range.batch);
+        else drawElements(range.firstIndex, range.indexCount, (const char*)meshIndices.data());
+    }
+    void endRanges() override {
+        disableClientArrays();
+    }
+
+private:
+    // Compile one list per batch after the model changed
+    void compileLists() {
+        if (listCount && compiledVersion == modelVersion) return;                        // Lists are current
+        release();
+        listCount = (GLsizei)meshBatches.size();
+        firstList = glGenLists(listCount);
+        enableClientArrays((const char*)meshVertices.data());                            // Arrays are dereferenced at compile time
+        for (GLsizei i = 0; i < listCount; i++) {
+            glNewList(firstList + i, GL_COMPILE);
+            drawElements(meshBatches[i].firstIndex, meshBatches[i].indexCount, (const char*)meshIndices.data());
+            glEndList();
+        }
+        disableClientArrays();
+        compiledVersion = modelVersion;
+    }
+
+    GLuint firstList = 0;                                                                // List of batch 0; batch i uses firstList + i
+    GLsizei listCount = 0;                                                               // Number of compiled lists
+    uint32_t compiledVersion = 0;                                                        // modelVersion of the list contents
+};
+
+// Buffer objects: the welded mesh lives in GPU buffers, drawn through the fixed-function arrays
+class BufferBackend : public RenderBackend {
+public:
+    const char* name() const override { return "Buffer objects"; }
+    bool isSupported() override { return glHasBufferObjects; }
+
+protected:
+    void beginRanges() override {
+        updateMeshBuffers(false);                                                        // Uploads only after the model changed
+        bindMeshBuffers();
+        const StreamedVertices* streamed = streamedVertices();
+        if (streamed) glBindBuffer(GL_ARRAY_BUFFER, streamed->buffer);                   // Animated vertices, same indices
+        enableClientArrays(streamed ? (const char*)streamed->offset : nullptr);          // Offsets into the vertex buffer
+    }
+    void drawRange(const DrawRange& range) override {
+        drawElements(range.firstIndex, range.indexCount, nullptr);
+    }
+    void endRanges() override {
+        disableClientArrays();
+        unbindMeshBuffers();                                                             // Other drawing uses client memory
+    }
+};
+
+// Per-pixel version of the fixed-function lighting of setupLighting, reading the light and material
+// state set through glLight/glMaterial so the backend needs no lighting uniforms. Follows
+// meshVertexShaderHeader, which decodes quantized vertices. With PER_DRAW_MATERIAL defined it also passes
+// the per-draw material attribute of the indirect backend on to the fragment shader.
+static const char* meshVertexShader = R"(
+attribute vec3 position;
+attribute vec3 normal;
+attribute vec2 texCoord;
+#ifdef PER_DRAW_MATERIAL
+attribute float material;
+varying float drawMaterial;
+#endif
+varying vec3 viewPosition;
+varying vec3 viewNormal;
+void main() {
+#ifdef PER_DRAW_MATERIAL
+    drawMaterial = material;
+#endif
+    vec4 eyePosition = gl_ModelViewMatrix * vec4(decodePosition(position), 1.0);
+    viewPosition = eyePosition.xyz;
+    viewNormal = gl_NormalMatrix * decodeNormal(normal);
+    gl_TexCoord[0] = vec4(texCoord, 0.0, 1.0);
+    gl_Position = gl_ProjectionMatrix * eyePosition;
+}
+)";
+
+const char* const meshFragmentShader = R"(#version 120
+varying vec3 viewPosition;
+varying vec3 viewNormal;
+void main() {
+    vec3 n = normalize(viewNormal);
+    vec3 l = normalize(gl_LightSource[0].position.xyz);
+    float diffuse = max(dot(n, l), 0.0);
+    float specular = diffuse > 0.0 ? pow(max(dot(n, normalize(gl_LightSource[0].halfVector.xyz)), 0.0), gl_FrontMaterial.shininess) : 0.0;
+    vec4 color = gl_LightModel.ambient * gl_FrontMaterial.ambient +
+        gl_LightSource[0].ambient * gl_FrontMaterial.ambient +
+        gl_LightSource[0].diffuse * gl_FrontMaterial.diffuse * diffuse +
+        gl_LightSource[0].specular * gl_FrontMaterial.specular * specular;
+    gl_FragColor = vec4(color.rgb, gl_FrontMaterial.diffuse.a);
+}
+)";
+
+// Vertex array object and GLSL program over the shared mesh buffers
+class ShaderBackend : public RenderBackend {
+public:
+    const char* name() const override { return "VAO + shader"; }
+    bool isSupported() override {
+        if (!glHasBufferObjects || !glHasShaders || !glHasVertexArrayObjects) return false;
+        if (!programBuilt) {                                                             // Compile once, on first use
+            program = buildProgram();
+            if (program) decodeUniforms = findMeshDecodeUniforms(program);
+            programBuilt = true;
+        }
+        return program != 0;
+    }
+    void release() override {
+        for (VertexArrayBinding& array : vertexArrays) {
+            if (array.name) glDeleteVertexArrays(1, &array.name);
+            array = VertexArrayBinding{};
+        }
+        nextVertexArray = 0;
+    }
+
+protected:
+    // The mesh vertex shader with the backend's fragment shader
+    virtual GLuint buildProgram() {
+        return buildMeshProgram("mesh", meshFragmentShader, "");
+    }
+    GLuint buildMeshProgram(const char* programName, const char* fragmentSource, const char* vertexDefines) {
+        static const char* const attributes[] = { "position", "normal", "texCoord", "material" };
+        std::string vertexSource = std::string(meshVertexShaderHeader) + vertexDefines + meshVertexShader;
+        return buildShaderProgram(programName, vertexSource.c_str(), fragmentSource, attributes, 4);
+    }
+    virtual void addVertexAttributes() {}                                                // Attributes beyond the mesh's, while the VAO is rebuilt
+    // Streamed vertices are always floats, and they cycle through the regions of the stream buffer, so
+    // there is one VAO per region (plus one for the mesh buffer) and an animated frame only picks the
+    // VAO of its region. A VAO is re-pointed only when no cached one matches the buffer, offset and format.
+    void beginRanges() override {
+        const StreamedVertices* streamed = streamedVertices();
+        updateMeshBuffers(!streamed && quantizedVerticesEnabled && glHasHalfFloatVertices);
+        GLuint vertexBuffer = streamed ? streamed->buffer : meshVertexBuffer();
+        size_t vertexOffset = streamed ? streamed->offset : 0;
+        bool quantized = meshBuffersQuantized();
+        uint32_t bufferVersion = streamed ? streamBufferVersion : 0;                     // A recreated stream buffer may reuse a name
+        int arrayIndex = -1;                                                             // VAO already pointing at this source
+        for (int i = 0; i < vertexArrayCount; i++) {
+            const VertexArrayBinding& array = vertexArrays[i];
+            if (array.name && array.vertexBuffer == vertexBuffer && array.vertexOffset == vertexOffset && array.quantized == quantized &&
+                array.bufferVersion == bufferVersion) arrayIndex = i;
+        }
+        if (arrayIndex < 0) {                                                            // Buffers, offset or format not cached
+            arrayIndex = nextVertexArray;
+            nextVertexArray = (nextVertexArray + 1) % vertexArrayCount;                  // Replace the oldest next time
+            VertexArrayBinding& array = vertexArrays[arrayIndex];
+            if (!array.name) glGenVertexArrays(1, &array.name);
+            glBindVertexArray(array.name);
+            bindMeshBuffers();                                                           // The element buffer binding is VAO state
+            glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+            glEnableVertexAttribArray(0);
+            glEnableVertexAttribArray(1);
+            glEnableVertexAttribArray(2);
+            setMeshAttributePointers(vertexOffset);
+            addVertexAttributes();
+            glBindVertexArray(0);
+            unbindMeshBuffers();
+            array.vertexBuffer = vertexBuffer;
+            array.vertexOffset = vertexOffset;
+            array.quantized = quantized;
+            array.bufferVersion = bufferVersion;
+        }
+        glUseProgram(program);
+        setMeshDecodeUniforms(decodeUniforms);
+        glBindVertexArray(vertexArrays[arrayIndex].name);
+    }
+    void drawRange(const DrawRange& range) override {
+        drawElements(range.firstIndex, range.indexCount, nullptr);
+    }
+    void endRanges() override {
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+
+    GLuint program = 0;                                                                  // Lighting program (0 if it failed to build)
+
+private:
+    bool programBuilt = false;                                                           // Build was attempted
+    MeshDecodeUniforms decodeUniforms = {};                                              // Decode uniform locations of program
+    // Attribute and index buffer bindings for one vertex source
+    struct VertexArrayBinding {
+        GLuint name;                                                                     // Vertex array object (0 before first use)
+        GLuint vertexBuffer;                                                             // Vertex buffer the VAO points at
+        size_t vertexOffset;                                                             // Offset of vertex 0 in that buffer
+        bool quantized;                                                                  // Vertex format the VAO points at
+        uint32_t bufferVersion;                                                          // streamBufferVersion when it was pointed (0 for the mesh)
+    };
+    static const int vertexArrayCount = streamBufferSlots + 1;                           // Every stream region, and the mesh buffer
+    VertexArrayBinding vertexArrays[vertexArrayCount] = {};
+    int nextVertexArray = 0;                                                             // Replaced when no VAO matches
+};
+
+// The shader backend's vertex path, lit from uniform buffers instead of the fixed-function light and
+// material state: the materials are uploaded once per model and a material change is one glUniform1i
+// rather than four glMaterial calls
+class UniformBufferBackend : public ShaderBackend {
+public:
+    const char* name() const override { return "VAO + uniform buffers"; }
+    bool isSupported() override { return glHasUniformBuffers && ShaderBackend::isSupported(); }
+    void release() override {
+        ShaderBackend::release();
+        releaseLightingBuffers();
+    }
+
+protected:
+    GLuint buildProgram() override {
+        GLuint built = buildLightingProgram("uniform lighting", false);
+        if (built) materialIndexLocation = glGetUniformLocation(built, "materialIndex");
+        return built;
+    }
+    GLuint buildLightingProgram(const char* programName, bool perDrawMaterial) {
+        std::string fragmentSource = uniformLightingFragmentShader(perDrawMaterial);
+        GLuint built = buildMeshProgram(programName, fragmentSource.c_str(), perDrawMaterial ? "#define PER_DRAW_MATERIAL\n" : "");
+        if (built && !bindLightingBlocks(built)) {
+            glDeleteProgram(built);
+            built = 0;
+        }
+        return built;
+    }
+    void beginRanges() override {
+        ShaderBackend::beginRanges();                                                    // Binds the program
+        updateLightingBuffers();
+    }
+    void applyBatchMaterial(int32_t material) override {
+        selectLightingMaterial(materialIndexLocation, material);
+    }
+
+private:
+    GLint materialIndexLocation = -1;                                                    // Uniform selecting the material
+};
+
+// Layout of one glMultiDrawElementsIndirect command
+struct DrawElementsIndirectCommand {
+    GLuint count;                                                                        // Indices
+    GLuint instanceCount;                                                                // Always 1
+    GLuint firstIndex;                                                                   // First index in the element buffer
+    GLint baseVertex;                                                                    // Always 0
+    GLuint baseInstance;                                                                 // Material within its group, read by the material attribute
+};
+
+// Consecutive commands drawn by one glMultiDrawElementsIndirect
+struct DrawCommandRun {
+    uint32_t firstCommand;                                                               // First command of the run
+    uint32_t commandCount;                                                               // Commands in the run
+    uint32_t batch;                                                                      // A batch of the run, for its culling state
+    int32_t materialGroup;                                                               // Material group bound for the run
+};
+
+// The uniform-buffer backend with every visible range turned into a command of one indirect buffer.
+// The material reaches the shader through an instanced attribute over 0..materialsPerBlock-1 that the
+// command's baseInstance offsets, so ranges of different materials share a draw. The commands are only
+// rebuilt when the visible ranges change, and a frame issues one multi-draw per run of ranges with the
+// same face culling and material group (one in total for most models).
+class MultiDrawIndirectBackend : public UniformBufferBackend {
+public:
+    const char* name() const override { return "Multi-draw indirect"; }
+    bool isSupported() override { return glHasMultiDrawIndirect && UniformBufferBackend::isSupported(); }
+    void release() override {
+        UniformBufferBackend::release();
+        if (commandBuffer) {
+            glDeleteBuffers(1, &commandBuffer);
+            glDeleteBuffers(1, &materialIdBuffer);
+        }
+        commandBuffer = 0;
+        materialIdBuffer = 0;
+        commandRanges.clear();
+        commandRuns.clear();
+    }
+    void drawRanges(const DrawRange* ranges, size_t count) override {
+        if (count == 0) return;
+        beginRanges();
+        updateCommands(ranges, count);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        int cullState = -1;                                                              // Face culling state last applied
+        for (const DrawCommandRun& run : commandRuns) {
+            applyBatchCulling(meshBatches[run.batch], cullState);
+            selectLightingMaterialGroup(run.materialGroup);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                (const void*)(run.firstCommand * sizeof(DrawElementsIndirectCommand)), (GLsizei)run.commandCount, 0);
+            renderStats.drawCalls++;
+        }
+        endBatchCulling(cullState);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        endRanges();
+    }
+
+protected:
+    GLuint buildProgram() override {
+        return buildLightingProgram("indirect lighting", true);
+    }
+    void addVertexAttributes() override {
+        if (!materialIdBuffer) {                                                         // Attribute value i for instance i
+            std::vector<float> materialIds(materialsPerBlock);
+            for (int i = 0; i < materialsPerBlock; i++) materialIds[i] = (float)i;
+            glGenBuffers(1, &materialIdBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, materialIdBuffer);
+            glBufferData(GL_ARRAY_BUFFER, (ptrdiff_t)(materialIds.size() * sizeof(float)), materialIds.data(), GL_STATIC_DRAW);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, materialIdBuffer);
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glVertexAttribDivisor(3, 1);                                                     // Advances per instance, so only baseInstance picks it
+    }
+    void drawRange(const DrawRange&) override {}                                         // drawRanges issues the multi-draws itself
+
+private:
+    // Rebuild and upload the commands when the ranges differ from the ones they were built from
+    void updateCommands(const DrawRange* ranges, size_t count) {
+        if (commandVersion == modelVersion && commandRanges.size() == count &&
+            memcmp(commandRanges.data(), ranges, count * sizeof(DrawRange)) == 0) return;
+        commandRanges.assign(ranges, ranges + count);
+        commandVersion = modelVersion;
+        std::vector<DrawElementsIndirectCommand> commands(count);
+        commandRuns.clear();
+        for (size_t i = 0; i < count; i++) {
+            const MeshBatch& batch = meshBatches[ranges[i].batch];
+            int32_t group = batch.material / materialsPerBlock;
+            commands[i] = { ranges[i].indexCount, 1, ranges[i].firstIndex, 0, (GLuint)(batch.material % materialsPerBlock) };
+            if (commandRuns.empty() || commandRuns.back().materialGroup != group ||
+                meshBatches[commandRuns.back().batch].closed != batch.closed) {
+                commandRuns.push_back({ (uint32_t)i, 0, ranges[i].batch, group });
+            }
+            commandRuns.back().commandCount++;
+        }
+        if (!commandBuffer) glGenBuffers(1, &commandBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, (ptrdiff_t)(commands.size() * sizeof(DrawElementsIndirectCommand)), commands.data(),
+            GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        renderStats.rebuiltDrawCommands += count;
+    }
+
+    GLuint commandBuffer = 0;                                                            // DrawElementsIndirectCommand per visible range
+    GLuint materialIdBuffer = 0;                                                         // Floats 0..materialsPerBlock-1
+    std::vector<DrawRange> commandRanges;                                                // Ranges the commands were built from
+    std::vector<DrawCommandRun> commandRuns;                                             // Multi-draws of the current commands
+    uint32_t commandVersion = 0;                                                         // modelVersion of the commands
+};
+
+// Backend instances and the current selection
+static ImmediateBackend immediateBackend;
+static DisplayListBackend displayListBackend;
+static BufferBackend bufferBackend;
+static ShaderBackend shaderBackend;
+static UniformBufferBackend uniformBufferBackend;
+static MultiDrawIndirectBackend multiDrawIndirectBackend;
+static RenderBackend* const backends[RENDER_BACKEND_COUNT] = { &immediateBackend, &displayListBackend, &bufferBackend, &shaderBackend,
+    &uniformBufferBackend, &multiDrawIndirectBackend };
+static RenderBackendType currentBackend = RENDER_BACKEND_DISPLAY_LIST;                   // Works on every driver
+
+// Backend instance of a type
+RenderBackend& renderBackend(RenderBackendType type) {
+    return *backends[type];
+}
+
+// Backend used by drawModel
+RenderBackendType currentRenderBackend() {
+    return currentBackend;
+}
+
+// Select a backend; the previous one frees its GPU objects
+bool setRenderBackend(RenderBackendType type, bool announce) {
+    if (!backends[type]->isSupported()) {
+        printf("Render backend not supported by this driver: %s\n", backends[type]->name());
+        return false;
+    }
+    if (type != currentBackend) {
+        backends[currentBackend]->release();
+        currentBackend = type;
+    }
+    if (announce) printf("Render backend: %s\n", backends[type]->name());
+    return true;
+}
+
+// Buffer objects when the driver has them, otherwise a display list
+void chooseDefaultRenderBackend() {
+    currentBackend = bufferBackend.isSupported() ? RENDER_BACKEND_BUFFERS : RENDER_BACKEND_DISPLAY_LIST;
+}
\ No newline at end of file
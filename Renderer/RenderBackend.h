@@ -0,0 +1,72 @@
+#pragma once
+#include "ModelLoader.h"
+
+// Ways of submitting the welded mesh to OpenGL, selectable at run time
+enum RenderBackendType {
+    RENDER_BACKEND_IMMEDIATE,                                                            // glBegin/glEnd per batch, one call per attribute
+    RENDER_BACKEND_DISPLAY_LIST,                                                         // Batches compiled into a display list
+    RENDER_BACKEND_BUFFERS,                                                              // Vertex/index buffer objects with client state
+    RENDER_BACKEND_SHADER,                                                               // Vertex array object and a GLSL program
+    RENDER_BACKEND_UNIFORM_BUFFERS,                                                      // The same, lit from uniform buffers
+    RENDER_BACKEND_MULTI_DRAW_INDIRECT,                                                  // The same, every range in one indirect draw
+    RENDER_BACKEND_COUNT
+};
+
+// Part of one batch selected for drawing: the whole batch, or a run of its visible meshlets
+struct DrawRange {
+    uint32_t batch;                                                                      // Index into meshBatches
+    uint32_t firstIndex;                                                                 // First entry in meshIndices
+    uint32_t indexCount;                                                                 // Number of indices (3 per triangle)
+};
+
+// Common draw interface. drawModel sets the model transform and disables color tracking, then
+// draws the visible parts of meshBatches with drawRanges, which applies the batch materials and
+// back-face culling of closed batches between the backend's begin/drawRange/end calls.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() {}
+    virtual const char* name() const = 0;                                                // Name shown in the menu and reports
+    virtual bool isSupported() = 0;                                                      // Driver provides what the backend needs
+    virtual void release() {}                                                            // Free GPU objects owned by the backend
+
+    // Draw ranges[i] for i < count (batches ascending, so materials stay grouped)
+    virtual void drawRanges(const DrawRange* ranges, size_t count);
+
+protected:
+    virtual void beginRanges() {}                                                        // Bind the mesh data
+    virtual void drawRange(const DrawRange& range) = 0;                                  // Submit one range
+    virtual void endRanges() {}                                                          // Restore the default bindings
+    virtual void applyBatchMaterial(int32_t material);                                   // Shade the following ranges with a material
+};
+
+// Counters of the last drawn frame, shown by the overlay
+struct RenderStats {
+    size_t drawnTriangles;                                                               // Triangles submitted to the backend
+    size_t culledTriangles;                                                              // Triangles skipped by culling
+    size_t drawnSubmeshes;                                                               // Submeshes with at least one batch submitted
+    size_t culledSubmeshes;                                                              // Submeshes skipped by culling
+    size_t drawnMeshlets;                                                                // Meshlets submitted to the backend
+    size_t frustumCulledMeshlets;                                                        // Meshlets outside the frustum (or in a culled submesh)
+    size_t backfaceCulledMeshlets;                                                       // Meshlets whose normal cone faces away
+    size_t drawCalls;                                                                    // Draw calls issued for the model
+    size_t rebuiltDrawCommands;                                                          // Indirect draw commands rebuilt (visibility changed)
+    double submitMilliseconds;                                                           // CPU time spent issuing the model's draws
+    size_t drawnInstances;                                                               // Instances submitted (instancing mode)
+    size_t culledInstances;                                                              // Instances outside the frustum
+    size_t simplifiedSubmeshes;                                                          // Visible submeshes drawn from a simplified level
+    size_t simplifiedTriangles;                                                          // Triangles those levels left out
+    size_t occluderSubmeshes;                                                            // Submeshes rasterized into the occlusion buffer
+    size_t occluderTriangles;                                                            // Triangles rasterized into the occlusion buffer
+    size_t occludedSubmeshes;                                                            // Submeshes hidden behind the occluders
+    double occlusionMilliseconds;                                                        // CPU time of the occlusion pass
+};
+
+extern RenderStats renderStats;                                                          // Filled while drawing the model
+
+RenderBackend& renderBackend(RenderBackendType type);                                    // Backend instance of a type
+RenderBackendType currentRenderBackend();                                                // Backend used by drawModel
+bool setRenderBackend(RenderBackendType type, bool announce);                            // Select a backend (false if unsupported)
+void chooseDefaultRenderBackend();                                                       // Buffer objects, or the best fallback (after loadGLExtensions)
+void applyMaterial(const Material& material);                                            // Set the fixed-function material state
+
+extern const char* const meshFragmentShader;                                             // Per-pixel lighting of the shader backend (GLSL 120)
\ No newline at end of file
@@ -1,7 +1,22 @@
 #include "Renderer.h"
 #include "Camera.h"
 #include "ModelLoader.h"
+#include "StreamingLoader.h"
+#include "RenderBackend.h"
+#include "FrustumCulling.h"
+#include "Instancing.h"
+#include "CachedLines.h"
+#include "DepthPrepass.h"
+#include "OcclusionCulling.h"
+#include "LevelOfDetail.h"
+#include "VertexQuantization.h"
+#include "MeshOrientation.h"
+#include "UniformLighting.h"
+#include "VertexAnimation.h"
+#include "StreamBuffer.h"
 #include <cmath>
+#include <stdio.h>
+#include <string.h>
 
 // Define PI constant if not already defined by the compiler
 #ifndef M_PI
@@ -15,13 +30,137 @@ int windowHeight = 600;
 // Configuration flag for grid visibility
 bool showGrid = true;                                                                    // Controls whether the reference grid is displayed
 
+// Frame counters for render-on-demand
+size_t renderedFrames = 0;                                                               // Frames drawn from scratch
+size_t reusedFrames = 0;                                                                 // Repaints served from the cached frame
+
+// Everything a frame depends on. display compares it with the state of the last rendered frame and
+// re-presents that frame's cached image while nothing changed.
+struct FrameState {
+    float camera[5];                                                                     // Position, yaw and pitch
+    float model[7];                                                                      // Position, rotation and scale
+    uint32_t modelVersion;                                                               // Model geometry
+    uint32_t instancesVersion;                                                           // Instance layout
+    int window[2];                                                                       // Window size
+    int renderBackend;                                                                   // Selected backend
+    bool settings[10];                                                                   // Grid, culling (frustum, meshlet, occlusion, back-face), depth pre-pass, occlusion view, LOD, quantized vertices, animation
+};
+
+static FrameState renderedState;                                                         // Inputs of the cached frame
+static bool frameCached = false;                                                         // frameTexture holds the last rendered frame
+static GLuint frameTexture = 0;                                                          // Copy of the last rendered frame
+static int frameTextureWidth = 0, frameTextureHeight = 0;                                // Power-of-two texture size
+
+// Fill a FrameState from the current globals (zeroed first so padding compares equal)
+static void captureFrameState(FrameState& state) {
+    memset(&state, 0, sizeof(state));
+    const float camera[5] = { cameraX, cameraY, cameraZ, cameraYaw, cameraPitch };
+    const float model[7] = { modelX, modelY, modelZ, modelRotX, modelRotY, modelRotZ, modelScale };
+    memcpy(state.camera, camera, sizeof(camera));
+    memcpy(state.model, model, sizeof(model));
+    state.modelVersion = modelVersion;
+    state.instancesVersion = instancesVersion;
+    state.window[0] = windowWidth;
+    state.window[1] = windowHeight;
+    state.renderBackend = (int)currentRenderBackend();
+    state.settings[0] = showGrid;
+    state.settings[1] = frustumCullingEnabled;
+    state.settings[2] = meshletCullingEnabled;
+    state.settings[3] = occlusionCullingEnabled;
+    state.settings[4] = depthPrepassEnabled;
+    state.settings[5] = showOcclusionBuffer;
+    state.settings[6] = lodSelectionEnabled;
+    state.settings[7] = quantizedVerticesEnabled;
+    state.settings[8] = backfaceCullingEnabled;
+    state.settings[9] = vertexAnimationEnabled;
+}
+
+// True while every frame differs from the last one: a model is streaming in (progress bar) or the
+// mesh is animated, both without a model change
+static bool frameForcedDirty() {
+    return isStreamingLoadActive() || vertexAnimationActive();
+}
+
+// True when the next display has to render (something changed, nothing cached or forced dirty)
+static bool frameIsDirty() {
+    if (!frameCached || frameForcedDirty()) return true;
+    FrameState state;
+    captureFrameState(state);
+    return memcmp(&state, &renderedState, sizeof(state)) != 0;
+}
+
+// Post a redisplay only when the scene differs from the last rendered frame
+void redisplayIfChanged() {
+    if (frameIsDirty()) glutPostRedisplay();
+}
+
+// Force the next display to render (for state the FrameState does not cover)
+void invalidateFrame() {
+    frameCached = false;
+    glutPostRedisplay();
+}
+
+// Copy the finished back buffer into frameTexture (GL 1.1, so the texture is a power of two)
+static void cacheFrame() {
+    if (!frameTexture) glGenTextures(1, &frameTexture);
+    glBindTexture(GL_TEXTURE_2D, frameTexture);
+    if (frameTextureWidth < windowWidth || frameTextureHeight < windowHeight) {          // Grow to the window size
+        frameTextureWidth = frameTextureHeight = 1;
+        while (frameTextureWidth < windowWidth) frameTextureWidth *= 2;
+        while (frameTextureHeight < windowHeight) frameTextureHeight *= 2;
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, frameTextureWidth, frameTextureHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);               // Texel-exact copy back
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, windowWidth, windowHeight);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Draw the cached frame over the whole window and swap; used for repaints with nothing changed
+static void presentCachedFrame() {
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, windowWidth, 0, windowHeight, -1, 1);                                     // One unit per pixel
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_LIGHTING);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, frameTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);                          // Texel colors unchanged
+    float u = (float)windowWidth / frameTextureWidth, v = (float)windowHeight / frameTextureHeight;
+    glBegin(GL_QUADS);
+    glTexCoord2f(0, 0); glVertex2f(0, 0);
+    glTexCoord2f(u, 0); glVertex2f((float)windowWidth, 0);
+    glTexCoord2f(u, v); glVertex2f((float)windowWidth, (float)windowHeight);
+    glTexCoord2f(0, v); glVertex2f(0, (float)windowHeight);
+    glEnd();
+    glPopAttrib();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+    glutSwapBuffers();
+}
+
 // Toggle grid visibility
 void toggleGrid() {
     showGrid = !showGrid;                                                                // Invert grid visibility flag
 }
 
-// Display callback function - called whenever the window needs to be redrawn
+// Display callback function - called whenever the window needs to be redrawn. Repaints with an
+// unchanged scene (window exposed, no-op input) re-present the cached frame instead of rendering.
 void display() {
+    if (!frameIsDirty()) {
+        presentCachedFrame();
+        reusedFrames++;
+        return;
+    }
+    captureFrameState(renderedState);                                                    // Inputs of the frame drawn below
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);                                  // Clear color and depth buffers
     glLoadIdentity();                                                                    // Reset the modelview matrix
 
@@ -83,27 +222,100 @@ void display() {
         rotMatrix[5] /= upLength;                                                        // Normalize Z component
     }
 
-    // Draw the three coordinate axes as colored lines
-    glBegin(GL_LINES);                                                                   // Begin drawing lines
-
-    // X axis (red)
-    glColor3f(1.0f, 0.0f, 0.0f);                                                         // Set color to red for X axis
-    glVertex3f(centerX, centerY, 0.0f);                                                  // Start at center point
-    glVertex3f(centerX + rotMatrix[0] * axisSize * 0.5f,                                 // End at X axis tip
-        centerY + rotMatrix[1] * axisSize * 0.5f, 0.0f);
-
-    // Y axis (green) - Invert Y component for screen space (screen Y is inverted)
-    glColor3f(0.0f, 1.0f, 0.0f);                                                         // Set color to green for Y axis
-    glVertex3f(centerX, centerY, 0.0f);                                                  // Start at center point
-    glVertex3f(centerX + rotMatrix[3] * axisSize * 0.5f,                                 // End at Y axis tip
-        centerY + rotMatrix[4] * axisSize * 0.5f * -1.0f, 0.0f);                         // Invert Y for screen space
+    // Draw the three coordinate axes from the cached unit axes; the matrix maps axis k onto its screen
+    // direction (rotMatrix entries 3k, 3k + 1) scaled to half the indicator size
+    static CachedLines axisLines;                                                        // Unit X, Y, Z axes in red, green, blue
+    if (!axisLines.isBuilt()) {
+        axisLines.build({
+            { { 0, 0, 0 }, { 1, 0, 0 } }, { { 1, 0, 0 }, { 1, 0, 0 } },                  // X axis (red)
+            { { 0, 0, 0 }, { 0, 1, 0 } }, { { 0, 1, 0 }, { 0, 1, 0 } },                  // Y axis (green)
+            { { 0, 0, 0 }, { 0, 0, 1 } }, { { 0, 0, 1 }, { 0, 0, 1 } } });               // Z axis (blue)
+    }
+    const float halfAxis = axisSize * 0.5f;                                              // Axis length in pixels
+    const float axisTransform[16] = {                                                    // Column-major
+        rotMatrix[0] * halfAxis, rotMatrix[1] * halfAxis, 0.0f, 0.0f,                    // X axis tip
+        rotMatrix[3] * halfAxis, rotMatrix[4] * halfAxis * -1.0f, 0.0f, 0.0f,            // Y axis tip, inverted for screen space
+        rotMatrix[6] * halfAxis, rotMatrix[7] * halfAxis, 0.0f, 0.0f,                    // Z axis tip
+        centerX, centerY, 0.0f, 1.0f };                                                  // Indicator center
+    glPushMatrix();
+    glMultMatrixf(axisTransform);
+    axisLines.draw();
+    glPopMatrix();
+
+    // Draw a progress bar and counters in the top-left corner while a model is streaming in
+    if (isStreamingLoadActive()) {
+        const float barWidth = 200.0f;                                                   // Progress bar width in pixels
+        const float barHeight = 8.0f;                                                    // Progress bar height in pixels
+        const float barX = margin;                                                       // Left edge of the bar
+        const float barY = windowHeight - margin - barHeight;                            // Bottom edge of the bar
+        float progress = streamingLoadProgress();                                        // Fraction of the file parsed
+
+        glColor3f(0.3f, 0.3f, 0.3f);                                                     // Dark gray track
+        glRectf(barX, barY, barX + barWidth, barY + barHeight);
+        glColor3f(0.2f, 0.8f, 0.2f);                                                     // Green fill
+        glRectf(barX, barY, barX + barWidth * progress, barY + barHeight);
+
+        char status[128];                                                                // Progress text
+        snprintf(status, sizeof(status), "Loading %d%%  %zu vertices  %zu faces",
+            (int)(progress * 100.0f), vertices.size() - 1, faces.size());
+        glColor3f(1.0f, 1.0f, 1.0f);                                                     // White text
+        glRasterPos2f(barX, barY - 16.0f);                                               // Below the bar
+        glutBitmapString(GLUT_BITMAP_HELVETICA_12, (const unsigned char*)status);
+    }
 
-    // Z axis (blue)
-    glColor3f(0.0f, 0.0f, 1.0f);                                                         // Set color to blue for Z axis
-    glVertex3f(centerX, centerY, 0.0f);                                                  // Start at center point
-    glVertex3f(centerX + rotMatrix[6] * axisSize * 0.5f,                                 // End at Z axis tip
-        centerY + rotMatrix[7] * axisSize * 0.5f, 0.0f);
-    glEnd();                                                                             // End line drawing
+    // Draw the culling counters in the top-left corner once the welded mesh is drawn
+    if (!meshIndices.empty()) {
+        size_t totalTriangles = renderStats.drawnTriangles + renderStats.culledTriangles; // Triangles in the model
+        char stats[256];                                                                 // Counter text
+        int length = snprintf(stats, sizeof(stats),
+            "Triangles: %zu drawn, %zu culled (%.0f%%)   Submeshes: %zu drawn, %zu culled   Draw calls: %zu in %.2f ms",
+            renderStats.drawnTriangles, renderStats.culledTriangles,
+            totalTriangles ? 100.0 * renderStats.culledTriangles / totalTriangles : 0.0,
+            renderStats.drawnSubmeshes, renderStats.culledSubmeshes, renderStats.drawCalls, renderStats.submitMilliseconds);
+        if (renderStats.simplifiedSubmeshes) {
+            snprintf(stats + length, sizeof(stats) - length, "   LOD: %zu simplified, %zu triangles saved",
+                renderStats.simplifiedSubmeshes, renderStats.simplifiedTriangles);
+        }
+        glColor3f(1.0f, 1.0f, 1.0f);                                                     // White text
+        glRasterPos2f(margin, windowHeight - margin - 12.0f);                            // Top-left corner
+        glutBitmapString(GLUT_BITMAP_HELVETICA_12, (const unsigned char*)stats);
+
+        size_t culledMeshlets = renderStats.frustumCulledMeshlets + renderStats.backfaceCulledMeshlets;
+        size_t totalMeshlets = renderStats.drawnMeshlets + culledMeshlets;               // Meshlets in the model
+        if (!instances.empty()) {
+            snprintf(stats, sizeof(stats), "Instances: %zu drawn, %zu culled (%zu total)%s",
+                renderStats.drawnInstances, renderStats.culledInstances, instances.size(),
+                depthPrepassEnabled ? "   [depth pre-pass]" : "");
+        }
+        else {
+            snprintf(stats, sizeof(stats), "Meshlets: %zu drawn, %.0f%% rejected (%zu frustum, %zu back-facing)%s%s",
+                renderStats.drawnMeshlets, totalMeshlets ? 100.0 * culledMeshlets / totalMeshlets : 0.0,
+                renderStats.frustumCulledMeshlets, renderStats.backfaceCulledMeshlets,
+                meshletCullingEnabled ? "" : "   [meshlet culling off]", depthPrepassEnabled ? "   [depth pre-pass]" : "");
+        }
+        glRasterPos2f(margin, windowHeight - margin - 28.0f);                            // Second line
+        glutBitmapString(GLUT_BITMAP_HELVETICA_12, (const unsigned char*)stats);
+
+        if (occlusionCullingEnabled && instances.empty()) {
+            snprintf(stats, sizeof(stats), "Occlusion: %zu occluders (%zu triangles), %zu submeshes hidden, %.2f ms",
+                renderStats.occluderSubmeshes, renderStats.occluderTriangles, renderStats.occludedSubmeshes,
+                renderStats.occlusionMilliseconds);
+            glRasterPos2f(margin, windowHeight - margin - 44.0f);                        // Third line
+            glutBitmapString(GLUT_BITMAP_HELVETICA_12, (const unsigned char*)stats);
+        }
+        if (vertexAnimationActive()) {
+            snprintf(stats, sizeof(stats), "Streaming: %.2f MB per frame in %.2f ms, %.0f MB/s, %zu stalls (%.2f ms)%s",
+                streamStats.frameBytes / (1024.0 * 1024.0), streamStats.writeMilliseconds, streamStats.megabytesPerSecond,
+                streamStats.stalls, streamStats.stallMilliseconds, streamStats.persistent ? "" : "   [glBufferSubData]");
+            float line = occlusionCullingEnabled ? 60.0f : 44.0f;                        // Below the occlusion line when it is shown
+            glRasterPos2f(margin, windowHeight - margin - line);
+            glutBitmapString(GLUT_BITMAP_HELVETICA_12, (const unsigned char*)stats);
+        }
+        if (showOcclusionBuffer) {                                                       // Bottom-right corner, two pixels per texel
+            drawOcclusionBufferView(windowWidth - margin - occlusionBufferWidth * 2.0f, margin,
+                occlusionBufferWidth * 2.0f, occlusionBufferHeight * 2.0f);
+        }
+    }
 
     // Reset color to white for subsequent rendering
     glColor3f(1.0f, 1.0f, 1.0f);                                                         // Reset color to white
@@ -118,7 +330,11 @@ void display() {
     glMatrixMode(GL_MODELVIEW);                                                          // Switch to modelview matrix mode
     glPopMatrix();                                                                       // Restore saved modelview matrix
 
+    frameCached = !frameForcedDirty();                                                   // A copy that is never presented is wasted bandwidth
+    if (frameCached) cacheFrame();                                                       // Keep the image for unchanged repaints
+    renderedFrames++;
     glutSwapBuffers();                                                                   // Swap front and back buffers to display the rendered scene
+    if (vertexAnimationActive()) glutPostRedisplay();                                    // Keep animating
 }
 
 // Reshape callback function - called when window is resized
@@ -129,26 +345,20 @@ void reshape(int width, int height) {
     glViewport(0, 0, width, height);                                                     // Set viewport to cover entire window
     glMatrixMode(GL_PROJECTION);                                                         // Switch to projection matrix mode
     glLoadIdentity();                                                                    // Reset projection matrix
-    gluPerspective(45.0f,                                                                // Field of view angle (45 degrees)
+    gluPerspective(cameraFieldOfView,                                                    // Field of view angle (45 degrees)
         (float)width / (float)height,                                                    // Aspect ratio
-        0.1f,                                                                            // Near clipping plane
-        100.0f);                                                                         // Far clipping plane
+        cameraNearPlane,                                                                 // Near clipping plane
+        cameraFarPlane);                                                                 // Far clipping plane
     glMatrixMode(GL_MODELVIEW);                                                          // Switch back to modelview matrix mode
 }
 
 // Setup lighting parameters for the 3D scene
 void setupLighting() {
-    // Define light properties
-    GLfloat ambientLight[] = { 0.2f, 0.2f, 0.2f, 1.0f };                                 // Ambient light color (dim white)
-    GLfloat diffuseLight[] = { 0.8f, 0.8f, 0.8f, 1.0f };                                 // Diffuse light color (bright white)
-    GLfloat specularLight[] = { 1.0f, 1.0f, 1.0f, 1.0f };                                // Specular light color (pure white)
-    GLfloat position[] = { 1.0f, 1.0f, 1.0f, 0.0f };                                     // Light position (directional light)
-
-    // Configure light 0
-    glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);                                      // Set ambient light properties
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);                                      // Set diffuse light properties
-    glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);                                    // Set specular light properties
-    glLightfv(GL_LIGHT0, GL_POSITION, position);                                         // Set light position
+    // Configure light 0 from the scene light the uniform-buffer pipeline also uses
+    glLightfv(GL_LIGHT0, GL_AMBIENT, sceneLight.ambient);                                // Set ambient light properties
+    glLightfv(GL_LIGHT0, GL_DIFFUSE, sceneLight.diffuse);                                // Set diffuse light properties
+    glLightfv(GL_LIGHT0, GL_SPECULAR, sceneLight.specular);                              // Set specular light properties
+    glLightfv(GL_LIGHT0, GL_POSITION, sceneLight.position);                              // Set light position (under the identity modelview)
 
     // Define material properties
     GLfloat materialAmbient[] = { 0.2f, 0.2f, 0.2f, 1.0f };                              // Material ambient color
@@ -1,5 +1,6 @@
 #pragma once
 #include <freeglut.h>
+#include <stddef.h>
 
 // Window configuration
 extern int windowWidth;                                                                  // Window width in pixels
@@ -8,8 +9,14 @@ extern int windowHeight;
 // Configuration flag for grid visibility
 extern bool showGrid;                                                                    // Controls whether the reference grid is displayed
 
+// Render-on-demand counters
+extern size_t renderedFrames;                                                            // Frames drawn from scratch
+extern size_t reusedFrames;                                                              // Repaints served from the cached frame
+
 // Function declarations
-void display();                                                                          // Display callback function
+void display();                                                                          // Display callback function (re-presents the cached frame when nothing changed)
+void redisplayIfChanged();                                                               // Post a redisplay only when the scene changed since the last frame
+void invalidateFrame();                                                                  // Force the next display to render
 void reshape(int width, int height);                                                     // Reshape callback function
 void setupLighting();                                                                    // Setup lighting parameters
 void toggleGrid();                                                                       // Toggle grid visibility
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "ShaderProgram.h"
+#include <stdio.h>
+#include <vector>
+
+// Compile one shader stage; returns 0 and prints the log on failure
+static GLuint compileShader(const char* name, GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint compiled = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled) {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::vector<char> log(length + 1, '\0');
+        glGetShaderInfoLog(shader, length, nullptr, log.data());
+        printf("Error compiling %s %s shader:\n%s\n", name, type == GL_VERTEX_SHADER ? "vertex" : "fragment", log.data());
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Compile and link a program from vertex and fragment sources
+GLuint buildShaderProgram(const char* name, const char* vertexSource, const char* fragmentSource,
+    const char* const* attributeNames, int attributeCount) {
+    if (!glHasShaders) return 0;
+    GLuint vertexShader = compileShader(name, GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = compileShader(name, GL_FRAGMENT_SHADER, fragmentSource);
+    if (!vertexShader || !fragmentShader) {
+        if (vertexShader) glDeleteShader(vertexShader);
+        if (fragmentShader) glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    for (int i = 0; i < attributeCount; i++) {
+        glBindAttribLocation(program, (GLuint)i, attributeNames[i]);                     // Fixed locations shared with the vertex layout
+    }
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);                                                        // Freed together with the program
+    glDeleteShader(fragmentShader);
+
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        std::vector<char> log(length + 1, '\0');
+        glGetProgramInfoLog(program, length, nullptr, log.data());
+        printf("Error linking %s shader program:\n%s\n", name, log.data());
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+#include "GLExtensions.h"
+
+// Compile and link a GLSL program. Attribute i of attributeNames is bound to location i before
+// linking. Returns 0 (after printing the info log) when compiling or linking fails.
+GLuint buildShaderProgram(const char* name, const char* vertexSource, const char* fragmentSource,
+    const char* const* attributeNames, int attributeCount);
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "StreamBuffer.h"
+#include "GLExtensions.h"
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+
+StreamStats streamStats = {};                                                            // Updated by every streamed frame
+uint32_t streamBufferVersion = 0;                                                        // Incremented whenever a stream buffer is created (names may be recycled)
+bool persistentStreamingEnabled = true;                                                  // Use the mapped ring when the driver supports it
+
+// Persistently mapped ring
+static GLuint ringBuffer = 0;                                                            // streamBufferSlots regions of slotBytes
+static char* ringMapping = nullptr;                                                      // Mapping of the whole buffer
+static size_t slotBytes = 0;                                                             // Size of one region
+static GLsync slotFences[streamBufferSlots] = {};                                        // Signaled once the GPU is done with a region
+static int currentSlot = -1;                                                             // Region written by the current frame
+
+// glBufferSubData path
+static GLuint copyBuffer = 0;                                                            // Single buffer every frame is copied into
+static size_t copyBufferBytes = 0;                                                       // Its allocated size
+static std::vector<char> stagingData;                                                    // Client copy the frame is written to first
+
+// Bandwidth measurement
+static std::chrono::steady_clock::time_point windowStart;                                // Start of the current one-second window
+static std::chrono::steady_clock::time_point lastWrite;                                  // End of the previous write
+static std::chrono::steady_clock::time_point writeStart;                                 // When the current write was handed out
+static size_t windowBytes = 0;                                                           // Bytes streamed in the current window
+
+static const GLbitfield ringFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; // Coherent: no explicit flushes
+
+// Unmap and delete the ring; a deleted buffer stays alive until the draws that read it are done
+static void releaseRing() {
+    for (GLsync& fence : slotFences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (ringBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, ringBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDeleteBuffers(1, &ringBuffer);
+    }
+    ringBuffer = 0;
+    ringMapping = nullptr;
+    slotBytes = 0;
+    currentSlot = -1;
+}
+
+// Create and map a ring whose regions hold at least bytes; false (with the ring released) if mapping fails
+static bool createRing(size_t bytes) {
+    releaseRing();
+    slotBytes = (bytes + 255) & ~(size_t)255;                                            // Regions start on 256-byte boundaries
+    glGenBuffers(1, &ringBuffer);
+    streamBufferVersion++;
+    glBindBuffer(GL_ARRAY_BUFFER, ringBuffer);
+    glBufferStorage(GL_ARRAY_BUFFER, (ptrdiff_t)(slotBytes * streamBufferSlots), nullptr, ringFlags);
+    ringMapping = (char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, (ptrdiff_t)(slotBytes * streamBufferSlots), ringFlags);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!ringMapping) {
+        printf("Could not map the streaming buffer persistently, streaming with glBufferSubData\n");
+        releaseRing();
+        return false;
+    }
+    streamStats.stalls = 0;
+    streamStats.stallMilliseconds = 0.0;
+    printf("Streaming buffer: %d regions of %.2f MB, persistently mapped\n", streamBufferSlots, slotBytes / (1024.0 * 1024.0));
+    return true;
+}
+
+// Wait until the GPU has finished the draws that read a region. A fence that has not signaled yet at the
+// first poll counts as a stall.
+static void waitForSlot(int slot) {
+    GLsync& fence = slotFences[slot];
+    if (!fence) return;
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        auto start = std::chrono::steady_clock::now();
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);       // 1 ms at a time
+        } while (status == GL_TIMEOUT_EXPIRED);
+        streamStats.stalls++;
+        streamStats.stallMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+// The ring grows when a frame needs more than a region; switching to the copy path releases it
+bool beginStreamWrite(size_t bytes, StreamAllocation& outAllocation) {
+    if (!glHasBufferObjects) return false;
+    bool persistent = persistentStreamingEnabled && glHasPersistentMapping;
+    if (persistent && (!ringBuffer || bytes > slotBytes)) persistent = createRing(bytes);
+    if (!persistent && ringBuffer) releaseRing();
+    streamStats.persistent = persistent;
+
+    if (persistent) {
+        currentSlot = (currentSlot + 1) % streamBufferSlots;
+        waitForSlot(currentSlot);
+        outAllocation = { ringMapping + currentSlot * slotBytes, ringBuffer, currentSlot * slotBytes, bytes };
+    }
+    else {
+        if (!copyBuffer) {
+            glGenBuffers(1, &copyBuffer);
+            streamBufferVersion++;
+        }
+        stagingData.resize(bytes);
+        outAllocation = { stagingData.data(), copyBuffer, 0, bytes };
+    }
+    writeStart = std::chrono::steady_clock::now();                                       // Fence waits are not part of the write
+    return true;
+}
+
+// Mapped writes are already visible (coherent mapping); staged ones are copied into the buffer, which
+// the driver must not do while the GPU still reads the previous frame from it
+void endStreamWrite(const StreamAllocation& allocation) {
+    if (allocation.buffer == copyBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, copyBuffer);
+        if (copyBufferBytes < allocation.size) {
+            glBufferData(GL_ARRAY_BUFFER, (ptrdiff_t)allocation.size, allocation.data, GL_STREAM_DRAW);
+            copyBufferBytes = allocation.size;
+        }
+        else {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, (ptrdiff_t)allocation.size, allocation.data);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    streamStats.frameBytes = allocation.size;
+    streamStats.writeMilliseconds = std::chrono::duration<double, std::milli>(now - writeStart).count();
+    if (windowBytes == 0 || now - lastWrite > std::chrono::seconds(1)) {                 // First write, or streaming resumed
+        windowStart = writeStart;
+        windowBytes = 0;
+    }
+    windowBytes += allocation.size;
+    lastWrite = now;
+    double seconds = std::chrono::duration<double>(now - windowStart).count();
+    if (seconds >= 1.0) {
+        streamStats.megabytesPerSecond = windowBytes / (1024.0 * 1024.0) / seconds;
+        windowStart = now;
+        windowBytes = 0;
+    }
+}
+
+// The fence follows every draw of the frame, so it signals once none of them needs the region
+void fenceStreamWrite() {
+    if (!ringBuffer || currentSlot < 0 || !streamStats.persistent) return;
+    slotFences[currentSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void releaseStreamBuffer() {
+    releaseRing();
+    if (copyBuffer) glDeleteBuffers(1, &copyBuffer);
+    copyBuffer = 0;
+    copyBufferBytes = 0;
+    std::vector<char>().swap(stagingData);
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Buffer for data the CPU produces every frame. With persistent mapping it is one immutable buffer of
+// streamBufferSlots regions, mapped once for its whole life: a frame writes straight into the next region
+// while the GPU may still be reading the previous ones, and a fence per region keeps the CPU from
+// overwriting data a queued draw still needs. Without persistent mapping (or when the benchmark turns
+// it off) every frame is staged in client memory and copied into one buffer with glBufferSubData, which
+// leaves the synchronization to the driver.
+
+const int streamBufferSlots = 3;                                                         // Regions in flight: one written, two the GPU may still read
+
+// Space claimed for one frame's data
+struct StreamAllocation {
+    void* data;                                                                          // Where the CPU writes (the mapping, or the staging copy)
+    unsigned buffer;                                                                     // Buffer object the draws read from
+    size_t offset;                                                                       // Byte offset of the data in buffer
+    size_t size;                                                                         // Bytes claimed
+};
+
+// Streaming counters, shown by the overlay
+struct StreamStats {
+    bool persistent;                                                                     // Last frame went through the mapped ring
+    size_t frameBytes;                                                                   // Bytes streamed by the last frame
+    double writeMilliseconds;                                                            // Time the last frame spent producing and uploading them
+    double megabytesPerSecond;                                                           // Bytes streamed over the last full second
+    size_t stalls;                                                                       // Writes that waited for the GPU to release their region
+    double stallMilliseconds;                                                            // Time those writes waited
+};
+
+extern StreamStats streamStats;                                                          // Updated by every streamed frame
+extern uint32_t streamBufferVersion;                                                     // Incremented whenever a stream buffer is created (names may be recycled)
+extern bool persistentStreamingEnabled;                                                  // Use the mapped ring when the driver supports it
+
+// Claim space for this frame's data, waiting on the region's fence if the GPU still reads it. False
+// without buffer objects.
+bool beginStreamWrite(size_t bytes, StreamAllocation& outAllocation);
+void endStreamWrite(const StreamAllocation& allocation);                                 // Make the written data visible to the draws that follow
+void fenceStreamWrite();                                                                 // Fence the region after the last draw reading it
+void releaseStreamBuffer();                                                              // Delete the buffers (waits for nothing: GL defers the delete)
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "StreamingLoader.h"
+#include "ModelLoader.h"
+#include "ObjParser.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "MeshWelder.h"
+#include "LoaderArena.h"
+#include "ThreadPool.h"
+#include <freeglut.h>
+#include <stdio.h>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+// Streaming load mode flag
+bool streamingLoadEnabled = true;                                                        // Load OBJ models progressively
+
+// State shared between the GLUT thread and the background parser
+struct StreamingLoadState {
+    std::thread worker;                                                                  // Background parser thread
+    std::mutex mutex;                                                                    // Guards readyChunks, workerDone and useCache
+    std::deque<ObjChunk> readyChunks;                                                    // Parsed slices waiting to be published
+    bool workerDone = false;                                                             // Background parser has finished
+    bool useCache = false;                                                               // Sidecar matched, load it instead of parsing
+    bool skipCache = false;                                                              // Sidecar failed to load, parse the source
+    std::atomic<bool> cancel{ false };                                                   // Ask the background parser to stop
+    std::atomic<size_t> bytesParsed{ 0 };                                                // Source bytes parsed so far
+    MappedFile source;                                                                   // Mapped source file (owned by the worker while running)
+    std::string filename;                                                                // Source path
+    std::vector<ObjNamedRecord> records;                                                 // "mtllib"/"usemtl" records published so far
+    uint64_t sourceHash = 0;                                                             // Hash of the source, for the sidecar
+    bool active = false;                                                                 // A load is in progress (GLUT thread view)
+    int generation = 0;                                                                  // Identifies the load a timer belongs to
+    bool firstBatchShown = false;                                                        // Time to first pixel already reported
+    std::chrono::steady_clock::time_point startTime;                                     // When the load started
+};
+
+static StreamingLoadState streaming;                                                     // The single streaming load
+static const int publishIntervalMs = 16;                                                 // Timer period for publishing batches
+
+// Milliseconds since the load started
+static double elapsedMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - streaming.startTime).count();
+}
+
+// Background parser: check the sidecar, then parse slices on the thread pool and queue them in file order
+static void streamingWorker() {
+    const char* begin = streaming.source.data();                                         // Start of the mapped text
+    const char* end = begin + streaming.source.size();                                   // End of the mapped text
+
+    // A sidecar for a source of this size is worth hashing for; otherwise start parsing right away
+    uint64_t storedHash;
+    if (!streaming.skipCache && findMeshCache(streaming.filename.c_str(), streaming.source.size(), storedHash)) {
+        streaming.sourceHash = hashFileContents(begin, streaming.source.size());
+        if (streaming.sourceHash == storedHash) {
+            std::lock_guard<std::mutex> lock(streaming.mutex);
+            streaming.useCache = true;                                                   // GLUT thread loads the sidecar
+            streaming.workerDone = true;
+            return;
+        }
+    }
+
+    ThreadPool& pool = sharedThreadPool();                                               // Slices of a batch are parsed in parallel
+    size_t sliceSize = 256 << 10;                                                        // Small first slices for a fast first pixel
+    const size_t maxSliceSize = 16 << 20;                                                // Later slices amortize the overhead
+    const char* p = begin;                                                               // Start of the next slice
+    while (p < end && !streaming.cancel) {
+        std::vector<const char*> bounds(1, p);                                           // Slice boundaries of this batch
+        for (unsigned i = 0; i < pool.threadCount() && bounds.back() < end; i++) {
+            const char* sliceEnd = bounds.back() + std::min(sliceSize, (size_t)(end - bounds.back()));
+            bounds.push_back(nextOBJLineStart(sliceEnd == end ? end : sliceEnd - 1, end)); // Newline-aligned
+            sliceSize = std::min(sliceSize * 2, maxSliceSize);                           // Grow slices as the load goes on
+        }
+
+        std::vector<ObjChunk> chunks(bounds.size() - 1);                                 // Parsed slices of this batch
+        pool.parallelFor(chunks.size(), [&](size_t i) {
+            parseOBJChunk(bounds[i], bounds[i + 1], chunks[i]);
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(streaming.mutex);
+            for (ObjChunk& chunk : chunks) {
+                streaming.readyChunks.push_back(std::move(chunk));                       // Publish in file order
+            }
+        }
+        p = bounds.back();
+        streaming.bytesParsed = (size_t)(p - begin);                                     // Progress for the overlay
+    }
+
+    if (!streaming.cancel && !streaming.sourceHash) {                                    // Not hashed for a sidecar that failed
+        streaming.sourceHash = hashFileContents(begin, streaming.source.size());         // Needed to write the sidecar
+    }
+    std::lock_guard<std::mutex> lock(streaming.mutex);
+    streaming.workerDone = true;                                                         // Nothing more will be queued
+}
+
+// Finish the load on the GLUT thread once the background parser has stopped. A matching sidecar that turns
+// out to be truncated or corrupt leaves the model untouched; the worker is then restarted to parse the
+// source and false is returned, so the caller keeps publishing.
+static bool finishStreamingLoad(bool useCache) {
+    streaming.worker.join();                                                             // Worker has already returned
+    uint64_t sourceSize = streaming.source.size();                                       // Needed for the sidecar
+    if (useCache && !loadMeshCache(streaming.filename.c_str(), streaming.sourceHash, sourceSize)) {
+        printf("Mesh cache unusable, parsing: %s\n", streaming.filename.c_str());
+        streaming.workerDone = false;                                                    // Worker is joined, no lock needed
+        streaming.useCache = false;
+        streaming.skipCache = true;
+        streaming.worker = std::thread(streamingWorker);
+        return false;
+    }
+    streaming.source.close();                                                            // Release the mapping
+    streaming.active = false;
+
+    if (useCache) {
+        printf("Loaded model from cache: %s (%.1f ms)\n", streaming.filename.c_str(), elapsedMs());
+    }
+    else {
+        computeModelBounds();                                                            // Bounds are stored in the sidecar
+        loadOBJMaterials(streaming.filename.c_str(), streaming.records, materials, materialRuns, materialLibraryPaths);
+        loadOBJSubmeshes(streaming.records, faces.size(), submeshes, submeshRuns);
+        weldModel();                                                                     // Single index buffer for indexed drawing
+        printf("Loaded model: %s (%.1f ms)\n", streaming.filename.c_str(), elapsedMs());
+        saveMeshCache(streaming.filename.c_str(), streaming.sourceHash, sourceSize);     // Next load skips parsing
+    }
+    printf("Vertices: %zu, Texture Coords: %zu, Normals: %zu, Faces: %zu\n",
+        vertices.size() - 1, textureCoords.size() - 1, normals.size() - 1, faces.size()); // Print model statistics
+    reportModelMemory();                                                                 // Peak and steady-state bytes
+    return true;
+}
+
+// GLUT timer: move parsed slices into the model containers and redraw
+static void publishStreamingBatches(int generation) {
+    if (!streaming.active || generation != streaming.generation) return;                 // Timer of a cancelled load
+
+    std::deque<ObjChunk> batch;                                                          // Slices to publish this tick
+    bool done, useCache;
+    {
+        std::lock_guard<std::mutex> lock(streaming.mutex);
+        batch.swap(streaming.readyChunks);                                               // Take everything that is ready
+        done = streaming.workerDone;
+        useCache = streaming.useCache;
+    }
+
+    for (const ObjChunk& chunk : batch) {
+        appendOBJChunk(chunk, vertices, textureCoords, normals, faces, streaming.records); // Chunks arrive in file order
+    }
+    checkpointLoaderMemory(modelMemoryBytes());                                          // Containers grow while streaming
+    if (!batch.empty()) modelVersion++;                                                  // Faces were added
+    if (!batch.empty() && !streaming.firstBatchShown) {
+        streaming.firstBatchShown = true;
+        printf("First batch displayed after %.1f ms\n", elapsedMs());                    // Time to first pixel
+    }
+
+    if (!done || !finishStreamingLoad(useCache)) {                                       // Join worker and write sidecar
+        glutTimerFunc(publishIntervalMs, publishStreamingBatches, generation);           // Keep publishing
+    }
+    glutPostRedisplay();                                                                 // Draw what has arrived
+}
+
+// Start a background load of an OBJ file
+bool startStreamingLoad(const char* filename) {
+    cancelStreamingLoad();                                                               // Only one load at a time
+
+    if (!streaming.source.open(filename)) {
+        printf("Error opening file: %s\n", filename);                                    // Print error message
+        return false;
+    }
+
+    // Clear previous model data; faces are drawn directly until the welded mesh is built
+    clearModelData();
+    resetModel();                                                                        // Reset position, rotation, and scale
+
+    streaming.filename = filename;
+    streaming.readyChunks.clear();
+    streaming.records.clear();
+    streaming.workerDone = false;
+    streaming.useCache = false;
+    streaming.skipCache = false;
+    streaming.cancel = false;
+    streaming.bytesParsed = 0;
+    streaming.sourceHash = 0;
+    streaming.firstBatchShown = false;
+    streaming.startTime = std::chrono::steady_clock::now();
+    beginLoaderMemoryTracking();                                                         // Peak memory of this load only
+    streaming.active = true;
+    streaming.worker = std::thread(streamingWorker);                                     // Parse in the background
+
+    printf("Streaming model: %s (%.1f MB)\n", filename, streaming.source.size() / (1024.0 * 1024.0));
+    glutTimerFunc(publishIntervalMs, publishStreamingBatches, ++streaming.generation);   // Start publishing batches
+    return true;
+}
+
+// True while a streaming load is running
+bool isStreamingLoadActive() {
+    return streaming.active;
+}
+
+// Fraction of the source parsed so far
+float streamingLoadProgress() {
+    size_t total = streaming.source.size();
+    return total ? (float)streaming.bytesParsed / (float)total : 1.0f;
+}
+
+// Stop the background load, keeping what has arrived
+void cancelStreamingLoad() {
+    if (!streaming.active) return;                                                       // Nothing running
+    streaming.cancel = true;                                                             // Worker stops after its current batch
+    streaming.worker.join();
+    streaming.worker = std::thread();                                                    // Joined; finish must not join again
+
+    std::deque<ObjChunk> batch;
+    {
+        std::lock_guard<std::mutex> lock(streaming.mutex);
+        batch.swap(streaming.readyChunks);
+    }
+    for (const ObjChunk& chunk : batch) {
+        appendOBJChunk(chunk, vertices, textureCoords, normals, faces, streaming.records); // Keep everything already parsed
+    }
+    streaming.source.close();
+    streaming.active = false;
+    computeModelBounds();
+    loadOBJMaterials(streaming.filename.c_str(), streaming.records, materials, materialRuns, materialLibraryPaths);
+    loadOBJSubmeshes(streaming.records, faces.size(), submeshes, submeshRuns);
+    weldModel();                                                                         // Draw the partial model indexed
+    printf("Streaming load cancelled: %s\n", streaming.filename.c_str());
+}
+
+// Toggle streaming load mode
+void toggleStreamingLoad() {
+    streamingLoadEnabled = !streamingLoadEnabled;                                        // Invert streaming flag
+    printf("Streaming load %s\n", streamingLoadEnabled ? "enabled" : "disabled");
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+// Progressive model loading. The OBJ file is parsed on a background thread in growing,
+// newline-aligned slices; parsed slices are published to the model containers in batches from
+// a GLUT timer, so display() draws whatever has arrived while the rest is still loading.
+
+extern bool streamingLoadEnabled;                                                        // Load OBJ models progressively (toggled from the menu)
+
+bool startStreamingLoad(const char* filename);                                           // Start a background load of an OBJ file
+bool isStreamingLoadActive();                                                            // True while a streaming load is running
+float streamingLoadProgress();                                                           // Fraction of the source parsed so far (0..1)
+void cancelStreamingLoad();                                                              // Stop the background load, keeping what has arrived
+void toggleStreamingLoad();                                                              // Toggle streaming load mode
\ No newline at end of file
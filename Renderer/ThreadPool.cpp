@@ -0,0 +1,82 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threadCount)
+    : currentTask(nullptr), currentTaskCount(0), nextTask(0), busyWorkers(0), generation(0), stopping(false) {
+    if (threadCount == 0) {                                                              // Default to one thread per core
+        threadCount = std::max(1u, std::thread::hardware_concurrency());                 // hardware_concurrency may report 0
+    }
+    for (unsigned i = 1; i < threadCount; i++) {                                         // Caller acts as the first thread
+        workers.emplace_back(&ThreadPool::workerLoop, this);                             // Start worker
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);                                    // Publish shutdown under the lock
+        stopping = true;                                                                 // Ask workers to exit
+    }
+    wakeCondition.notify_all();                                                          // Wake all workers
+    for (std::thread& worker : workers) {
+        worker.join();                                                                   // Wait for worker to exit
+    }
+}
+
+// Claim and run tasks until none are left
+void ThreadPool::runTasks() {
+    for (size_t i = nextTask.fetch_add(1); i < currentTaskCount; i = nextTask.fetch_add(1)) {
+        (*currentTask)(i);                                                               // Run claimed task
+    }
+}
+
+// Body of each worker thread: wait for a job, help run it, report completion
+void ThreadPool::workerLoop() {
+    unsigned seenGeneration = 0;                                                         // Last job this worker took part in
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;                                                        // Pool is shutting down
+            seenGeneration = generation;                                                 // Accept the new job
+        }
+
+        runTasks();                                                                      // Help with the job
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (--busyWorkers == 0) {                                                        // Last worker out
+            doneCondition.notify_one();                                                  // Let the caller return
+        }
+    }
+}
+
+// Run task(i) for every i in [0, taskCount) and wait for all of them to finish
+void ThreadPool::parallelFor(size_t taskCount, const std::function<void(size_t)>& task) {
+    if (taskCount == 0) return;                                                          // Nothing to do
+    if (workers.empty() || taskCount == 1) {                                             // No parallelism available or needed
+        for (size_t i = 0; i < taskCount; i++) task(i);                                  // Run inline
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(dispatchMutex);                             // One job at a time
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        currentTask = &task;                                                             // Publish job
+        currentTaskCount = taskCount;
+        nextTask = 0;
+        busyWorkers = workers.size();                                                    // Every worker joins each job
+        generation++;                                                                    // Mark job as new
+    }
+    wakeCondition.notify_all();                                                          // Wake workers
+
+    runTasks();                                                                          // Caller works too
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    doneCondition.wait(lock, [&] { return busyWorkers == 0; });                          // Wait until every worker is idle again
+    currentTask = nullptr;                                                               // Job finished
+}
+
+// Pool shared by the loaders, sized to the number of hardware threads
+ThreadPool& sharedThreadPool() {
+    static ThreadPool pool;                                                              // Created on first use
+    return pool;
+}
\ No newline at end of file
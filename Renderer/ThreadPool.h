@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+// Fixed-size pool of worker threads that runs indexed tasks in parallel
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount = 0);                                       // Total threads including the caller (0 = one per core)
+    ~ThreadPool();
+
+    unsigned threadCount() const { return (unsigned)workers.size() + 1; }                // Number of threads that execute tasks
+
+    // Run task(i) for every i in [0, taskCount) and wait for all of them to finish.
+    // The calling thread takes part in the work. Calls are serialized; tasks must not call parallelFor.
+    void parallelFor(size_t taskCount, const std::function<void(size_t)>& task);
+
+private:
+    ThreadPool(const ThreadPool&) = delete;                                              // Pools are not copyable
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void workerLoop();                                                                   // Body of each worker thread
+    void runTasks();                                                                     // Claim and run tasks until none are left
+
+    std::vector<std::thread> workers;                                                    // Worker threads (caller is the extra thread)
+    std::mutex dispatchMutex;                                                            // Serializes parallelFor callers
+    std::mutex stateMutex;                                                               // Guards the job state below
+    std::condition_variable wakeCondition;                                               // Signals workers that a job is ready
+    std::condition_variable doneCondition;                                               // Signals the caller that workers are idle
+    const std::function<void(size_t)>* currentTask;                                      // Task of the running job
+    size_t currentTaskCount;                                                             // Number of task indices in the running job
+    std::atomic<size_t> nextTask;                                                        // Next unclaimed task index
+    size_t busyWorkers;                                                                  // Workers still inside the running job
+    unsigned generation;                                                                 // Incremented for every job
+    bool stopping;                                                                       // Set when the pool shuts down
+};
+
+// Pool shared by the loaders, sized to the number of hardware threads
+ThreadPool& sharedThreadPool();
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "TriangleOrder.h"
+#include "ThreadPool.h"
+#include <string.h>
+#include <algorithm>
+
+// Count the misses of a FIFO cache: a vertex stays cached until vertexCacheSize later misses push it out
+VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    VertexCacheStats stats = { 0.0, 0.0 };
+    if (indexCount < 3) return stats;
+    std::vector<size_t> cachedAt(vertexCount, 0);                                        // Miss that last loaded each vertex (0 = never)
+    size_t misses = 0, referencedVertices = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t vertex = indices[i];
+        if (cachedAt[vertex] == 0) referencedVertices++;
+        if (cachedAt[vertex] == 0 || misses - cachedAt[vertex] >= (size_t)vertexCacheSize) {
+            cachedAt[vertex] = ++misses;                                                 // Transformed again
+        }
+    }
+    stats.acmr = (double)misses / (indexCount / 3);
+    stats.atvr = (double)misses / referencedVertices;
+    return stats;
+}
+
+// Tipsify (Sander, Nehab and Barczak 2007) over triangles whose vertices are numbered [0, vertexCount).
+// Emits every triangle around one vertex, then fans around the emitted vertex that will still be cached
+// after its own fan, falling back to the most recently emitted vertex with triangles left.
+static void tipsify(const uint32_t* indices, size_t triangleCount, size_t vertexCount, uint32_t* outIndices) {
+    std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);                             // Row start of each vertex
+    for (size_t i = 0; i < triangleCount * 3; i++) firstTriangle[indices[i] + 1]++;
+    for (size_t v = 0; v < vertexCount; v++) firstTriangle[v + 1] += firstTriangle[v];
+    std::vector<uint32_t> vertexTriangles(triangleCount * 3);                            // Triangle of every corner, grouped by vertex
+    std::vector<uint32_t> liveTriangles(vertexCount);                                    // Triangles of each vertex not emitted yet
+    for (size_t v = 0; v < vertexCount; v++) liveTriangles[v] = firstTriangle[v + 1] - firstTriangle[v];
+    {
+        std::vector<uint32_t> writePosition(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) vertexTriangles[writePosition[indices[i]]++] = (uint32_t)(i / 3);
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);                                     // Time each vertex entered the cache
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd;                                                       // Emitted vertices, most recent last
+    std::vector<uint32_t> candidates;                                                    // Vertices of the current fan
+    uint32_t time = vertexCacheSize + 1;                                                 // Nothing is cached at the start
+    size_t cursor = 0;                                                                   // Next vertex to try when no fan is left
+    size_t output = 0;
+    int64_t fan = vertexCount > 0 ? 0 : -1;
+    while (fan >= 0) {
+        candidates.clear();
+        for (uint32_t i = firstTriangle[fan]; i < firstTriangle[fan + 1]; i++) {
+            uint32_t t = vertexTriangles[i];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t vertex = indices[t * 3 + corner];
+                outIndices[output++] = vertex;
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (time - cacheTime[vertex] > (uint32_t)vertexCacheSize) cacheTime[vertex] = time++;
+            }
+        }
+
+        // Next fan: the oldest candidate that survives its own fan, else any candidate with triangles left
+        fan = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates) {
+            if (liveTriangles[vertex] == 0) continue;
+            int64_t priority = 0;
+            if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= (uint32_t)vertexCacheSize) priority = time - cacheTime[vertex];
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                fan = vertex;
+            }
+        }
+        while (fan < 0 && !deadEnd.empty()) {                                            // Dead end: back up through recent vertices
+            uint32_t vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[vertex] > 0) fan = vertex;
+        }
+        while (fan < 0 && cursor < vertexCount) {                                        // Start over at the next unfinished vertex
+            if (liveTriangles[cursor] > 0) fan = (int64_t)cursor;
+            cursor++;
+        }
+    }
+}
+
+// Sort the meshlets of every batch by overdraw order, then copy each meshlet's triangles in Tipsify order
+void optimizeTriangleOrder(std::vector<uint32_t>& indices, const std::vector<MeshBatch>& batches, ThreadPool& pool,
+    std::vector<Meshlet>& meshlets) {
+    if (meshlets.empty()) return;
+
+    // Overdraw order: clusters on the outside of the batch, facing away from its center, are drawn first,
+    // so they fill the depth buffer before the clusters they can hide
+    const std::vector<Meshlet> sourceMeshlets(meshlets);                                 // Meshlets before sorting
+    std::vector<uint32_t> sourceFirstIndex(meshlets.size());                             // Source range of each sorted meshlet
+    pool.parallelFor(batches.size(), [&](size_t b) {
+        const MeshBatch& batch = batches[b];
+        if (batch.meshletCount == 0) return;
+        double centroid[3] = { 0.0, 0.0, 0.0 }, weight = 0.0;                            // Meshlet centers weighted by triangles
+        for (uint32_t m = batch.firstMeshlet; m < batch.firstMeshlet + batch.meshletCount; m++) {
+            for (int k = 0; k < 3; k++) centroid[k] += sourceMeshlets[m].center[k] * sourceMeshlets[m].indexCount;
+            weight += sourceMeshlets[m].indexCount;
+        }
+        for (int k = 0; k < 3; k++) centroid[k] /= weight;
+        std::vector<float> keys(batch.meshletCount);                                     // Larger is drawn earlier
+        std::vector<uint32_t> order(batch.meshletCount);
+        for (uint32_t i = 0; i < batch.meshletCount; i++) {
+            const Meshlet& meshlet = sourceMeshlets[batch.firstMeshlet + i];
+            keys[i] = 0.0f;
+            for (int k = 0; k < 3; k++) keys[i] += (float)(meshlet.center[k] - centroid[k]) * meshlet.coneAxis[k];
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t c) { return keys[a] > keys[c]; });
+        uint32_t firstIndex = batch.firstIndex;
+        for (uint32_t i = 0; i < batch.meshletCount; i++) {
+            Meshlet& meshlet = meshlets[batch.firstMeshlet + i];
+            meshlet = sourceMeshlets[batch.firstMeshlet + order[i]];
+            sourceFirstIndex[batch.firstMeshlet + i] = meshlet.firstIndex;
+            meshlet.firstIndex = firstIndex;
+            firstIndex += meshlet.indexCount;
+        }
+    });
+
+    // Vertex cache order inside every meshlet, on vertices numbered locally so the scratch stays small
+    std::vector<uint32_t> ordered(indices);                                              // Ranges outside the meshlets stay as they are
+    pool.parallelFor(meshlets.size(), [&](size_t m) {
+        const Meshlet& meshlet = meshlets[m];
+        const uint32_t* source = &indices[sourceFirstIndex[m]];
+        std::vector<uint32_t> localVertices(source, source + meshlet.indexCount);        // Distinct vertices, sorted
+        std::sort(localVertices.begin(), localVertices.end());
+        localVertices.erase(std::unique(localVertices.begin(), localVertices.end()), localVertices.end());
+        std::vector<uint32_t> localIndices(meshlet.indexCount);
+        for (uint32_t i = 0; i < meshlet.indexCount; i++) {
+            localIndices[i] = (uint32_t)(std::lower_bound(localVertices.begin(), localVertices.end(), source[i]) - localVertices.begin());
+        }
+        std::vector<uint32_t> localOrdered(meshlet.indexCount);
+        tipsify(localIndices.data(), meshlet.indexCount / 3, localVertices.size(), localOrdered.data());
+        for (uint32_t i = 0; i < meshlet.indexCount; i++) ordered[meshlet.firstIndex + i] = localVertices[localOrdered[i]];
+    });
+    indices.swap(ordered);
+}
+
+// Number vertices by first use and rewrite the indices through the new numbering
+void optimizeVertexFetch(std::vector<MeshVertex>& meshVertices, std::vector<uint32_t>& indices) {
+    std::vector<uint32_t> remap(meshVertices.size(), UINT32_MAX);                        // New number of each old vertex
+    std::vector<MeshVertex> ordered;
+    ordered.reserve(meshVertices.size());
+    for (uint32_t& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = (uint32_t)ordered.size();
+            ordered.push_back(meshVertices[index]);
+        }
+        index = remap[index];
+    }
+    meshVertices.swap(ordered);
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include "ModelLoader.h"
+
+class ThreadPool;
+
+// Post-transform cache behaviour of a triangle list, simulated as a FIFO of vertexCacheSize entries
+struct VertexCacheStats {
+    double acmr;                                                                         // Average cache misses per triangle (0.5 is ideal)
+    double atvr;                                                                         // Average transforms per referenced vertex (1.0 is ideal)
+};
+
+// Simulate the vertex cache over indices[0, indexCount), which reference vertices [0, vertexCount)
+VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// Reorder the full-detail triangles for overdraw and then for the vertex cache, keeping every meshlet a
+// contiguous range of its batch. The meshlets act as the clusters of Sander et al.: inside each batch they
+// are sorted so the ones facing away from the batch center (the outside of the shape) come first, then
+// the triangles of every meshlet are put in Tipsify order. Batch ranges and meshlet bounds are unchanged.
+void optimizeTriangleOrder(std::vector<uint32_t>& indices, const std::vector<MeshBatch>& batches, ThreadPool& pool,
+    std::vector<Meshlet>& meshlets);
+
+// Renumber the vertices in the order the indices first use them, so vertex fetches walk memory forwards.
+// Vertices no index references are dropped.
+void optimizeVertexFetch(std::vector<MeshVertex>& meshVertices, std::vector<uint32_t>& indices);
+
+const int vertexCacheSize = 16;                                                          // Entries of the simulated and targeted cache
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "UniformLighting.h"
+#include "GLExtensions.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+// White directional light from the upper right front
+const LightSource sceneLight = {
+    { 1.0f, 1.0f, 1.0f, 0.0f },                                                          // Direction towards the light
+    { 0.2f, 0.2f, 0.2f, 1.0f },                                                          // Dim white ambient
+    { 0.8f, 0.8f, 0.8f, 1.0f },                                                          // Bright white diffuse
+    { 1.0f, 1.0f, 1.0f, 1.0f }                                                           // Pure white specular
+};
+
+// Material as laid out (std140) in the Materials uniform block
+struct ShaderMaterial {
+    float ambient[4];                                                                    // Ambient color
+    float diffuse[4];                                                                    // Diffuse color; alpha is the opacity
+    float specular[3];                                                                   // Specular color
+    float shininess;                                                                     // Specular exponent
+};
+
+// Contents of the Lights uniform block
+struct LightBlock {
+    float sceneAmbient[4];                                                               // Light model ambient
+    int32_t lightCount;                                                                  // Lights in use
+    int32_t padding[3];                                                                  // std140 aligns the array to 16 bytes
+    LightSource lights[maxShaderLights];
+};
+
+static const GLuint lightsBinding = 0;                                                   // Uniform buffer binding point of the Lights block
+static const GLuint materialsBinding = 1;                                                // Uniform buffer binding point of the Materials block
+static const ptrdiff_t materialGroupBytes = materialsPerBlock * sizeof(ShaderMaterial);  // A multiple of 4096, so every group is aligned
+
+// Uniform buffers and what they hold
+static GLuint lightsBuffer = 0;                                                          // One LightBlock
+static GLuint materialsBuffer = 0;                                                       // Every material, padded to whole groups
+static LightBlock uploadedLights = {};                                                   // Contents of lightsBuffer
+static uint32_t uploadedVersion = 0;                                                     // modelVersion of materialsBuffer
+static int32_t boundGroup = -1;                                                          // Group of materials bound to materialsBinding
+
+static const char* const uniformLightingFragmentBody = R"(
+struct Light {
+    vec4 position;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+};
+struct Material {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specularShininess;
+};
+layout(std140) uniform Lights {
+    vec4 sceneAmbient;
+    int lightCount;
+    Light lights[MAX_LIGHTS];
+};
+layout(std140) uniform Materials {
+    Material materials[MATERIALS_PER_BLOCK];
+};
+#ifdef PER_DRAW_MATERIAL
+varying float drawMaterial;
+#else
+uniform int materialIndex;
+#endif
+varying vec3 viewPosition;
+varying vec3 viewNormal;
+void main() {
+#ifdef PER_DRAW_MATERIAL
+    Material material = materials[int(drawMaterial + 0.5)];
+#else
+    Material material = materials[materialIndex];
+#endif
+    vec3 n = normalize(viewNormal);
+    vec4 color = sceneAmbient * material.ambient;
+    for (int i = 0; i < lightCount; i++) {
+        vec3 l = normalize(lights[i].position.xyz - viewPosition * lights[i].position.w);
+        float diffuse = max(dot(n, l), 0.0);
+        float specular = diffuse > 0.0 ? pow(max(dot(n, normalize(l + vec3(0.0, 0.0, 1.0))), 0.0), material.specularShininess.w) : 0.0;
+        color += lights[i].ambient * material.ambient + lights[i].diffuse * material.diffuse * diffuse +
+            lights[i].specular * vec4(material.specularShininess.rgb, 1.0) * specular;
+    }
+    gl_FragColor = vec4(color.rgb, material.diffuse.a);
+}
+)";
+
+// The array sizes come from the C++ constants so both sides agree on the block layouts
+std::string uniformLightingFragmentShader(bool perDrawMaterial) {
+    return "#version 120\n#extension GL_ARB_uniform_buffer_object : require\n#define MAX_LIGHTS " +
+        std::to_string(maxShaderLights) + "\n#define MATERIALS_PER_BLOCK " + std::to_string(materialsPerBlock) +
+        (perDrawMaterial ? "\n#define PER_DRAW_MATERIAL\n" : "\n") + uniformLightingFragmentBody;
+}
+
+// Blocks are matched by name, so every program built from the shader can share the buffers
+bool bindLightingBlocks(unsigned program) {
+    GLuint lightsIndex = glGetUniformBlockIndex(program, "Lights");
+    GLuint materialsIndex = glGetUniformBlockIndex(program, "Materials");
+    if (lightsIndex == GL_INVALID_INDEX || materialsIndex == GL_INVALID_INDEX) {
+        printf("Lighting program lacks its uniform blocks\n");
+        return false;
+    }
+    glUniformBlockBinding(program, lightsIndex, lightsBinding);
+    glUniformBlockBinding(program, materialsIndex, materialsBinding);
+    return true;
+}
+
+// The materials only change with the model; the light block is compared with the last upload so a
+// frame with unchanged lights writes nothing
+void updateLightingBuffers() {
+    if (!lightsBuffer) {
+        glGenBuffers(1, &lightsBuffer);
+        glGenBuffers(1, &materialsBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, lightsBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlock), nullptr, GL_DYNAMIC_DRAW);
+        memset(&uploadedLights, 0xFF, sizeof(uploadedLights));                           // Differs from any real block
+        uploadedVersion = modelVersion - 1;
+    }
+
+    LightBlock lightBlock = {};
+    const float lightModelAmbient[4] = { 0.2f, 0.2f, 0.2f, 1.0f };                       // GL_LIGHT_MODEL_AMBIENT default, which setupLighting keeps
+    memcpy(lightBlock.sceneAmbient, lightModelAmbient, sizeof(lightModelAmbient));
+    lightBlock.lightCount = 1;
+    lightBlock.lights[0] = sceneLight;
+    if (memcmp(&lightBlock, &uploadedLights, sizeof(LightBlock)) != 0) {
+        glBindBuffer(GL_UNIFORM_BUFFER, lightsBuffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightBlock), &lightBlock);          // All lights in one write
+        uploadedLights = lightBlock;
+    }
+
+    if (uploadedVersion != modelVersion) {
+        size_t groups = (materials.size() + materialsPerBlock - 1) / materialsPerBlock;
+        std::vector<ShaderMaterial> shaderMaterials(std::max<size_t>(groups, 1) * materialsPerBlock, ShaderMaterial{});
+        for (size_t i = 0; i < materials.size(); i++) {
+            const Material& material = materials[i];
+            ShaderMaterial& shaderMaterial = shaderMaterials[i];
+            memcpy(shaderMaterial.ambient, material.ambient, sizeof(shaderMaterial.ambient));
+            memcpy(shaderMaterial.diffuse, material.diffuse, sizeof(shaderMaterial.diffuse));
+            memcpy(shaderMaterial.specular, material.specular, sizeof(shaderMaterial.specular));
+            shaderMaterial.shininess = material.shininess;
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, materialsBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, (ptrdiff_t)(shaderMaterials.size() * sizeof(ShaderMaterial)), shaderMaterials.data(),
+            GL_STATIC_DRAW);
+        uploadedVersion = modelVersion;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, lightsBinding, lightsBuffer);
+    glBindBufferRange(GL_UNIFORM_BUFFER, materialsBinding, materialsBuffer, 0, materialGroupBytes);
+    boundGroup = 0;
+}
+
+// Batches arrive sorted by material, so a model with more than materialsPerBlock materials rebinds
+// the range once per group rather than per draw
+void selectLightingMaterialGroup(int32_t group) {
+    if (group == boundGroup) return;
+    glBindBufferRange(GL_UNIFORM_BUFFER, materialsBinding, materialsBuffer, group * materialGroupBytes, materialGroupBytes);
+    boundGroup = group;
+}
+
+void selectLightingMaterial(int materialIndexLocation, int32_t material) {
+    selectLightingMaterialGroup(material / materialsPerBlock);
+    glUniform1i(materialIndexLocation, material % materialsPerBlock);
+}
+
+// Delete the uniform buffers; the next update creates and fills them again
+void releaseLightingBuffers() {
+    if (lightsBuffer) {
+        glDeleteBuffers(1, &lightsBuffer);
+        glDeleteBuffers(1, &materialsBuffer);
+    }
+    lightsBuffer = 0;
+    materialsBuffer = 0;
+    boundGroup = -1;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include "ModelLoader.h"
+#include <string>
+
+// Light as laid out (std140) in the Lights uniform block
+struct LightSource {
+    float position[4];                                                                   // Eye space; w = 0 makes it a direction
+    float ambient[4];                                                                    // Ambient color
+    float diffuse[4];                                                                    // Diffuse color
+    float specular[4];                                                                   // Specular color
+};
+
+// The directional light of the scene. setupLighting loads it into GL_LIGHT0 under the identity
+// modelview, so its position is in eye space for both pipelines.
+extern const LightSource sceneLight;
+
+const int maxShaderLights = 4;                                                           // Size of the light array in the Lights block
+const int materialsPerBlock = 256;                                                       // Materials one binding of the Materials block covers (12 KB)
+
+// Fragment shader of the uniform-buffer pipeline (GLSL 120 with ARB_uniform_buffer_object): per-pixel
+// version of the fixed-function lighting for every light of the Lights block, shading with the material
+// the materialIndex uniform selects from the Materials block. Pairs with the mesh vertex shader; with
+// perDrawMaterial the index instead arrives from the vertex shader's per-draw material attribute.
+std::string uniformLightingFragmentShader(bool perDrawMaterial);
+
+// Connect the Lights and Materials blocks of a program to their binding points; false if it lacks either
+bool bindLightingBlocks(unsigned program);
+
+// Upload the materials after the model changed and the lights when they differ from the last upload,
+// each in one write, then bind both buffers. Call before drawing with the program.
+void updateLightingBuffers();
+
+// Bind materials [group * materialsPerBlock, (group + 1) * materialsPerBlock) to the Materials block
+void selectLightingMaterialGroup(int32_t group);
+
+// Shade with a material: one uniform write, plus a range rebind when the material lies in another
+// group than the previous one
+void selectLightingMaterial(int materialIndexLocation, int32_t material);
+
+void releaseLightingBuffers();                                                           // Delete the uniform buffers
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "VertexAnimation.h"
+#include "StreamBuffer.h"
+#include "ModelLoader.h"
+#include "RenderBackend.h"
+#include "Instancing.h"
+#include "ThreadPool.h"
+#include "GLExtensions.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+bool vertexAnimationEnabled = false;                                                     // Deform and stream the mesh every frame
+
+static StreamedVertices frameVertices = {};                                              // Vertices streamed for the current frame
+static bool frameStreamed = false;                                                       // frameVertices is valid until finishAnimatedFrame
+static const auto animationStart = std::chrono::steady_clock::now();                     // Time origin of the wave
+
+// Toggle the animation; drawModel only streams for the backends that read buffer objects. Turning it off
+// frees the stream buffer.
+void toggleVertexAnimation() {
+    vertexAnimationEnabled = !vertexAnimationEnabled;
+    if (!vertexAnimationEnabled) releaseStreamBuffer();
+    printf("Vertex animation: %s", vertexAnimationEnabled ? "on" : "off");
+    if (vertexAnimationEnabled && currentRenderBackend() < RENDER_BACKEND_BUFFERS) {
+        printf(" (drawn by the buffer object and shader backends only)");
+    }
+    printf("\n");
+}
+
+// Instancing draws the static buffers, and the client-memory backends have nothing to stream into
+bool vertexAnimationActive() {
+    return vertexAnimationEnabled && currentRenderBackend() >= RENDER_BACKEND_BUFFERS && instances.empty() &&
+        !meshVertices.empty() && glHasBufferObjects;
+}
+
+// Each worker deforms a block of vertices straight into the stream buffer (write-combined memory when
+// it is mapped, so whole vertices are written in order and nothing is read back)
+void streamAnimatedVertices() {
+    frameStreamed = false;
+    if (!vertexAnimationActive()) return;
+    StreamAllocation allocation;
+    if (!beginStreamWrite(meshVertices.size() * sizeof(MeshVertex), allocation)) return;
+
+    float diagonal = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        float size = modelBounds.max[axis] - modelBounds.min[axis];
+        diagonal += size * size;
+    }
+    diagonal = sqrtf(diagonal);
+    const float amplitude = vertexWaveAmplitude * diagonal;
+    const float waveNumber = diagonal > 0.0f ? 6.2831853f * 3.0f / diagonal : 0.0f;      // Three crests across the model
+    const float phase = std::chrono::duration<float>(std::chrono::steady_clock::now() - animationStart).count() * 4.0f;
+
+    const size_t blockSize = 16384;                                                      // Vertices per task
+    const size_t blockCount = (meshVertices.size() + blockSize - 1) / blockSize;
+    MeshVertex* target = (MeshVertex*)allocation.data;
+    sharedThreadPool().parallelFor(blockCount, [&](size_t block) {
+        size_t end = std::min(meshVertices.size(), (block + 1) * blockSize);
+        for (size_t i = block * blockSize; i < end; i++) {
+            MeshVertex vertex = meshVertices[i];
+            const float* p = vertex.position;
+            float offset = amplitude * sinf(waveNumber * (p[0] + 0.5f * p[1] + 0.25f * p[2]) - phase);
+            for (int axis = 0; axis < 3; axis++) vertex.position[axis] += offset * vertex.normal[axis];
+            target[i] = vertex;
+        }
+    });
+
+    endStreamWrite(allocation);
+    frameVertices = { allocation.buffer, allocation.offset };
+    frameStreamed = true;
+}
+
+const StreamedVertices* streamedVertices() {
+    return frameStreamed ? &frameVertices : nullptr;
+}
+
+// Both passes of the depth pre-pass read the same vertices, so the fence follows the last of them
+void finishAnimatedFrame() {
+    if (!frameStreamed) return;
+    fenceStreamWrite();
+    frameStreamed = false;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+#include <stddef.h>
+
+// CPU-deformed copy of the welded mesh, rebuilt every frame and streamed to the GPU through the stream
+// buffer, standing in for skinned or simulated geometry. A travelling wave pushes every vertex along its
+// normal by up to vertexWaveAmplitude of the model's diagonal; normals, bounds and meshlet cones keep
+// their rest values, which the small amplitude makes invisible to culling and lighting.
+
+const float vertexWaveAmplitude = 0.01f;                                                 // Largest displacement as a fraction of the model diagonal
+
+// Where the draws of the current frame find the deformed vertices (MeshVertex layout)
+struct StreamedVertices {
+    unsigned buffer;                                                                     // Buffer object holding them
+    size_t offset;                                                                       // Byte offset of vertex 0
+};
+
+extern bool vertexAnimationEnabled;                                                      // Deform and stream the mesh every frame (toggled from the menu)
+void toggleVertexAnimation();                                                            // Toggle the animation
+bool vertexAnimationActive();                                                            // Enabled, and the selected backend draws from buffer objects
+
+void streamAnimatedVertices();                                                           // Deform this frame's vertices into the stream buffer
+const StreamedVertices* streamedVertices();                                              // This frame's vertices, or null when not animating
+void finishAnimatedFrame();                                                              // Fence the vertices after the frame's last draw
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "VertexQuantization.h"
+#include "GLExtensions.h"
+#include "RenderBackend.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+
+bool quantizedVerticesEnabled = false;                                                   // Shader paths draw quantized vertices
+
+// Float to half with round-to-nearest-even; values beyond the half range clamp to the largest half
+static uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;                        // Rebiased exponent
+    if (((bits >> 23) & 0xFF) == 0xFF) return (uint16_t)(sign | (mantissa ? 0x7E00u : 0x7BFFu)); // NaN stays NaN, infinity clamps
+    if (exponent >= 31) return (uint16_t)(sign | 0x7BFFu);
+    uint32_t half, rest, halfway;
+    if (exponent <= 0) {                                                                 // Subnormal half (or zero)
+        if (exponent < -10) return (uint16_t)sign;
+        mantissa |= 0x800000u;                                                           // Implicit leading one
+        uint32_t shift = (uint32_t)(14 - exponent);
+        half = mantissa >> shift;
+        rest = mantissa & ((1u << shift) - 1);
+        halfway = 1u << (shift - 1);
+    }
+    else {
+        half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+        rest = mantissa & 0x1FFFu;
+        halfway = 0x1000u;
+    }
+    if (rest > halfway || (rest == halfway && (half & 1))) half++;                       // A carry rounds into the exponent
+    return (uint16_t)(sign | std::min(half, 0x7BFFu));
+}
+
+static float halfToFloat(uint16_t half) {
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FFu;
+    float value = exponent == 0 ? ldexpf((float)mantissa, -24) : ldexpf((float)(mantissa | 0x400u), (int)exponent - 25);
+    return (half & 0x8000u) ? -value : value;
+}
+
+// Octahedral encoding: project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the
+// diagonals, so two values cover the sphere with nearly uniform precision
+static void encodeOctahedral(const float normal[3], int16_t encoded[2]) {
+    float length = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+    float u = length > 0.0f ? normal[0] / length : 0.0f;
+    float v = length > 0.0f ? normal[1] / length : 0.0f;
+    if (normal[2] < 0.0f) {
+        float foldedU = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float foldedV = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
+    encoded[0] = (int16_t)lrintf(std::min(1.0f, std::max(-1.0f, u)) * 32767.0f);
+    encoded[1] = (int16_t)lrintf(std::min(1.0f, std::max(-1.0f, v)) * 32767.0f);
+}
+
+// Same decode as decodeNormal in the shader header
+static void decodeOctahedral(const int16_t encoded[2], float normal[3]) {
+    float u = std::max(-1.0f, encoded[0] / 32767.0f);
+    float v = std::max(-1.0f, encoded[1] / 32767.0f);
+    normal[0] = u;
+    normal[1] = v;
+    normal[2] = 1.0f - fabsf(u) - fabsf(v);
+    if (normal[2] < 0.0f) {
+        normal[0] = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        normal[1] = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    }
+    float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    for (int k = 0; k < 3; k++) normal[k] /= length;
+}
+
+// Quantize against the bounds of the welded vertices, decoding each vertex again to find the error
+void quantizeVertices(const std::vector<MeshVertex>& meshVertices, std::vector<QuantizedVertex>& outVertices,
+    PositionDecode& outDecode, QuantizationError& outError) {
+    Bounds bounds = { {FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX} };     // Start inverted
+    for (const MeshVertex& vertex : meshVertices) {
+        for (int axis = 0; axis < 3; axis++) {
+            bounds.min[axis] = std::min(bounds.min[axis], vertex.position[axis]);
+            bounds.max[axis] = std::max(bounds.max[axis], vertex.position[axis]);
+        }
+    }
+    if (meshVertices.empty()) bounds = { {0, 0, 0}, {0, 0, 0} };
+    float diagonal = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        outDecode.offset[axis] = bounds.min[axis];
+        outDecode.scale[axis] = bounds.max[axis] - bounds.min[axis];
+        diagonal += outDecode.scale[axis] * outDecode.scale[axis];
+    }
+    diagonal = sqrtf(diagonal);
+
+    outVertices.resize(meshVertices.size());
+    outError = {};
+    for (size_t i = 0; i < meshVertices.size(); i++) {
+        const MeshVertex& vertex = meshVertices[i];
+        QuantizedVertex& packed = outVertices[i];
+        float positionError = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            float scale = outDecode.scale[axis];
+            float fraction = scale > 0.0f ? (vertex.position[axis] - outDecode.offset[axis]) / scale : 0.0f;
+            packed.position[axis] = (uint16_t)lrintf(std::min(1.0f, std::max(0.0f, fraction)) * 65535.0f);
+            float decoded = outDecode.offset[axis] + scale * (packed.position[axis] / 65535.0f);
+            positionError += (decoded - vertex.position[axis]) * (decoded - vertex.position[axis]);
+        }
+        packed.position[3] = 0;
+        outError.position = std::max(outError.position, sqrtf(positionError));
+
+        encodeOctahedral(vertex.normal, packed.normal);
+        float normalLength = sqrtf(vertex.normal[0] * vertex.normal[0] + vertex.normal[1] * vertex.normal[1] +
+            vertex.normal[2] * vertex.normal[2]);
+        if (normalLength > 0.0f) {                                                       // Missing normals have no direction to lose
+            float decoded[3];
+            decodeOctahedral(packed.normal, decoded);
+            const float* n = vertex.normal;                                              // atan2 stays exact for tiny angles, acos does not
+            double cross[3] = { (double)decoded[1] * n[2] - (double)decoded[2] * n[1], (double)decoded[2] * n[0] - (double)decoded[0] * n[2],
+                (double)decoded[0] * n[1] - (double)decoded[1] * n[0] };
+            double dot = (double)decoded[0] * n[0] + (double)decoded[1] * n[1] + (double)decoded[2] * n[2];
+            double angle = atan2(sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot);
+            outError.normalDegrees = std::max(outError.normalDegrees, (float)(angle * 57.29577951308232));
+        }
+
+        for (int k = 0; k < 2; k++) {
+            packed.texCoord[k] = floatToHalf(vertex.texCoord[k]);
+            outError.texCoord = std::max(outError.texCoord, fabsf(halfToFloat(packed.texCoord[k]) - vertex.texCoord[k]));
+        }
+    }
+    outError.positionRelative = diagonal > 0.0f ? outError.position / diagonal : 0.0f;
+}
+
+// Shared by the mesh and instanced vertex shaders. The branch on octahedralNormals is uniform, so it
+// costs the float path next to nothing.
+const char* const meshVertexShaderHeader = R"(#version 120
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+uniform bool octahedralNormals;
+vec3 decodePosition(vec3 position) {
+    return positionOffset + positionScale * position;
+}
+vec3 decodeNormal(vec3 normal) {
+    if (!octahedralNormals) return normal;
+    vec3 n = vec3(normal.xy, 1.0 - abs(normal.x) - abs(normal.y));
+    if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+)";
+
+// Toggle the quantized format; the next frame uploads the vertex buffer again in the new format
+void toggleQuantizedVertices() {
+    if (!quantizedVerticesSupported()) {
+        printf("Quantized vertices need half-float vertex attributes and the VAO + shader backend\n");
+        quantizedVerticesEnabled = false;
+        return;
+    }
+    quantizedVerticesEnabled = !quantizedVerticesEnabled;
+    printf("Quantized vertices: %s", quantizedVerticesEnabled ? "on" : "off");
+    if (quantizedVerticesEnabled && currentRenderBackend() < RENDER_BACKEND_SHADER) {
+        printf(" (drawn by the shader backends and instancing only)");
+    }
+    printf("\n");
+}
+
+// Half floats and the generic attributes of the shader backend
+bool quantizedVerticesSupported() {
+    return glHasHalfFloatVertices && renderBackend(RENDER_BACKEND_SHADER).isSupported();
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#include "ModelLoader.h"
+
+// Welded vertex in 16 bytes instead of the 32 of MeshVertex. Only the shader paths can draw it: the
+// fixed-function normal array has no octahedral form.
+struct QuantizedVertex {
+    uint16_t position[4];                                                                // x, y, z as fractions of the mesh bounds; w pads to 8 bytes
+    int16_t normal[2];                                                                   // Octahedral unit normal, normalized to [-1, 1]
+    uint16_t texCoord[2];                                                                // Half floats
+};
+
+// Turns the normalized quantized position q back into model space: offset + scale * q
+struct PositionDecode {
+    float offset[3];                                                                     // Minimum corner of the mesh bounds
+    float scale[3];                                                                      // Size of the mesh bounds
+};
+
+// Largest differences between the vertices and their quantized form
+struct QuantizationError {
+    float position;                                                                      // Distance in model units
+    float positionRelative;                                                              // Same, as a fraction of the bounds diagonal
+    float normalDegrees;                                                                 // Angle between the normals
+    float texCoord;                                                                      // Per component
+};
+
+// Quantize every vertex relative to the bounds of meshVertices and measure the error of the result
+void quantizeVertices(const std::vector<MeshVertex>& meshVertices, std::vector<QuantizedVertex>& outVertices,
+    PositionDecode& outDecode, QuantizationError& outError);
+
+// Start of the mesh vertex shaders (GLSL 120): the version line and decodePosition/decodeNormal, which
+// pass float attributes through or decode quantized ones depending on the uniforms set by
+// setMeshDecodeUniforms
+extern const char* const meshVertexShaderHeader;
+
+extern bool quantizedVerticesEnabled;                                                    // Shader paths draw quantized vertices (toggled from the menu)
+void toggleQuantizedVertices();                                                          // Toggle the quantized vertex format
+bool quantizedVerticesSupported();                                                       // Half-float attributes and the shader backend are available
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "Camera.h"
 #include "ModelLoader.h"
 #include "InputHandler.h"
+#include "GLExtensions.h"
+#include "RenderBackend.h"
 
 // Define PI constant if not already defined by the compiler
 #ifndef M_PI
@@ -81,6 +83,10 @@ int main(int argc, char** argv) {
 
 // Initialize OpenGL settings and load default model
 void init() {
+    // Load OpenGL entry points beyond 1.1 and pick the render backend they allow
+    loadGLExtensions();
+    chooseDefaultRenderBackend();
+
     // Set clear color to dark gray
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
 
@@ -104,6 +110,6 @@ void init() {
     // Set up initial projection matrix
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
-    gluPerspective(45.0f, (float)windowWidth / (float)windowHeight, 0.1f, 100.0f);
+    gluPerspective(cameraFieldOfView, (float)windowWidth / (float)windowHeight, cameraNearPlane, cameraFarPlane);
     glMatrixMode(GL_MODELVIEW);
 }
\ No newline at end of file